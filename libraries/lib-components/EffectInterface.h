@@ -218,6 +218,11 @@ public:
    virtual sampleCount GetLatency() = 0;
    virtual size_t GetTailSize() = 0;
 
+   //! Whether destructive computation keeps all its state in this object, so
+   //! that other instances with the same settings may process other tracks
+   //! at the same time, in other threads
+   virtual bool SupportsParallelProcessing() { return false; }
+
    //! Called for destructive, non-realtime effect computation
    virtual bool ProcessInitialize(sampleCount totalLen, ChannelNames chanMap = NULL) = 0;
 
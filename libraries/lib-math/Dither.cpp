@@ -32,10 +32,17 @@ state. Call Dither::Apply() to apply the dither. You can call
 Reset() between subsequent dithers to reset the dither state
 and get deterministic behaviour.
 
+  Conversions, and the rectangle and triangle dithers, are done by the
+  vectorized kernels of SampleConvert, with noise generated in advance in
+  the same sequence as sample by sample, so that the output is unchanged.
+  The feedback of the noise-shaped dither makes it sequential, so it
+  remains a scalar loop.
+
 *//*******************************************************************/
 
 
 #include "Dither.h"
+#include "SampleConvert.h"
 
 #include "Internat.h"
 #include "Prefs.h"
@@ -46,6 +53,7 @@ and get deterministic behaviour.
 #include "float_cast.h"
 
 #include <stdlib.h>
+#include <algorithm>
 #include <cmath>
 #include <string.h>
 #include <cassert>
@@ -204,6 +212,72 @@ const float Dither::SHAPED_BS[] = { 2.033f, -2.165f, 1.959f, -1.590f, 0.6149f };
     else { assert(false); } \
     } while (0)
 
+namespace {
+//! Samples converted at once, through buffers on the stack when strided
+constexpr size_t ChunkSize = 256;
+
+//! Apply a conversion of contiguous samples to strided buffers
+template<typename Src, typename Dst, typename Convert>
+void ConvertChunks(const Src *src, unsigned int srcStride,
+   Dst *dst, unsigned int dstStride, size_t len, const Convert &convert)
+{
+   Src srcBuffer[ChunkSize];
+   Dst dstBuffer[ChunkSize];
+   for (size_t done = 0; done < len;) {
+      const auto n = std::min(ChunkSize, len - done);
+
+      auto s = src + done * srcStride;
+      if (srcStride != 1) {
+         for (size_t ii = 0; ii < n; ++ii)
+            srcBuffer[ii] = s[ii * srcStride];
+         s = srcBuffer;
+      }
+
+      const auto d = (dstStride == 1) ? dst + done : dstBuffer;
+      convert(s, d, n);
+      if (dstStride != 1)
+         for (size_t ii = 0; ii < n; ++ii)
+            dst[(done + ii) * dstStride] = dstBuffer[ii];
+
+      done += n;
+   }
+}
+
+//! Convert to a narrower format, with noise from makeNoise(n, add, sub),
+//! which sets add and sub as for SampleConvert::FloatToInt16()
+template<typename MakeNoise>
+void Quantize(constSamplePtr src, sampleFormat srcFormat,
+   unsigned int srcStride, samplePtr dst, sampleFormat dstFormat,
+   unsigned int dstStride, size_t len, const MakeNoise &makeNoise)
+{
+   if (srcFormat == int24Sample && dstFormat == int16Sample)
+      ConvertChunks(reinterpret_cast<const int*>(src), srcStride,
+         reinterpret_cast<short*>(dst), dstStride, len,
+         [&](const int *s, short *d, size_t n){
+            const float *add{}, *sub{};
+            makeNoise(n, add, sub);
+            SampleConvert::Int24ToInt16(s, d, n, add, sub);
+         });
+   else if (srcFormat == floatSample && dstFormat == int16Sample)
+      ConvertChunks(reinterpret_cast<const float*>(src), srcStride,
+         reinterpret_cast<short*>(dst), dstStride, len,
+         [&](const float *s, short *d, size_t n){
+            const float *add{}, *sub{};
+            makeNoise(n, add, sub);
+            SampleConvert::FloatToInt16(s, d, n, add, sub);
+         });
+   else if (srcFormat == floatSample && dstFormat == int24Sample)
+      ConvertChunks(reinterpret_cast<const float*>(src), srcStride,
+         reinterpret_cast<int*>(dst), dstStride, len,
+         [&](const float *s, int *d, size_t n){
+            const float *add{}, *sub{};
+            makeNoise(n, add, sub);
+            SampleConvert::FloatToInt24(s, d, n, add, sub);
+         });
+   else
+      assert(false);
+}
+}
 
 Dither::Dither()
 {
@@ -300,41 +374,56 @@ void Dither::Apply(enum DitherType ditherType,
         auto d = (float*)dest;
 
         if (sourceFormat == int16Sample)
-        {
-            auto s = (const short*)source;
-            for (i = 0; i < len; i++, d += destStride, s += sourceStride)
-                *d = FROM_INT16(s);
-        } else
+            ConvertChunks((const short*)source, sourceStride, d, destStride,
+                len, SampleConvert::Int16ToFloat);
+        else
         if (sourceFormat == int24Sample)
-        {
-            auto s = (const int*)source;
-            for (i = 0; i < len; i++, d += destStride, s += sourceStride)
-                *d = FROM_INT24(s);
-        } else {
+            ConvertChunks((const int*)source, sourceStride, d, destStride,
+                len, SampleConvert::Int24ToFloat);
+        else {
             assert(false); // source format unknown
         }
     } else
     if (destFormat == int24Sample && sourceFormat == int16Sample)
     {
         // Special case when promoting 16 bit to 24 bit
-        auto d = (int*)dest;
-        auto s = (const short*)source;
-        for (i = 0; i < len; i++, d += destStride, s += sourceStride)
-            *d = ((int)*s) << 8;
+        ConvertChunks((const short*)source, sourceStride,
+            (int*)dest, destStride, len, SampleConvert::Int16ToInt24);
     } else
     {
         // We must do dithering
+        // One more than a chunk, for the triangle dither's previous value
+        float noise[ChunkSize + 1];
         switch (ditherType)
         {
         case DitherType::none:
-            DITHER(NoDither, dest, destFormat, destStride, source, sourceFormat, sourceStride, len);
+            Quantize(source, sourceFormat, sourceStride,
+                dest, destFormat, destStride, len,
+                [](size_t, const float *&, const float *&){});
             break;
         case DitherType::rectangle:
-            DITHER(RectangleDither, dest, destFormat, destStride, source, sourceFormat, sourceStride, len);
+            // Subtract one-step noise
+            Quantize(source, sourceFormat, sourceStride,
+                dest, destFormat, destStride, len,
+                [&](size_t n, const float *&, const float *&sub){
+                    for (size_t ii = 0; ii < n; ++ii)
+                        noise[ii] = DITHER_NOISE;
+                    sub = noise;
+                });
             break;
         case DitherType::triangle:
             Reset(); // reset dither filter for this NEW conversion
-            DITHER(TriangleDither, dest, destFormat, destStride, source, sourceFormat, sourceStride, len);
+            // Add the noise, and subtract that of the previous sample
+            Quantize(source, sourceFormat, sourceStride,
+                dest, destFormat, destStride, len,
+                [&](size_t n, const float *&add, const float *&sub){
+                    noise[0] = mTriangleState;
+                    for (size_t ii = 0; ii < n; ++ii)
+                        noise[ii + 1] = DITHER_NOISE;
+                    mTriangleState = noise[n];
+                    add = noise + 1;
+                    sub = noise;
+                });
             break;
         case DitherType::shaped:
             Reset(); // reset dither filter for this NEW conversion
@@ -348,28 +437,6 @@ void Dither::Apply(enum DitherType ditherType,
 
 // Dither implementations
 
-// No dither, just return sample
-inline float Dither::NoDither(float sample)
-{
-    return sample;
-}
-
-// Rectangle dithering, apply one-step noise
-inline float Dither::RectangleDither(float sample)
-{
-    return sample - DITHER_NOISE;
-}
-
-// Triangle dither - high pass filtered
-inline float Dither::TriangleDither(float sample)
-{
-    float r = DITHER_NOISE;
-    float result = sample + r - mTriangleState;
-    mTriangleState = r;
-
-    return result;
-}
-
 // Shaped dither
 inline float Dither::ShapedDither(float sample)
 {
@@ -46,10 +46,7 @@ public:
                unsigned int destStride = 1);
 
 private:
-    // Dither methods
-    float NoDither(float sample);
-    float RectangleDither(float sample);
-    float TriangleDither(float sample);
+    // Dither methods; the others are done in Apply
     float ShapedDither(float sample);
 
     // Dither constants
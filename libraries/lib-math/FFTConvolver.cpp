@@ -0,0 +1,177 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file FFTConvolver.cpp
+
+*******************************************************************//*!
+
+\class FFTConvolver
+\brief Fast convolution of a stream with a fixed FIR filter
+
+  The spectrum of each block, from RealFFTf, is in bit-reversed order; it
+  is gathered into the natural order that InverseRealFFTf wants, and then
+  multiplied by the filter with contiguous vector operations.
+
+*//*******************************************************************/
+
+#include "FFTConvolver.h"
+#include "FFTConvolverKernels.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "FFT.h"
+#include "SampleConvert.h"
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FFT_CONVOLVER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+#ifdef FFT_CONVOLVER_SSE2
+struct SSE2 {
+   static constexpr size_t Width = 4;
+   using Float = __m128;
+
+   static Float Load(const float *p) { return _mm_loadu_ps(p); }
+   static void Store(float *p, Float x) { _mm_storeu_ps(p, x); }
+   static Float Add(Float x, Float y) { return _mm_add_ps(x, y); }
+   static Float Mul(Float x, Float y) { return _mm_mul_ps(x, y); }
+   static Float SwapPairs(Float x)
+      { return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)); }
+};
+#endif
+
+void Multiply(float *data, const float *a, const float *b, size_t len)
+{
+   using namespace SampleConvert;
+   static const auto multiplyAVX2 = FFTConvolverImpl::AVX2Multiply();
+   switch (GetInstructionSet()) {
+   case InstructionSet::AVX2:
+      if (multiplyAVX2) {
+         multiplyAVX2(data, a, b, len);
+         return;
+      }
+      [[fallthrough]];
+   case InstructionSet::SSE2:
+#ifdef FFT_CONVOLVER_SSE2
+      FFTConvolverKernels::Multiply<SSE2>(data, a, b, len);
+      return;
+#else
+      [[fallthrough]];
+#endif
+   default:
+      FFTConvolverKernels::MultiplyScalar(data, a, b, len);
+   }
+}
+
+}
+
+size_t FFTConvolver::DefaultFFTSize(size_t length)
+{
+   // About four times the filter length balances the cost of each FFT
+   // against the number of input samples it filters
+   size_t result = 256;
+   while (result < 4 * length)
+      result *= 2;
+   return result;
+}
+
+FFTConvolver::FFTConvolver(
+   const float *impulse, size_t length, size_t fftSize)
+: mLength{ std::max<size_t>(1, length) }
+, mFFTSize{ fftSize ? fftSize : DefaultFFTSize(mLength) }
+, mStepSize{ mFFTSize - (mLength - 1) }
+, hFFT{ GetFFT(mFFTSize) }
+, mFactorA{ mFFTSize }
+, mFactorB{ mFFTSize }
+, mPending{ mLength - 1 }
+{
+   assert(mLength < mFFTSize);
+
+   Floats padded{ mFFTSize };
+   std::fill(padded.get(), padded.get() + mFFTSize, 0.0f);
+   std::copy(impulse, impulse + length, padded.get());
+   Floats re{ mFFTSize }, im{ mFFTSize };
+   RealFFT(mFFTSize, padded.get(), re.get(), im.get());
+
+   // DC and Fs/2 are purely real, and are the first pair
+   const auto half = mFFTSize / 2;
+   mFactorA[0] = re[0];
+   mFactorA[1] = re[half];
+   mFactorB[0] = mFactorB[1] = 0;
+   for (size_t i = 1; i < half; ++i) {
+      mFactorA[2 * i] = mFactorA[2 * i + 1] = re[i];
+      mFactorB[2 * i] = -im[i];
+      mFactorB[2 * i + 1] = im[i];
+   }
+
+   Reset();
+}
+
+FFTConvolver::~FFTConvolver() = default;
+
+void FFTConvolver::Filter(float *buffer, float *scratch) const
+{
+   RealFFTf(buffer, hFFT.get());
+
+   scratch[0] = buffer[0];
+   scratch[1] = buffer[1];
+   for (size_t i = 1, half = mFFTSize / 2; i < half; ++i) {
+      const auto index = hFFT->BitReversed[i];
+      scratch[2 * i] = buffer[index];
+      scratch[2 * i + 1] = buffer[index + 1];
+   }
+   Multiply(scratch, mFactorA.get(), mFactorB.get(), mFFTSize);
+
+   InverseRealFFTf(scratch, hFFT.get());
+   ReorderToTime(hFFT.get(), scratch, buffer);
+}
+
+void FFTConvolver::Process(const float *in, float *out, size_t len)
+{
+   const auto nBlocks = (len + mStepSize - 1) / mStepSize;
+   const auto tailLen = mLength - 1;
+
+   // Each block writes its own span of out, and its tail aside
+   Floats tails{ nBlocks * tailLen };
+   ThreadPool::Get().ParallelFor(nBlocks, [&](size_t iBlock){
+      Floats buffer{ mFFTSize }, scratch{ mFFTSize };
+      const auto first = iBlock * mStepSize;
+      const auto width = std::min(mStepSize, len - first);
+      std::copy(in + first, in + first + width, buffer.get());
+      std::fill(buffer.get() + width, buffer.get() + mFFTSize, 0.0f);
+      Filter(buffer.get(), scratch.get());
+      std::copy(buffer.get(), buffer.get() + width, out + first);
+      std::copy(buffer.get() + width, buffer.get() + width + tailLen,
+         &tails[iBlock * tailLen]);
+   });
+
+   // Then add the overlaps in order
+   for (size_t iBlock = 0; iBlock < nBlocks; ++iBlock) {
+      const auto first = iBlock * mStepSize;
+      const auto width = std::min(mStepSize, len - first);
+      for (size_t j = 0, nn = std::min(width, tailLen); j < nn; ++j)
+         out[first + j] += mPending[j];
+      const auto tail = &tails[iBlock * tailLen];
+      for (size_t j = 0; j < tailLen; ++j)
+         mPending[j] =
+            (width + j < tailLen ? mPending[width + j] : 0.0f) + tail[j];
+   }
+}
+
+void FFTConvolver::Flush(float *out)
+{
+   std::copy(mPending.get(), mPending.get() + mLength - 1, out);
+   Reset();
+}
+
+void FFTConvolver::Reset()
+{
+   std::fill(mPending.get(), mPending.get() + mLength - 1, 0.0f);
+}
@@ -0,0 +1,80 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file FFTConvolver.h
+  @brief Fast convolution of a stream with a fixed FIR filter
+
+**********************************************************************/
+
+#ifndef __AUDACITY_FFT_CONVOLVER__
+#define __AUDACITY_FFT_CONVOLVER__
+
+#include <cstddef>
+
+#include "RealFFTf.h"
+
+using Floats = ArrayOf<float>;
+
+//! Convolves a stream of samples with an impulse response, by overlap-add
+/*!
+ The input is cut into blocks of GetStepSize() samples, each transformed
+ with one FFT, multiplied by the spectrum of the filter, and transformed
+ back.  Blocks are independent until their outputs are added, so the blocks
+ of one call to Process() are filtered concurrently on the ThreadPool.
+
+ The multiplication of spectra uses the best instruction set chosen by
+ SampleConvert, and gives the same results to the bit with any of them.
+ */
+class MATH_API FFTConvolver final
+{
+public:
+   //! A power of two suitable for a filter of the given length
+   static size_t DefaultFFTSize(size_t length);
+
+   /*!
+    @param impulse the filter, of the given length
+    @param fftSize a power of two, greater than length; if 0, then
+    DefaultFFTSize(length)
+    */
+   FFTConvolver(const float *impulse, size_t length, size_t fftSize = 0);
+   ~FFTConvolver();
+
+   size_t GetLength() const { return mLength; }
+   size_t GetFFTSize() const { return mFFTSize; }
+   //! Input samples per FFT
+   size_t GetStepSize() const { return mStepSize; }
+
+   //! Filter len more samples of the stream
+   /*!
+    Output lags input by nothing: out[i] is the convolution at the position of
+    in[i].  The last GetLength() - 1 samples of the convolution come from
+    Flush().  in and out may be the same.
+    */
+   void Process(const float *in, float *out, size_t len);
+
+   //! Write the rest of the convolution, GetLength() - 1 samples, and begin
+   //! a new stream
+   void Flush(float *out);
+
+   //! Begin a new stream, discarding the rest of the convolution
+   void Reset();
+
+private:
+   //! Filter one zero-padded block of GetFFTSize() samples in place
+   void Filter(float *buffer, float *scratch) const;
+
+   const size_t mLength;
+   const size_t mFFTSize;
+   const size_t mStepSize;
+   HFFT hFFT;
+
+   //! The spectrum of the filter, as two factors of interleaved spectra,
+   //! in the order of the input of InverseRealFFTf
+   Floats mFactorA, mFactorB;
+   //! Sums of outputs of earlier blocks, for the next GetLength() - 1
+   //! positions of the stream
+   Floats mPending;
+};
+
+#endif
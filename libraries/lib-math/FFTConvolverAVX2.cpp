@@ -0,0 +1,50 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file FFTConvolverAVX2.cpp
+  @brief AVX2 multiplication of spectra for FFTConvolver
+
+  The build compiles this file alone with AVX2 enabled, where the compiler
+  allows it.  Nothing here may run unless the processor has AVX2.
+
+**********************************************************************/
+
+#include "FFTConvolverKernels.h"
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace {
+struct AVX2 {
+   static constexpr size_t Width = 8;
+   using Float = __m256;
+
+   static Float Load(const float *p) { return _mm256_loadu_ps(p); }
+   static void Store(float *p, Float x) { _mm256_storeu_ps(p, x); }
+   static Float Add(Float x, Float y) { return _mm256_add_ps(x, y); }
+   static Float Mul(Float x, Float y) { return _mm256_mul_ps(x, y); }
+   static Float SwapPairs(Float x)
+      { return _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1)); }
+};
+
+void Multiply(float *data, const float *a, const float *b, size_t len)
+{
+   FFTConvolverKernels::Multiply<AVX2>(data, a, b, len);
+}
+}
+
+FFTConvolverImpl::MultiplyFunction FFTConvolverImpl::AVX2Multiply()
+{
+   return Multiply;
+}
+
+#else
+
+FFTConvolverImpl::MultiplyFunction FFTConvolverImpl::AVX2Multiply()
+{
+   return nullptr;
+}
+
+#endif
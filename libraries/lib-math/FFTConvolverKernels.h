@@ -0,0 +1,64 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file FFTConvolverKernels.h
+  @brief Multiplication of spectra, generic in the vector instruction set
+
+  Included only by the translation units of FFTConvolver, each of which
+  may be compiled for different instructions.  Therefore everything here
+  but the declaration of AVX2Multiply has internal linkage, as in
+  SampleConvertKernels.h.
+
+**********************************************************************/
+
+#ifndef __AUDACITY_FFT_CONVOLVER_KERNELS__
+#define __AUDACITY_FFT_CONVOLVER_KERNELS__
+
+#include <cstddef>
+
+namespace FFTConvolverImpl {
+
+//! data[i] = data[i] * a[i] + data[i ^ 1] * b[i], for even len
+/*!
+ With a holding the real parts of the filter twice over, and b the
+ imaginary parts as (-im, im), this multiplies interleaved complex numbers
+ */
+using MultiplyFunction =
+   void (*)(float *data, const float *a, const float *b, size_t len);
+
+//! @return null if the build can't generate AVX2 instructions
+MultiplyFunction AVX2Multiply();
+
+}
+
+namespace {
+namespace FFTConvolverKernels {
+
+inline void MultiplyScalar(
+   float *data, const float *a, const float *b, size_t len)
+{
+   for (size_t i = 0; i + 1 < len; i += 2) {
+      const auto re = data[i], im = data[i + 1];
+      data[i] = re * a[i] + im * b[i];
+      data[i + 1] = im * a[i + 1] + re * b[i + 1];
+   }
+}
+
+//! V::Width must be even, so that pairs never straddle vectors
+template<typename V>
+void Multiply(float *data, const float *a, const float *b, size_t len)
+{
+   size_t i = 0;
+   for (; i + V::Width <= len; i += V::Width) {
+      const auto x = V::Load(data + i);
+      V::Store(data + i, V::Add(V::Mul(x, V::Load(a + i)),
+         V::Mul(V::SwapPairs(x), V::Load(b + i))));
+   }
+   MultiplyScalar(data + i, a + i, b + i, len - i);
+}
+
+}
+}
+
+#endif
@@ -38,12 +38,14 @@
 
 #include "RealFFTf.h"
 
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <stdlib.h>
 #include <stdio.h>
 #include <cmath>
 
-#include <mutex>
+#include "ThreadPool.h"
 
 #ifndef M_PI
 #define	M_PI		3.14159265358979323846  /* pi */
@@ -84,63 +86,99 @@ HFFT InitializeFFT(size_t fftlen)
       h->SinTable[h->BitReversed[i]+1]=(fft_type)-cos(2*M_PI*i/(2*h->Points));
    }
 
-#ifdef EXPERIMENTAL_EQ_SSE_THREADED
-   // NEW SSE FFT routines work on live data
-   for(size_t i = 0; i < 32; i++)
-      if((1 << i) & fftlen)
-         h->pow2Bits = i;
-#endif
-
    return h;
 }
 
-enum : size_t { MAX_HFFT = 10 };
+namespace {
+// One set of tables for each power of two, made on first demand, shared
+// by all threads, and never destroyed before exit
+enum : size_t { MAX_FFT_BITS = 32 };
+
+struct Pool {
+   std::atomic<FFTParam*> tables[MAX_FFT_BITS]{};
+   ~Pool()
+   {
+      for (auto &table : tables)
+         delete table.load();
+   }
+} sPool;
 
-// Maintain a pool:
-static std::vector< std::unique_ptr<FFTParam> > hFFTArray(MAX_HFFT);
-std::mutex getFFTMutex;
+//! @return MAX_FFT_BITS if fftlen is not a power of two that can be pooled
+size_t PoolIndex(size_t fftlen)
+{
+   size_t bits = 0;
+   while (bits < MAX_FFT_BITS && (size_t(1) << bits) < fftlen)
+      ++bits;
+   return (bits < MAX_FFT_BITS && (size_t(1) << bits) == fftlen)
+      ? bits : MAX_FFT_BITS;
+}
+}
 
 /* Get a handle to the FFT tables of the desired length */
 /* This version keeps common tables rather than allocating a NEW table every time */
 HFFT GetFFT(size_t fftlen)
 {
-   // To do:  smarter policy about when to retain in the pool and when to
-   // allocate a unique instance.
-
-   std::lock_guard<std::mutex> locker{ getFFTMutex };
-   
-   size_t h = 0;
-   auto n = fftlen/2;
-   auto size = hFFTArray.size();
-   for(;
-       (h < size) && hFFTArray[h] && (n != hFFTArray[h]->Points);
-       h++)
-      ;
-   if(h < size) {
-      if(hFFTArray[h] == NULL) {
-         hFFTArray[h].reset( InitializeFFT(fftlen).release() );
-      }
-      return HFFT{ hFFTArray[h].get() };
-   } else {
-      // All buffers used, so fall back to allocating a NEW set of tables
+   // Without locks:  tables are immutable once made, and if two threads
+   // make the same tables at once, one of them discards its own
+   const auto index = PoolIndex(fftlen);
+   if (index == MAX_FFT_BITS)
       return InitializeFFT(fftlen);
+
+   auto &slot = sPool.tables[index];
+   auto pTables = slot.load(std::memory_order_acquire);
+   if (!pTables) {
+      auto hNew = InitializeFFT(fftlen);
+      if (slot.compare_exchange_strong(pTables, hNew.get(),
+            std::memory_order_acq_rel, std::memory_order_acquire))
+         pTables = hNew.release();
+      // else pTables is now what the other thread made, and hNew is freed
    }
+   return HFFT{ pTables };
 }
 
 /* Release a previously requested handle to the FFT tables */
 void FFTDeleter::operator() (FFTParam *hFFT) const
 {
-   std::lock_guard<std::mutex> locker{ getFFTMutex };
-
-   auto it = hFFTArray.begin(), end = hFFTArray.end();
-   while (it != end && it->get() != hFFT)
-      ++it;
-   if ( it != end )
+   const auto index = PoolIndex(2 * hFFT->Points);
+   if (index < MAX_FFT_BITS &&
+       sPool.tables[index].load(std::memory_order_acquire) == hFFT)
       ;
    else
       delete hFFT;
 }
 
+namespace {
+template<typename Transform>
+void TransformBatch(
+   fft_type *buffers, size_t count, const FFTParam *h, Transform transform)
+{
+   const auto stride = 2 * h->Points;
+   // A few tasks for each thread, each doing a run of transforms
+   const auto nTasks =
+      std::min(count, 4 * (ThreadPool::Get().GetNumThreads() + 1));
+   if (nTasks <= 1) {
+      for (size_t ii = 0; ii < count; ++ii)
+         transform(buffers + ii * stride, h);
+      return;
+   }
+   ThreadPool::Get().ParallelFor(nTasks, [&](size_t iTask){
+      for (auto ii = count * iTask / nTasks,
+           end = count * (iTask + 1) / nTasks; ii < end; ++ii)
+         transform(buffers + ii * stride, h);
+   });
+}
+}
+
+void RealFFTfBatch(fft_type *buffers, size_t count, const FFTParam *h)
+{
+   TransformBatch(buffers, count, h, RealFFTf);
+}
+
+void InverseRealFFTfBatch(fft_type *buffers, size_t count, const FFTParam *h)
+{
+   TransformBatch(buffers, count, h, InverseRealFFTf);
+}
+
 /*
 *  Forward FFT routine.  Must call GetFFT(fftlen) first!
 *
@@ -8,9 +8,6 @@ struct FFTParam {
    ArrayOf<int> BitReversed;
    ArrayOf<fft_type> SinTable;
    size_t Points;
-#ifdef EXPERIMENTAL_EQ_SSE_THREADED
-   int pow2Bits;
-#endif
 };
 
 struct MATH_API FFTDeleter{
@@ -21,9 +18,22 @@ using HFFT = std::unique_ptr<
    FFTParam, FFTDeleter
 >;
 
+//! Tables for transforms of the given length
+/*! Tables for a power of two are shared among threads, and made only once
+    for each length, without locking.  Any other length gets tables of its
+    own, made at each call; RealFFTf and InverseRealFFTf are correct only
+    for powers of two. */
 MATH_API HFFT GetFFT(size_t);
 MATH_API void RealFFTf(fft_type *, const FFTParam *);
 MATH_API void InverseRealFFTf(fft_type *, const FFTParam *);
+
+//! RealFFTf for count buffers of 2 * Points values, one after another,
+//! concurrently on the ThreadPool
+MATH_API void RealFFTfBatch(fft_type *buffers, size_t count, const FFTParam *);
+//! InverseRealFFTf for count buffers of 2 * Points values, one after
+//! another, concurrently on the ThreadPool
+MATH_API void InverseRealFFTfBatch(
+   fft_type *buffers, size_t count, const FFTParam *);
 MATH_API void ReorderToTime(const FFTParam *hFFT, const fft_type *buffer, fft_type *TimeOut);
 MATH_API void ReorderToFreq(const FFTParam *hFFT, const fft_type *buffer,
 		   fft_type *RealOut, fft_type *ImagOut);
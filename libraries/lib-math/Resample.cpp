@@ -16,9 +16,8 @@
 
       libsoxr, written by Rob Sykes. LGPL.
 
-   Since Audacity always does resampling on mono streams that are
-   contiguous in memory, this class doesn't support multiple channels
-   or some of the other optional features of some of these resamplers.
+   One instance may resample several channels together, either
+   interleaved in one buffer, or planar with one buffer per channel.
 
 *//*******************************************************************/
 
@@ -27,11 +26,23 @@
 #include "Internat.h"
 #include "ComponentInterface.h"
 
+#include <algorithm>
+#include <cassert>
 #include <soxr.h>
 
-Resample::Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor)
+Resample::Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor,
+   unsigned nChannels, bool planar, unsigned nThreads)
+   : Resample{ ReadMethod(useBestMethod), dMinFactor, dMaxFactor,
+      nChannels, planar, nThreads }
+{
+}
+
+Resample::Resample(const int method, const double dMinFactor, const double dMaxFactor,
+   unsigned nChannels, bool planar, unsigned nThreads)
+   : mMethod{ method }
+   , mNumChannels{ std::max(1u, nChannels) }
+   , mPlanar{ planar }
 {
-   this->SetMethod(useBestMethod);
    soxr_quality_spec_t q_spec;
    if (dMinFactor == dMaxFactor)
    {
@@ -43,7 +54,12 @@ Resample::Resample(const bool useBestMethod, const double dMinFactor, const doub
       mbWantConstRateResampling = false; // variable rate resampling
       q_spec = soxr_quality_spec(SOXR_HQ, SOXR_VR);
    }
-   mHandle.reset(soxr_create(1, dMinFactor, 1, 0, 0, &q_spec, 0));
+   const auto io_spec = planar
+      ? soxr_io_spec(SOXR_FLOAT32_S, SOXR_FLOAT32_S)
+      : soxr_io_spec(SOXR_FLOAT32_I, SOXR_FLOAT32_I);
+   const auto runtime_spec = soxr_runtime_spec(nThreads);
+   mHandle.reset(soxr_create(1, dMinFactor, mNumChannels, 0,
+      &io_spec, &q_spec, &runtime_spec));
 }
 
 Resample::~Resample()
@@ -91,13 +107,35 @@ std::pair<size_t, size_t>
                         bool    lastFlag,
                         float  *outBuffer,
                         size_t  outBufferLen)
+{
+   assert(!mPlanar || mNumChannels == 1);
+   return DoProcess(factor, inBuffer, inBufferLen, lastFlag,
+      outBuffer, outBufferLen);
+}
+
+std::pair<size_t, size_t>
+      Resample::Process(double  factor,
+                        const float *const *inBuffers,
+                        size_t  inBufferLen,
+                        bool    lastFlag,
+                        float  *const *outBuffers,
+                        size_t  outBufferLen)
+{
+   assert(mPlanar);
+   return DoProcess(factor, inBuffers, inBufferLen, lastFlag,
+      outBuffers, outBufferLen);
+}
+
+std::pair<size_t, size_t> Resample::DoProcess(double factor,
+   const void *in, size_t inBufferLen, bool lastFlag,
+   void *out, size_t outBufferLen)
 {
    size_t idone, odone;
    if (mbWantConstRateResampling)
    {
       soxr_process(mHandle.get(),
-            inBuffer , (lastFlag? ~inBufferLen : inBufferLen), &idone,
-            outBuffer,                           outBufferLen, &odone);
+            in , (lastFlag? ~inBufferLen : inBufferLen), &idone,
+            out,                           outBufferLen, &odone);
    }
    else
    {
@@ -105,16 +143,16 @@ std::pair<size_t, size_t>
 
       inBufferLen = lastFlag? ~inBufferLen : inBufferLen;
       soxr_process(mHandle.get(),
-            inBuffer , inBufferLen , &idone,
-            outBuffer, outBufferLen, &odone);
+            in , inBufferLen , &idone,
+            out, outBufferLen, &odone);
    }
    return { idone, odone };
 }
 
-void Resample::SetMethod(const bool useBestMethod)
+int Resample::ReadMethod(const bool useBestMethod)
 {
    if (useBestMethod)
-      mMethod = BestMethodSetting.ReadEnum();
+      return BestMethodSetting.ReadEnum();
    else
-      mMethod = FastMethodSetting.ReadEnum();
+      return FastMethodSetting.ReadEnum();
 }
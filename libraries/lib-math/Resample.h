@@ -36,9 +36,26 @@ class MATH_API Resample final
    /// the fast method.
    // dMinFactor and dMaxFactor specify the range of factors for variable-rate resampling.
    // For constant-rate, pass the same value for both.
-   Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor);
+   //
+   /// One resampler may convert several channels in step, each of which
+   /// consumes and produces the same numbers of samples.
+   /// nThreads is passed to libsoxr, which may convert channels in
+   /// parallel when built with OpenMP; 0 lets it choose.  Use 1 where
+   /// latency matters more than throughput.
+   Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor,
+      unsigned nChannels = 1, bool planar = false, unsigned nThreads = 1);
+   /// As above, with a method from ReadMethod(), so that resamplers can be
+   /// made where preferences can't be read
+   Resample(const int method, const double dMinFactor, const double dMaxFactor,
+      unsigned nChannels = 1, bool planar = false, unsigned nThreads = 1);
    ~Resample();
 
+   /// The preferred best or fast method; main thread only
+   static int ReadMethod(const bool useBestMethod);
+
+   unsigned GetNumChannels() const { return mNumChannels; }
+   bool IsPlanar() const { return mPlanar; }
+
    static EnumSetting< int > FastMethodSetting;
    static EnumSetting< int > BestMethodSetting;
 
@@ -53,14 +70,15 @@ class MATH_API Resample final
     * This function may do nothing if you don't pass a large enough output
     * buffer (i.e. there is no where to put a full block of output data)
     @param factor The scaling factor to resample by.
-    @param inBuffer Buffer of input samples to be processed (mono)
-    @param inBufferLen Length of the input buffer, in samples.
+    @param inBuffer Buffer of input samples to be processed (mono, or
+    interleaved channels)
+    @param inBufferLen Length of the input buffer, in samples per channel.
     @param lastFlag Flag to indicate this is the last lot of input samples and
     the buffer needs to be emptied out into the rate converter.
     (unless lastFlag is true, we don't guarantee to process all the samples in
     the input this time, we may leave some for next time)
     @param outBuffer Buffer to write output (converted) samples to.
-    @param outBufferLen How big outBuffer is.
+    @param outBufferLen How big outBuffer is, in samples per channel.
     @return Number of input samples consumed, and number of output samples
     created by this call
    */
@@ -72,13 +90,27 @@ class MATH_API Resample final
                         float  *outBuffer,
                         size_t  outBufferLen);
 
- protected:
-   void SetMethod(const bool useBestMethod);
+   //! Like the other overload, for a planar resampler, with one input and
+   //! one output buffer per channel
+   std::pair<size_t, size_t>
+                Process(double  factor,
+                        const float *const *inBuffers,
+                        size_t  inBufferLen,
+                        bool    lastFlag,
+                        float  *const *outBuffers,
+                        size_t  outBufferLen);
+
+ private:
+   std::pair<size_t, size_t> DoProcess(double factor,
+      const void *in, size_t inBufferLen, bool lastFlag,
+      void *out, size_t outBufferLen);
 
  protected:
    int   mMethod; // resampler-specific enum for resampling method
    soxrHandle mHandle; // constant-rate or variable-rate resampler (XOR per instance)
    bool mbWantConstRateResampling;
+   unsigned mNumChannels;
+   bool mPlanar;
 };
 
 #endif // __AUDACITY_RESAMPLE_H__
@@ -0,0 +1,223 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SampleConvert.cpp
+
+*******************************************************************//*!
+
+\namespace SampleConvert
+\brief Chooses among scalar, SSE2 and AVX2 implementations of conversions
+
+  SSE2 is always available where the compiler targets it (every x86-64
+  processor has it).  AVX2 kernels are compiled separately, with the
+  instructions enabled only for that file, and used only if the
+  processor reports them.
+
+*//*******************************************************************/
+
+#include "SampleConvert.h"
+#include "SampleConvertKernels.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAMPLE_CONVERT_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#ifdef SAMPLE_CONVERT_SSE2
+struct SSE2 {
+   static constexpr size_t Width = 4;
+   using Float = __m128;
+   using Int = __m128i;
+
+   static Float Set1(float x) { return _mm_set1_ps(x); }
+   static Float LoadFloat(const float *p) { return _mm_loadu_ps(p); }
+   static void StoreFloat(float *p, Float x) { _mm_storeu_ps(p, x); }
+   static Int LoadInt32(const int *p)
+      { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+   static void StoreInt32(int *p, Int x)
+      { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+   static Int LoadInt16(const short *p)
+   {
+      // Sign-extend by duplicating into the high halves and shifting down
+      const auto x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+      return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+   }
+   static void StoreInt16(short *p, Int x)
+   {
+      // Packing saturates
+      _mm_storel_epi64(
+         reinterpret_cast<__m128i*>(p), _mm_packs_epi32(x, x));
+   }
+   static Float ToFloat(Int x) { return _mm_cvtepi32_ps(x); }
+   //! Rounds to nearest even, as lrintf does in the default rounding mode
+   static Int Round(Float x) { return _mm_cvtps_epi32(x); }
+   static Int ShiftLeft8(Int x) { return _mm_slli_epi32(x, 8); }
+   static Float Add(Float x, Float y) { return _mm_add_ps(x, y); }
+   static Float Sub(Float x, Float y) { return _mm_sub_ps(x, y); }
+   static Float Mul(Float x, Float y) { return _mm_mul_ps(x, y); }
+   static Float Min(Float x, Float y) { return _mm_min_ps(x, y); }
+   static Float Max(Float x, Float y) { return _mm_max_ps(x, y); }
+   static Float ZeroNaN(Float x) { return _mm_and_ps(x, _mm_cmpord_ps(x, x)); }
+   static Int Clamp24(Int x)
+   {
+      // SSE2 has no min and max of 32 bit integers
+      const auto hi = _mm_set1_epi32(8388607);
+      const auto lo = _mm_set1_epi32(-8388608);
+      auto mask = _mm_cmpgt_epi32(x, hi);
+      x = _mm_or_si128(_mm_and_si128(mask, hi), _mm_andnot_si128(mask, x));
+      mask = _mm_cmplt_epi32(x, lo);
+      return _mm_or_si128(_mm_and_si128(mask, lo), _mm_andnot_si128(mask, x));
+   }
+};
+#endif
+
+bool ProcessorHasAVX2()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+   int info[4];
+   __cpuid(info, 0);
+   if (info[0] < 7)
+      return false;
+   __cpuid(info, 1);
+   // The operating system must also save the AVX registers
+   const bool osxsave = (info[2] & (1 << 27)) != 0;
+   const bool avx = (info[2] & (1 << 28)) != 0;
+   if (!(osxsave && avx) || (_xgetbv(0) & 6) != 6)
+      return false;
+   __cpuidex(info, 7, 0);
+   return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && \
+   (defined(__x86_64__) || defined(__i386__))
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2");
+#else
+   return false;
+#endif
+}
+
+const SampleConvert::Kernels &ScalarKernels()
+{
+   static const auto kernels = SampleConvertImpl::MakeScalarKernels();
+   return kernels;
+}
+
+#ifdef SAMPLE_CONVERT_SSE2
+const SampleConvert::Kernels &SSE2Kernels()
+{
+   static const auto kernels = SampleConvertImpl::MakeKernels<SSE2>();
+   return kernels;
+}
+#endif
+
+const SampleConvert::Kernels &KernelsFor(SampleConvert::InstructionSet set)
+{
+   using namespace SampleConvert;
+   switch (set) {
+   case InstructionSet::AVX2:
+      if (auto pKernels = AVX2Kernels())
+         return *pKernels;
+      [[fallthrough]];
+   case InstructionSet::SSE2:
+#ifdef SAMPLE_CONVERT_SSE2
+      return SSE2Kernels();
+#else
+      [[fallthrough]];
+#endif
+   default:
+      return ScalarKernels();
+   }
+}
+
+// Constant initialized, so that conversions during static initialization
+// of other files are correct too
+std::atomic<const SampleConvert::Kernels*> sKernels{ nullptr };
+std::atomic<SampleConvert::InstructionSet> sInstructionSet{
+   SampleConvert::InstructionSet::Scalar };
+
+const SampleConvert::Kernels &Get()
+{
+   auto pKernels = sKernels.load(std::memory_order_acquire);
+   if (!pKernels) {
+      SampleConvert::SetInstructionSet(SampleConvert::Supported());
+      pKernels = sKernels.load(std::memory_order_acquire);
+   }
+   return *pKernels;
+}
+
+}
+
+namespace SampleConvert {
+
+InstructionSet Supported()
+{
+   static const auto result = []{
+      if (AVX2Kernels() && ProcessorHasAVX2())
+         return InstructionSet::AVX2;
+#ifdef SAMPLE_CONVERT_SSE2
+      return InstructionSet::SSE2;
+#else
+      return InstructionSet::Scalar;
+#endif
+   }();
+   return result;
+}
+
+InstructionSet GetInstructionSet()
+{
+   Get();
+   return sInstructionSet.load(std::memory_order_relaxed);
+}
+
+void SetInstructionSet(InstructionSet set)
+{
+   set = std::min(set, Supported());
+   sInstructionSet.store(set, std::memory_order_relaxed);
+   sKernels.store(&KernelsFor(set), std::memory_order_release);
+}
+
+void Int16ToFloat(const short *src, float *dst, size_t len)
+{
+   Get().int16ToFloat(src, dst, len);
+}
+
+void Int24ToFloat(const int *src, float *dst, size_t len)
+{
+   Get().int24ToFloat(src, dst, len);
+}
+
+void Int16ToInt24(const short *src, int *dst, size_t len)
+{
+   Get().int16ToInt24(src, dst, len);
+}
+
+void FloatToInt16(const float *src, short *dst, size_t len,
+   const float *add, const float *sub)
+{
+   Get().floatToInt16(src, dst, len, add, sub);
+}
+
+void FloatToInt24(const float *src, int *dst, size_t len,
+   const float *add, const float *sub)
+{
+   Get().floatToInt24(src, dst, len, add, sub);
+}
+
+void Int24ToInt16(const int *src, short *dst, size_t len,
+   const float *add, const float *sub)
+{
+   Get().int24ToInt16(src, dst, len, add, sub);
+}
+
+}
@@ -0,0 +1,63 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SampleConvert.h
+  @brief Vectorized conversions between sample formats
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SAMPLE_CONVERT__
+#define __AUDACITY_SAMPLE_CONVERT__
+
+#include <cstddef>
+
+//! Kernels used by Dither to convert contiguous runs of samples
+/*!
+ The implementation is chosen once, for the best instruction set that both
+ the build and the processor support.  All implementations give the same
+ results as the scalar one, to the bit, with one exception:  NaN always
+ becomes 0, where the scalar conversion of a NaN to an integer depends on
+ the platform.
+
+ Integer samples are converted to float by the same scaling as in
+ SampleFormat.cpp.  Float samples are clipped to [-1, 1] before scaling.
+ */
+namespace SampleConvert {
+
+enum class InstructionSet : unsigned {
+   Scalar,
+   SSE2,
+   AVX2,
+};
+
+//! The best instruction set usable in this process
+MATH_API InstructionSet Supported();
+
+MATH_API InstructionSet GetInstructionSet();
+
+//! For comparisons and benchmarks; limited to what is Supported()
+MATH_API void SetInstructionSet(InstructionSet set);
+
+MATH_API void Int16ToFloat(const short *src, float *dst, size_t len);
+MATH_API void Int24ToFloat(const int *src, float *dst, size_t len);
+MATH_API void Int16ToInt24(const short *src, int *dst, size_t len);
+
+/*! @name Rounding conversions
+ Each sample, promoted to the range of the destination type, becomes
+ round((sample + add[i]) - sub[i]), clipped to the range.  Either of add
+ and sub may be null, which is the same as all zeroes.  Thus dither noise
+ computed in advance is applied exactly as Dither would apply it.
+ */
+//! @{
+MATH_API void FloatToInt16(const float *src, short *dst, size_t len,
+   const float *add, const float *sub);
+MATH_API void FloatToInt24(const float *src, int *dst, size_t len,
+   const float *add, const float *sub);
+MATH_API void Int24ToInt16(const int *src, short *dst, size_t len,
+   const float *add, const float *sub);
+//! @}
+
+}
+
+#endif
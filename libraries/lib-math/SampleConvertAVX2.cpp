@@ -0,0 +1,79 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SampleConvertAVX2.cpp
+  @brief AVX2 kernels of SampleConvert
+
+  The build compiles this file alone with AVX2 enabled, where the compiler
+  allows it.  Nothing here may run unless the processor has AVX2.
+
+**********************************************************************/
+
+#include "SampleConvert.h"
+#include "SampleConvertKernels.h"
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace {
+struct AVX2 {
+   static constexpr size_t Width = 8;
+   using Float = __m256;
+   using Int = __m256i;
+
+   static Float Set1(float x) { return _mm256_set1_ps(x); }
+   static Float LoadFloat(const float *p) { return _mm256_loadu_ps(p); }
+   static void StoreFloat(float *p, Float x) { _mm256_storeu_ps(p, x); }
+   static Int LoadInt32(const int *p)
+      { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+   static void StoreInt32(int *p, Int x)
+      { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+   static Int LoadInt16(const short *p)
+   {
+      return _mm256_cvtepi16_epi32(
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+   }
+   static void StoreInt16(short *p, Int x)
+   {
+      // Packing saturates, but works within each 128 bit half; then
+      // gather the two useful quarters
+      const auto packed =
+         _mm256_permute4x64_epi64(_mm256_packs_epi32(x, x), 0x08);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+         _mm256_castsi256_si128(packed));
+   }
+   static Float ToFloat(Int x) { return _mm256_cvtepi32_ps(x); }
+   //! Rounds to nearest even, as lrintf does in the default rounding mode
+   static Int Round(Float x) { return _mm256_cvtps_epi32(x); }
+   static Int ShiftLeft8(Int x) { return _mm256_slli_epi32(x, 8); }
+   static Float Add(Float x, Float y) { return _mm256_add_ps(x, y); }
+   static Float Sub(Float x, Float y) { return _mm256_sub_ps(x, y); }
+   static Float Mul(Float x, Float y) { return _mm256_mul_ps(x, y); }
+   static Float Min(Float x, Float y) { return _mm256_min_ps(x, y); }
+   static Float Max(Float x, Float y) { return _mm256_max_ps(x, y); }
+   static Float ZeroNaN(Float x)
+      { return _mm256_and_ps(x, _mm256_cmp_ps(x, x, _CMP_ORD_Q)); }
+   static Int Clamp24(Int x)
+   {
+      return _mm256_max_epi32(_mm256_set1_epi32(-8388608),
+         _mm256_min_epi32(_mm256_set1_epi32(8388607), x));
+   }
+};
+}
+
+const SampleConvert::Kernels *SampleConvert::AVX2Kernels()
+{
+   static const auto kernels = SampleConvertImpl::MakeKernels<AVX2>();
+   return &kernels;
+}
+
+#else
+
+const SampleConvert::Kernels *SampleConvert::AVX2Kernels()
+{
+   return nullptr;
+}
+
+#endif
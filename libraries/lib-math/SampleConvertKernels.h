@@ -0,0 +1,243 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SampleConvertKernels.h
+  @brief Loops of SampleConvert, generic in the vector instruction set
+
+  Included only by the translation units of SampleConvert, each of which
+  may be compiled for different instructions.  Therefore everything here
+  but the Kernels table has internal linkage, so that the linker can never
+  substitute the AVX2 compilation of a function for the SSE2 one.
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SAMPLE_CONVERT_KERNELS__
+#define __AUDACITY_SAMPLE_CONVERT_KERNELS__
+
+#include <cstddef>
+
+// Erik de Castro Lopo's header file that
+// makes sure that we have lrint and lrintf
+#include "float_cast.h"
+
+namespace SampleConvert {
+
+//! One implementation of each conversion
+struct Kernels {
+   void (*int16ToFloat)(const short *src, float *dst, size_t len);
+   void (*int24ToFloat)(const int *src, float *dst, size_t len);
+   void (*int16ToInt24)(const short *src, int *dst, size_t len);
+   void (*floatToInt16)(const float *src, short *dst, size_t len,
+      const float *add, const float *sub);
+   void (*floatToInt24)(const float *src, int *dst, size_t len,
+      const float *add, const float *sub);
+   void (*int24ToInt16)(const int *src, short *dst, size_t len,
+      const float *add, const float *sub);
+};
+
+//! @return null if the build can't generate AVX2 instructions
+const Kernels *AVX2Kernels();
+
+}
+
+namespace {
+namespace SampleConvertImpl {
+
+constexpr float Scale16 = float(1 << 15);
+constexpr float Scale24 = float(1 << 23);
+
+// Scalar versions, which also finish the vector loops
+
+inline float ClipFloat(float sample)
+{
+   return sample > 1.0f ? 1.0f : sample < -1.0f ? -1.0f : sample;
+}
+
+inline long RoundSample(float sample)
+{
+   if (sample != sample)
+      sample = 0;
+   return lrintf(sample);
+}
+
+template<typename Dst, long Min, long Max>
+inline void StoreRounded(Dst *dst, float sample)
+{
+   const auto x = RoundSample(sample);
+   *dst = x > Max ? Max : x < Min ? Min : static_cast<Dst>(x);
+}
+
+inline float Dither(float sample, const float *add, const float *sub,
+   size_t ii)
+{
+   if (add)
+      sample += add[ii];
+   if (sub)
+      sample -= sub[ii];
+   return sample;
+}
+
+inline void ScalarInt16ToFloat(const short *src, float *dst, size_t len)
+{
+   for (size_t ii = 0; ii < len; ++ii)
+      dst[ii] = src[ii] / Scale16;
+}
+
+inline void ScalarInt24ToFloat(const int *src, float *dst, size_t len)
+{
+   for (size_t ii = 0; ii < len; ++ii)
+      dst[ii] = src[ii] / Scale24;
+}
+
+inline void ScalarInt16ToInt24(const short *src, int *dst, size_t len)
+{
+   for (size_t ii = 0; ii < len; ++ii)
+      dst[ii] = static_cast<int>(src[ii]) << 8;
+}
+
+inline void ScalarFloatToInt16(const float *src, short *dst, size_t len,
+   const float *add, const float *sub)
+{
+   for (size_t ii = 0; ii < len; ++ii)
+      StoreRounded<short, -32768, 32767>(dst + ii,
+         Dither(ClipFloat(src[ii]) * Scale16, add, sub, ii));
+}
+
+inline void ScalarFloatToInt24(const float *src, int *dst, size_t len,
+   const float *add, const float *sub)
+{
+   for (size_t ii = 0; ii < len; ++ii)
+      StoreRounded<int, -8388608, 8388607>(dst + ii,
+         Dither(ClipFloat(src[ii]) * Scale24, add, sub, ii));
+}
+
+inline void ScalarInt24ToInt16(const int *src, short *dst, size_t len,
+   const float *add, const float *sub)
+{
+   for (size_t ii = 0; ii < len; ++ii)
+      StoreRounded<short, -32768, 32767>(dst + ii,
+         Dither((src[ii] / Scale24) * Scale16, add, sub, ii));
+}
+
+inline const float *Advance(const float *p, size_t n)
+{
+   return p ? p + n : p;
+}
+
+// Vector versions.  V supplies the vector types and operations, and Width.
+// Multiplication by the reciprocal of a power of two is exactly division.
+
+template<typename V>
+void Int16ToFloat(const short *src, float *dst, size_t len)
+{
+   const auto scale = V::Set1(1.0f / Scale16);
+   size_t ii = 0;
+   for (; ii + V::Width <= len; ii += V::Width)
+      V::StoreFloat(dst + ii, V::Mul(V::ToFloat(V::LoadInt16(src + ii)), scale));
+   ScalarInt16ToFloat(src + ii, dst + ii, len - ii);
+}
+
+template<typename V>
+void Int24ToFloat(const int *src, float *dst, size_t len)
+{
+   const auto scale = V::Set1(1.0f / Scale24);
+   size_t ii = 0;
+   for (; ii + V::Width <= len; ii += V::Width)
+      V::StoreFloat(dst + ii, V::Mul(V::ToFloat(V::LoadInt32(src + ii)), scale));
+   ScalarInt24ToFloat(src + ii, dst + ii, len - ii);
+}
+
+template<typename V>
+void Int16ToInt24(const short *src, int *dst, size_t len)
+{
+   size_t ii = 0;
+   for (; ii + V::Width <= len; ii += V::Width)
+      V::StoreInt32(dst + ii, V::ShiftLeft8(V::LoadInt16(src + ii)));
+   ScalarInt16ToInt24(src + ii, dst + ii, len - ii);
+}
+
+//! Add and subtract noise as Dither does, then round, mapping NaN to 0
+template<typename V>
+inline auto DitherAndRound(typename V::Float x,
+   const float *add, const float *sub, size_t ii)
+{
+   if (add)
+      x = V::Add(x, V::LoadFloat(add + ii));
+   if (sub)
+      x = V::Sub(x, V::LoadFloat(sub + ii));
+   return V::Round(V::ZeroNaN(x));
+}
+
+//! Clip as the scalar code does, keeping NaN
+template<typename V>
+inline auto LoadClipped(const float *src, size_t ii)
+{
+   // The min and max instructions return the second operand if either is NaN
+   return V::Max(V::Set1(-1.0f), V::Min(V::Set1(1.0f), V::LoadFloat(src + ii)));
+}
+
+template<typename V>
+void FloatToInt16(const float *src, short *dst, size_t len,
+   const float *add, const float *sub)
+{
+   const auto scale = V::Set1(Scale16);
+   size_t ii = 0;
+   for (; ii + V::Width <= len; ii += V::Width)
+      // Saturation while packing is the clipping
+      V::StoreInt16(dst + ii, DitherAndRound<V>(
+         V::Mul(LoadClipped<V>(src, ii), scale), add, sub, ii));
+   ScalarFloatToInt16(src + ii, dst + ii, len - ii,
+      Advance(add, ii), Advance(sub, ii));
+}
+
+template<typename V>
+void FloatToInt24(const float *src, int *dst, size_t len,
+   const float *add, const float *sub)
+{
+   const auto scale = V::Set1(Scale24);
+   size_t ii = 0;
+   for (; ii + V::Width <= len; ii += V::Width)
+      V::StoreInt32(dst + ii, V::Clamp24(DitherAndRound<V>(
+         V::Mul(LoadClipped<V>(src, ii), scale), add, sub, ii)));
+   ScalarFloatToInt24(src + ii, dst + ii, len - ii,
+      Advance(add, ii), Advance(sub, ii));
+}
+
+template<typename V>
+void Int24ToInt16(const int *src, short *dst, size_t len,
+   const float *add, const float *sub)
+{
+   const auto scale24 = V::Set1(1.0f / Scale24);
+   const auto scale16 = V::Set1(Scale16);
+   size_t ii = 0;
+   for (; ii + V::Width <= len; ii += V::Width) {
+      auto x = V::Mul(V::ToFloat(V::LoadInt32(src + ii)), scale24);
+      V::StoreInt16(dst + ii,
+         DitherAndRound<V>(V::Mul(x, scale16), add, sub, ii));
+   }
+   ScalarInt24ToInt16(src + ii, dst + ii, len - ii,
+      Advance(add, ii), Advance(sub, ii));
+}
+
+template<typename V>
+SampleConvert::Kernels MakeKernels()
+{
+   return {
+      Int16ToFloat<V>, Int24ToFloat<V>, Int16ToInt24<V>,
+      FloatToInt16<V>, FloatToInt24<V>, Int24ToInt16<V>,
+   };
+}
+
+inline SampleConvert::Kernels MakeScalarKernels()
+{
+   return {
+      ScalarInt16ToFloat, ScalarInt24ToFloat, ScalarInt16ToInt24,
+      ScalarFloatToInt16, ScalarFloatToInt24, ScalarInt24ToInt16,
+   };
+}
+
+}
+}
+
+#endif
@@ -48,7 +48,8 @@
 
 DitherType gLowQualityDither = DitherType::none;
 DitherType gHighQualityDither = DitherType::shaped;
-static Dither gDitherAlgorithm;
+// Each thread converting samples needs its own state of the ditherer
+static thread_local Dither gDitherAlgorithm;
 
 void InitDitherers()
 {
@@ -0,0 +1,130 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SampleSummary.cpp
+
+**********************************************************************/
+
+#include "SampleSummary.h"
+
+#include <algorithm>
+
+namespace {
+constexpr size_t Lanes = 8;
+
+//! @tparam Stride floats from one value to the next
+//! @tparam MinOffset, MaxOffset, RmsOffset where each value finds its
+//! minimum, maximum and root, relative to itself
+/*!
+ Each lane keeps its own partial sum of squares, so that the compiler can
+ vectorize the loop.  Adding the partial sums at the end changes the order
+ of the additions, and the sum may differ in the last bits from that of the
+ scalar loops this replaced.  Minima and maxima are exact.
+ */
+template<size_t Stride, size_t MinOffset, size_t MaxOffset, size_t RmsOffset>
+MinMaxSumsq Summarize(const float *values, size_t count)
+{
+   MinMaxSumsq result;
+   size_t ii = 0;
+   if (count >= Lanes) {
+      float mins[Lanes], maxes[Lanes], squares[Lanes];
+      for (size_t kk = 0; kk < Lanes; ++kk) {
+         const auto pValue = values + kk * Stride;
+         mins[kk] = pValue[MinOffset];
+         maxes[kk] = pValue[MaxOffset];
+         squares[kk] = pValue[RmsOffset] * pValue[RmsOffset];
+      }
+      for (ii = Lanes; ii + Lanes <= count; ii += Lanes)
+         for (size_t kk = 0; kk < Lanes; ++kk) {
+            const auto pValue = values + (ii + kk) * Stride;
+            const auto min = pValue[MinOffset];
+            const auto max = pValue[MaxOffset];
+            const auto rms = pValue[RmsOffset];
+            mins[kk] = min < mins[kk] ? min : mins[kk];
+            maxes[kk] = max > maxes[kk] ? max : maxes[kk];
+            squares[kk] += rms * rms;
+         }
+      for (size_t kk = 0; kk < Lanes; ++kk) {
+         result.min = std::min(result.min, mins[kk]);
+         result.max = std::max(result.max, maxes[kk]);
+         result.sumsq += squares[kk];
+      }
+   }
+   for (; ii < count; ++ii) {
+      const auto pValue = values + ii * Stride;
+      result.min = std::min(result.min, pValue[MinOffset]);
+      result.max = std::max(result.max, pValue[MaxOffset]);
+      result.sumsq += pValue[RmsOffset] * pValue[RmsOffset];
+   }
+   return result;
+}
+}
+
+MinMaxSumsq SummarizeSamples(const float *samples, size_t len)
+{
+   return Summarize<1, 0, 0, 0>(samples, len);
+}
+
+MinMaxSumsq SummarizeTriples(const float *triples, size_t count)
+{
+   return Summarize<3, 0, 1, 2>(triples, count);
+}
+
+void SummarizeInterleaved(const float *samples,
+   size_t nChannels, size_t nFrames, MinMaxSumsq *results, size_t nResults)
+{
+   constexpr size_t MaxLanes = 64;
+   nResults = std::min(nResults, nChannels);
+   std::fill(results, results + nResults, MinMaxSumsq{});
+   if (nResults == 0)
+      return;
+   if (nChannels > MaxLanes) {
+      for (size_t jj = 0; jj < nResults; ++jj)
+         for (size_t ii = 0; ii < nFrames; ++ii) {
+            const auto value = samples[ii * nChannels + jj];
+            auto &result = results[jj];
+            result.min = std::min(result.min, value);
+            result.max = std::max(result.max, value);
+            result.sumsq += value * value;
+         }
+      return;
+   }
+
+   // Lane kk always sees channel kk % nChannels, because the width is a
+   // whole number of frames
+   const auto framesPerStep = std::max<size_t>(1, Lanes / nChannels);
+   const auto width = framesPerStep * nChannels;
+   const auto nSteps = nFrames / framesPerStep;
+   float mins[MaxLanes], maxes[MaxLanes], squares[MaxLanes];
+   std::fill(mins, mins + width, FLT_MAX);
+   std::fill(maxes, maxes + width, -FLT_MAX);
+   std::fill(squares, squares + width, 0.0f);
+   for (size_t ii = 0; ii < nSteps; ++ii) {
+      const auto pValues = samples + ii * width;
+      for (size_t kk = 0; kk < width; ++kk) {
+         const auto value = pValues[kk];
+         mins[kk] = value < mins[kk] ? value : mins[kk];
+         maxes[kk] = value > maxes[kk] ? value : maxes[kk];
+         squares[kk] += value * value;
+      }
+   }
+   for (size_t kk = 0; kk < width; ++kk) {
+      if (kk % nChannels >= nResults)
+         continue;
+      auto &result = results[kk % nChannels];
+      result.min = std::min(result.min, mins[kk]);
+      result.max = std::max(result.max, maxes[kk]);
+      result.sumsq += squares[kk];
+   }
+
+   for (auto ii = nSteps * width, nn = nFrames * nChannels; ii < nn; ++ii) {
+      if (ii % nChannels >= nResults)
+         continue;
+      const auto value = samples[ii];
+      auto &result = results[ii % nChannels];
+      result.min = std::min(result.min, value);
+      result.max = std::max(result.max, value);
+      result.sumsq += value * value;
+   }
+}
@@ -0,0 +1,46 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SampleSummary.h
+  @brief Minimum, maximum and sum of squares of runs of samples
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SAMPLE_SUMMARY__
+#define __AUDACITY_SAMPLE_SUMMARY__
+
+#include <cfloat>
+#include <cstddef>
+
+//! What display and the summaries of sample blocks need of a run of samples
+struct MinMaxSumsq
+{
+   //! The summary of no samples, which any other one replaces when combined
+   float min{ FLT_MAX };
+   float max{ -FLT_MAX };
+   float sumsq{ 0.0f };
+};
+
+/*!
+ Minima and maxima are exact.  Sums of squares are accumulated in several
+ partial sums that are added at the end, so they may differ in the last bits
+ from those of a loop adding one square at a time.
+ */
+
+//! Summarize samples
+MATH_API MinMaxSumsq SummarizeSamples(const float *samples, size_t len);
+
+//! Summarize (min, max, rms) triples, as in the summaries of sample blocks
+/*! The result's sumsq is the sum of the squares of the rms values */
+MATH_API MinMaxSumsq SummarizeTriples(const float *triples, size_t count);
+
+//! Summarize the first channels of interleaved samples
+/*!
+ @param results receives the summaries of the first
+ min(nChannels, nResults) channels
+ */
+MATH_API void SummarizeInterleaved(const float *samples,
+   size_t nChannels, size_t nFrames, MinMaxSumsq *results, size_t nResults);
+
+#endif
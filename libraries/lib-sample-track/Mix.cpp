@@ -28,11 +28,20 @@
 #include "float_cast.h"
 #include "Resample.h"
 #include "Prefs.h"
+#include "ThreadPool.h"
 
 #include "Envelope.h"
 #include "SampleTrack.h"
 #include "SampleTrackCache.h"
 
+BoolSetting ParallelMixing{ L"/Performance/ParallelMixing", true };
+
+Mixer::Preferences::Preferences(bool highQuality)
+   : parallel{ ParallelMixing.Read() }
+   , resampleMethod{ Resample::ReadMethod(highQuality) }
+{
+}
+
 Mixer::WarpOptions::WarpOptions(const TrackList &list)
 : envelope(DefaultWarp::Call(list)), minSpeed(0.0), maxSpeed(0.0)
 {
@@ -68,7 +77,8 @@ Mixer::Mixer(const SampleTrackConstArray &inputTracks,
              double startTime, double stopTime,
              unsigned numOutChannels, size_t outBufferSize, bool outInterleaved,
              double outRate, sampleFormat outFormat,
-             bool highQuality, MixerSpec *mixerSpec, bool applyTrackGains)
+             bool highQuality, MixerSpec *mixerSpec, bool applyTrackGains,
+             const Preferences *pPreferences)
    : mNumInputTracks { inputTracks.size() }
 
    , mApplyTrackGains{ applyTrackGains }
@@ -80,7 +90,6 @@ Mixer::Mixer(const SampleTrackConstArray &inputTracks,
    , mSampleQueue{ mNumInputTracks, mQueueMaxLen }
 
    , mNumChannels{ numOutChannels }
-   , mGains{ mNumChannels }
 
    , mFormat{ outFormat }
    , mRate{ outRate }
@@ -88,14 +97,19 @@ Mixer::Mixer(const SampleTrackConstArray &inputTracks,
    , mMayThrow{ mayThrow }
 {
    mHighQuality = highQuality;
+   const auto preferences =
+      pPreferences ? *pPreferences : Preferences{ highQuality };
+   mResampleMethod = preferences.resampleMethod;
    mInputTrack.reinit(mNumInputTracks);
 
    // mSamplePos holds for each track the next sample position not
    // yet processed.
    mSamplePos.reinit(mNumInputTracks);
+   mReadAheadPos.reinit(mNumInputTracks);
    for(size_t i=0; i<mNumInputTracks; i++) {
       mInputTrack[i].SetTrack(inputTracks[i]);
       mSamplePos[i] = inputTracks[i]->TimeToLongSamples(startTime);
+      mReadAheadPos[i] = mSamplePos[i];
    }
    mEnvelope = warpOptions.envelope;
    mT0 = startTime;
@@ -125,8 +139,19 @@ Mixer::Mixer(const SampleTrackConstArray &inputTracks,
       mBuffer[c].Allocate(mInterleavedBufferSize, mFormat);
       mTemp[c].reinit(mInterleavedBufferSize);
    }
-   // PRL:  Bug2536: see other comments below
-   mFloatBuffer = Floats{ mInterleavedBufferSize + 1 };
+   // The time track envelope caches the place of its last search, so the
+   // tracks must share it in turn
+   mParallel = mNumInputTracks > 1 && !mEnvelope &&
+      ThreadPool::Get().GetNumThreads() > 0 && preferences.parallel;
+   const size_t nLanes = mParallel ? mNumInputTracks : 1;
+   mLanes.reinit(nLanes);
+   for (size_t i = 0; i < nLanes; i++) {
+      auto &lane = mLanes[i];
+      // PRL:  Bug2536: see other comments below
+      lane.floatBuffer = Floats{ mInterleavedBufferSize + 1 };
+      lane.gains = Floats{ mNumChannels };
+      lane.channelFlags = ArrayOf<int>{ mNumChannels };
+   }
 
    // But cut the queue into blocks of this finer size
    // for variable rate resampling.  Each block is resampled at some
@@ -166,9 +191,6 @@ Mixer::Mixer(const SampleTrackConstArray &inputTracks,
    }
 
    MakeResamplers();
-
-   const auto envLen = std::max(mQueueMaxLen, mInterleavedBufferSize);
-   mEnvValues.reinit(envLen);
 }
 
 Mixer::~Mixer()
@@ -178,7 +200,8 @@ Mixer::~Mixer()
 void Mixer::MakeResamplers()
 {
    for (size_t i = 0; i < mNumInputTracks; i++)
-      mResample[i] = std::make_unique<Resample>(mHighQuality, mMinFactor[i], mMaxFactor[i]);
+      mResample[i] = std::make_unique<Resample>(
+         mResampleMethod, mMinFactor[i], mMaxFactor[i]);
 }
 
 void Mixer::Clear()
@@ -188,7 +211,8 @@ void Mixer::Clear()
    }
 }
 
-static void MixBuffers(unsigned numChannels, int *channelFlags, float *gains,
+static void MixBuffers(unsigned numChannels, const int *channelFlags,
+                const float *gains,
                 const float *src, Floats *dests,
                 int len, bool interleaved)
 {
@@ -233,9 +257,18 @@ double ComputeWarpFactor(const Envelope &env, double t0, double t1)
    return env.AverageOfInverse(t0, t1);
 }
 
+//! Room for envelope values, for each thread that mixes
+double *EnvValues(size_t len)
+{
+   thread_local std::vector<double> values;
+   if (values.size() < len)
+      values.resize(len);
+   return values.data();
+}
+
 }
 
-size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
+size_t Mixer::MixVariableRates(Lane &lane, SampleTrackCache &cache,
                                     sampleCount *pos, float *queue,
                                     int *queueStart, int *queueLen,
                                     Resample * pResample)
@@ -245,6 +278,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
    const double initialWarp = mRate / mSpeed / trackRate;
    const double tstep = 1.0 / trackRate;
    auto sampleSize = SAMPLE_SIZE(floatSample);
+   const auto envValues = EnvValues(mQueueMaxLen);
 
    decltype(mMaxOut) out = 0;
 
@@ -292,7 +326,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
                else
                   memset(&queue[*queueLen], 0, sizeof(float) * getLen);
 
-               track->GetEnvelopeValues(mEnvValues.get(),
+               track->GetEnvelopeValues(envValues,
                                         getLen,
                                         (*pos - (getLen- 1)).as_double() / trackRate);
                *pos -= getLen;
@@ -304,7 +338,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
                else
                   memset(&queue[*queueLen], 0, sizeof(float) * getLen);
 
-               track->GetEnvelopeValues(mEnvValues.get(),
+               track->GetEnvelopeValues(envValues,
                                         getLen,
                                         (*pos).as_double() / trackRate);
 
@@ -312,7 +346,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
             }
 
             for (decltype(getLen) i = 0; i < getLen; i++) {
-               queue[(*queueLen) + i] *= mEnvValues[i];
+               queue[(*queueLen) + i] *= envValues[i];
             }
 
             if (backwards)
@@ -350,13 +384,13 @@ size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
          thisProcessLen,
          last,
          // PRL:  Bug2536: crash in soxr happened on Mac, sometimes, when
-         // mMaxOut - out == 1 and &mFloatBuffer[out + 1] was an unmapped
+         // mMaxOut - out == 1 and &floatBuffer[out + 1] was an unmapped
          // address, because soxr, strangely, fetched an 8-byte (misaligned!)
-         // value from &mFloatBuffer[out], but did nothing with it anyway,
+         // value from &floatBuffer[out], but did nothing with it anyway,
          // in soxr_output_no_callback.
          // Now we make the bug go away by allocating a little more space in
          // the buffer than we need.
-         &mFloatBuffer[out],
+         &lane.floatBuffer[out],
          mMaxOut - out);
 
       const auto input_used = results.first;
@@ -372,28 +406,21 @@ size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
 
    for (size_t c = 0; c < mNumChannels; c++) {
       if (mApplyTrackGains) {
-         mGains[c] = track->GetChannelGain(c);
+         lane.gains[c] = track->GetChannelGain(c);
       }
       else {
-         mGains[c] = 1.0;
+         lane.gains[c] = 1.0;
       }
    }
 
-   MixBuffers(mNumChannels,
-              channelFlags,
-              mGains.get(),
-              mFloatBuffer.get(),
-              mTemp.get(),
-              out,
-              mInterleaved);
-
    return out;
 }
 
-size_t Mixer::MixSameRate(int *channelFlags, SampleTrackCache &cache,
+size_t Mixer::MixSameRate(Lane &lane, SampleTrackCache &cache,
                                sampleCount *pos)
 {
    const auto track = cache.GetTrack().get();
+   const auto floatBuffer = lane.floatBuffer.get();
    const double t = ( *pos ).as_double() / track->GetRate();
    const double trackEndTime = track->GetEndTime();
    const double trackStartTime = track->GetStartTime();
@@ -413,46 +440,131 @@ size_t Mixer::MixSameRate(int *channelFlags, SampleTrackCache &cache,
       // difference
       sampleCount{ (backwards ? t - tEnd : tEnd - t) * track->GetRate() + 0.5 }
    );
+   const auto envValues = EnvValues(slen);
 
    if (backwards) {
       auto results = cache.GetFloats(*pos - (slen - 1), slen, mMayThrow);
       if (results)
-         memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
+         memcpy(floatBuffer, results, sizeof(float) * slen);
       else
-         memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
-      track->GetEnvelopeValues(mEnvValues.get(), slen, t - (slen - 1) / mRate);
+         memset(floatBuffer, 0, sizeof(float) * slen);
+      track->GetEnvelopeValues(envValues, slen, t - (slen - 1) / mRate);
       for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
-      ReverseSamples((samplePtr)mFloatBuffer.get(), floatSample, 0, slen);
+         floatBuffer[i] *= envValues[i]; // Track gain control will go here?
+      ReverseSamples((samplePtr)floatBuffer, floatSample, 0, slen);
 
       *pos -= slen;
    }
    else {
       auto results = cache.GetFloats(*pos, slen, mMayThrow);
       if (results)
-         memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
+         memcpy(floatBuffer, results, sizeof(float) * slen);
       else
-         memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
-      track->GetEnvelopeValues(mEnvValues.get(), slen, t);
+         memset(floatBuffer, 0, sizeof(float) * slen);
+      track->GetEnvelopeValues(envValues, slen, t);
       for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
+         floatBuffer[i] *= envValues[i]; // Track gain control will go here?
 
       *pos += slen;
    }
 
    for(size_t c=0; c<mNumChannels; c++)
       if (mApplyTrackGains)
-         mGains[c] = track->GetChannelGain(c);
+         lane.gains[c] = track->GetChannelGain(c);
       else
-         mGains[c] = 1.0;
-
-   MixBuffers(mNumChannels, channelFlags, mGains.get(),
-              mFloatBuffer.get(), mTemp.get(), slen, mInterleaved);
+         lane.gains[c] = 1.0;
 
    return slen;
 }
 
-size_t Mixer::Process(size_t maxToProcess)
+namespace {
+//! How far beyond the mixing position to read ahead
+constexpr double ReadAheadSeconds = 4.0;
+}
+
+void Mixer::RequestReadAhead(size_t iTrack)
+{
+   if (!ReadAhead::Get())
+      return;
+
+   // Ask again only after half of the previous window is consumed
+   const auto pos = mSamplePos[iTrack];
+   auto &next = mReadAheadPos[iTrack];
+   const bool backwards = (mT1 < mT0);
+   if (backwards ? pos > next : pos < next)
+      return;
+
+   const auto &track = *mInputTrack[iTrack].GetTrack();
+   const sampleCount window{ ReadAheadSeconds * track.GetRate() };
+   if (backwards) {
+      ReadAhead::Call(track, pos - window, window);
+      next = pos - window / 2;
+   }
+   else {
+      ReadAhead::Call(track, pos, window);
+      next = pos + window / 2;
+   }
+}
+
+void Mixer::MixTrack(size_t i, Lane &lane)
+{
+   const auto track = mInputTrack[i].GetTrack().get();
+   const auto channelFlags = lane.channelFlags.get();
+   for(size_t j=0; j<mNumChannels; j++)
+      channelFlags[j] = 0;
+
+   if( mMixerSpec ) {
+      //ignore left and right when downmixing is not required
+      for(size_t j = 0; j < mNumChannels; j++ )
+         channelFlags[ j ] = mMixerSpec->mMap[ i ][ j ] ? 1 : 0;
+   }
+   else {
+      switch(track->GetChannel()) {
+      case Track::MonoChannel:
+      default:
+         for(size_t j=0; j<mNumChannels; j++)
+            channelFlags[j] = 1;
+         break;
+      case Track::LeftChannel:
+         channelFlags[0] = 1;
+         break;
+      case Track::RightChannel:
+         if (mNumChannels >= 2)
+            channelFlags[1] = 1;
+         else
+            channelFlags[0] = 1;
+         break;
+      }
+   }
+   if (mbVariableRates || track->GetRate() != mRate)
+      lane.out = MixVariableRates(lane, mInputTrack[i],
+         &mSamplePos[i], mSampleQueue[i].get(),
+         &mQueueStart[i], &mQueueLen[i], mResample[i].get());
+   else
+      lane.out = MixSameRate(lane, mInputTrack[i], &mSamplePos[i]);
+}
+
+size_t Mixer::AccumulateTrack(size_t i, const Lane &lane)
+{
+   const auto track = mInputTrack[i].GetTrack().get();
+
+   MixBuffers(mNumChannels, lane.channelFlags.get(), lane.gains.get(),
+              lane.floatBuffer.get(), mTemp.get(), lane.out, mInterleaved);
+
+   RequestReadAhead(i);
+
+   double t = mSamplePos[i].as_double() / (double)track->GetRate();
+   if (mT0 > mT1)
+      // backwards (as possibly in scrubbing)
+      mTime = std::max(std::min(t, mTime), mT1);
+   else
+      // forwards (the usual)
+      mTime = std::min(std::max(t, mTime), mT1);
+
+   return lane.out;
+}
+
+size_t Mixer::MixAll(size_t maxToProcess)
 {
    // MB: this is wrong! mT represented warped time, and mTime is too inaccurate to use
    // it here. It's also unnecessary I think.
@@ -460,56 +572,31 @@ size_t Mixer::Process(size_t maxToProcess)
    //   return 0;
 
    decltype(Process(0)) maxOut = 0;
-   ArrayOf<int> channelFlags{ mNumChannels };
 
    mMaxOut = maxToProcess;
 
    Clear();
-   for(size_t i=0; i<mNumInputTracks; i++) {
-      const auto track = mInputTrack[i].GetTrack().get();
-      for(size_t j=0; j<mNumChannels; j++)
-         channelFlags[j] = 0;
-
-      if( mMixerSpec ) {
-         //ignore left and right when downmixing is not required
-         for(size_t j = 0; j < mNumChannels; j++ )
-            channelFlags[ j ] = mMixerSpec->mMap[ i ][ j ] ? 1 : 0;
-      }
-      else {
-         switch(track->GetChannel()) {
-         case Track::MonoChannel:
-         default:
-            for(size_t j=0; j<mNumChannels; j++)
-               channelFlags[j] = 1;
-            break;
-         case Track::LeftChannel:
-            channelFlags[0] = 1;
-            break;
-         case Track::RightChannel:
-            if (mNumChannels >= 2)
-               channelFlags[1] = 1;
-            else
-               channelFlags[0] = 1;
-            break;
-         }
+   if (mParallel) {
+      // Each track touches only its own lane and state...
+      ThreadPool::Get().ParallelFor(mNumInputTracks,
+         [this](size_t i){ MixTrack(i, mLanes[i]); });
+      // ... and then the sums are formed in the same order as when serial,
+      // so that the result is the same to the bit
+      for(size_t i=0; i<mNumInputTracks; i++)
+         maxOut = std::max(maxOut, AccumulateTrack(i, mLanes[i]));
+   }
+   else {
+      for(size_t i=0; i<mNumInputTracks; i++) {
+         MixTrack(i, mLanes[0]);
+         maxOut = std::max(maxOut, AccumulateTrack(i, mLanes[0]));
       }
-      if (mbVariableRates || track->GetRate() != mRate)
-         maxOut = std::max(maxOut,
-            MixVariableRates(channelFlags.get(), mInputTrack[i],
-               &mSamplePos[i], mSampleQueue[i].get(),
-               &mQueueStart[i], &mQueueLen[i], mResample[i].get()));
-      else
-         maxOut = std::max(maxOut,
-            MixSameRate(channelFlags.get(), mInputTrack[i], &mSamplePos[i]));
-
-      double t = mSamplePos[i].as_double() / (double)track->GetRate();
-      if (mT0 > mT1)
-         // backwards (as possibly in scrubbing)
-         mTime = std::max(std::min(t, mTime), mT1);
-      else
-         // forwards (the usual)
-         mTime = std::min(std::max(t, mTime), mT1);
    }
+   return maxOut;
+}
+
+size_t Mixer::Process(size_t maxToProcess)
+{
+   const auto maxOut = MixAll(maxToProcess);
    if(mInterleaved) {
       for(size_t c=0; c<mNumChannels; c++) {
          CopySamples((constSamplePtr)(mTemp[0].get() + c),
@@ -538,6 +625,24 @@ size_t Mixer::Process(size_t maxToProcess)
    return maxOut;
 }
 
+size_t Mixer::Process(size_t maxToProcess,
+   const samplePtr first[], size_t firstLength, const samplePtr second[])
+{
+   wxASSERT(!mInterleaved);
+   const auto maxOut = MixAll(maxToProcess);
+   const auto firstOut = std::min(maxOut, firstLength);
+   const auto ditherType = mHighQuality ? gHighQualityDither : gLowQualityDither;
+   for(size_t c=0; c<mNumBuffers; c++) {
+      const auto src = mTemp[c].get();
+      CopySamples((constSamplePtr)src, floatSample,
+         first[c], mFormat, firstOut, ditherType);
+      if (maxOut > firstOut)
+         CopySamples((constSamplePtr)(src + firstOut), floatSample,
+            second[c], mFormat, maxOut - firstOut, ditherType);
+   }
+   return maxOut;
+}
+
 constSamplePtr Mixer::GetBuffer()
 {
    return mBuffer[0].ptr();
@@ -557,8 +662,10 @@ void Mixer::Restart()
 {
    mTime = mT0;
 
-   for(size_t i=0; i<mNumInputTracks; i++)
+   for(size_t i=0; i<mNumInputTracks; i++) {
       mSamplePos[i] = mInputTrack[i].GetTrack()->TimeToLongSamples(mT0);
+      mReadAheadPos[i] = mSamplePos[i];
+   }
 
    for(size_t i=0; i<mNumInputTracks; i++) {
       mQueueStart[i] = 0;
@@ -582,6 +689,7 @@ void Mixer::Reposition(double t, bool bSkipping)
 
    for(size_t i=0; i<mNumInputTracks; i++) {
       mSamplePos[i] = mInputTrack[i].GetTrack()->TimeToLongSamples(mTime);
+      mReadAheadPos[i] = mSamplePos[i];
       mQueueStart[i] = 0;
       mQueueLen[i] = 0;
    }
@@ -21,11 +21,12 @@
 #define __AUDACITY_MIX__
 
 #include "GlobalVariable.h"
+#include "SampleCount.h"
 #include "SampleFormat.h"
 #include <functional>
 #include <vector>
 
-class sampleCount;
+class BoolSetting;
 class Resample;
 class BoundedEnvelope;
 class TrackList;
@@ -33,6 +34,9 @@ class SampleTrack;
 using SampleTrackConstArray = std::vector < std::shared_ptr < const SampleTrack > >;
 class SampleTrackCache;
 
+//! Whether Mixer may process its tracks concurrently
+extern SAMPLE_TRACK_API BoolSetting ParallelMixing;
+
 class SAMPLE_TRACK_API MixerSpec
 {
    unsigned mNumTracks, mNumChannels, mMaxNumChannels;
@@ -82,6 +86,25 @@ class SAMPLE_TRACK_API Mixer {
        double minSpeed, maxSpeed;
     };
 
+   //! The preferences a mixer uses, which only the main thread may read
+   struct SAMPLE_TRACK_API Preferences
+   {
+      //! Read them now; main thread only
+      /*! @param highQuality as for the mixers that will use them */
+      explicit Preferences(bool highQuality = true);
+
+      //! ParallelMixing
+      bool parallel;
+      //! Resample::ReadMethod()
+      int resampleMethod;
+   };
+
+   //! Hook function informed of the samples of a track that will be needed
+   //! soon, so that they might be read ahead; called from the mixing thread
+   struct SAMPLE_TRACK_API ReadAhead : GlobalHook<ReadAhead,
+      void(const SampleTrack &track, sampleCount start, sampleCount len)
+   >{};
+
     //
    // Constructor / Destructor
    //
@@ -92,7 +115,10 @@ class SAMPLE_TRACK_API Mixer {
          unsigned numOutChannels, size_t outBufferSize, bool outInterleaved,
          double outRate, sampleFormat outFormat,
          bool highQuality = true, MixerSpec *mixerSpec = nullptr,
-         bool applytTrackGains = true);
+         bool applytTrackGains = true,
+         //! If null, preferences are read, so the mixer must be made in the
+         //! main thread
+         const Preferences *pPreferences = nullptr);
 
    virtual ~ Mixer();
 
@@ -106,6 +132,14 @@ class SAMPLE_TRACK_API Mixer {
    /// more samples that must be processed.
    size_t Process(size_t maxSamples);
 
+   /// Process as above, but write the output, which must not be
+   /// interleaved, to the given places instead of the buffers of
+   /// GetBuffer().  The first firstLength samples of channel c go to
+   /// first[c], and any more to second[c], so that a region of a ring
+   /// buffer that wraps around can be filled without another copy.
+   size_t Process(size_t maxSamples,
+      const samplePtr first[], size_t firstLength, const samplePtr second[]);
+
    /// Restart processing at beginning of buffer next time
    /// Process() is called.
    void Restart();
@@ -131,17 +165,34 @@ class SAMPLE_TRACK_API Mixer {
 
  private:
 
+   //! Output of one track, with envelope and gains found, not yet mixed
+   struct Lane {
+      Floats floatBuffer;
+      Floats gains;
+      ArrayOf<int> channelFlags;
+      size_t out{ 0 };
+   };
+
    void Clear();
-   size_t MixSameRate(int *channelFlags, SampleTrackCache &cache,
+   size_t MixSameRate(Lane &lane, SampleTrackCache &cache,
                            sampleCount *pos);
 
-   size_t MixVariableRates(int *channelFlags, SampleTrackCache &cache,
+   size_t MixVariableRates(Lane &lane, SampleTrackCache &cache,
                                 sampleCount *pos, float *queue,
                                 int *queueStart, int *queueLen,
                                 Resample * pResample);
 
+   //! Fill the lane from one track; may run concurrently for other tracks
+   void MixTrack(size_t iTrack, Lane &lane);
+   //! Add the lane into the output and advance the time; always serial
+   size_t AccumulateTrack(size_t iTrack, const Lane &lane);
+   //! Mix all tracks into mTemp
+   size_t MixAll(size_t maxSamples);
+
    void MakeResamplers();
 
+   void RequestReadAhead(size_t iTrack);
+
  private:
 
     // Input
@@ -150,8 +201,9 @@ class SAMPLE_TRACK_API Mixer {
    bool             mbVariableRates;
    const BoundedEnvelope *mEnvelope;
    ArrayOf<sampleCount> mSamplePos;
+   //! For each track, the position at which to request more read-ahead
+   ArrayOf<sampleCount> mReadAheadPos;
    const bool       mApplyTrackGains;
-   Doubles          mEnvValues;
    double           mT0; // Start time
    double           mT1; // Stop time (none if mT0==mT1)
    double           mTime;  // Current time (renamed from mT to mTime for consistency with AudioIO - mT represented warped time there)
@@ -166,7 +218,6 @@ class SAMPLE_TRACK_API Mixer {
    // Output
    size_t              mMaxOut;
    const unsigned   mNumChannels;
-   Floats           mGains;
    unsigned         mNumBuffers;
    size_t              mBufferSize;
    size_t              mInterleavedBufferSize;
@@ -174,10 +225,13 @@ class SAMPLE_TRACK_API Mixer {
    bool             mInterleaved;
    ArrayOf<SampleBuffer> mBuffer;
    ArrayOf<Floats>  mTemp;
-   Floats           mFloatBuffer;
+   //! One per track when mixing in parallel, else only one
+   ArrayOf<Lane>    mLanes;
+   bool             mParallel;
    const double     mRate;
    double           mSpeed;
    bool             mHighQuality;
+   int              mResampleMethod;
    std::vector<double> mMinFactor, mMaxFactor;
 
    const bool       mMayThrow;
@@ -83,6 +83,11 @@ public:
 
    virtual ~Envelope();
 
+   //! Whether a copy of one would be a copy of the other
+   bool operator == (const Envelope &other) const;
+   bool operator != (const Envelope &other) const
+      { return !(*this == other); }
+
    // Return true if violations of point ordering invariants were detected
    // and repaired
    bool ConsistencyCheck();
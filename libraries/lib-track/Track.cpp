@@ -108,8 +108,16 @@ void Track::Merge(const Track &orig)
 Track::Holder Track::Duplicate() const
 {
    // invoke "virtual constructor" to copy track object proper:
-   auto result = Clone();
+   return WithAttachments(Clone());
+}
+
+Track::Holder Track::DuplicateForUndo(const Track *pPrevious) const
+{
+   return WithAttachments(pPrevious ? CloneForUndo(*pPrevious) : Clone());
+}
 
+Track::Holder Track::WithAttachments(Holder result) const
+{
    AttachedTrackObjects::ForEach([&](auto &attachment){
       // Copy view state that might be important to undo/redo
       attachment.CopyTo( *result );
@@ -118,6 +126,11 @@ Track::Holder Track::Duplicate() const
    return result;
 }
 
+Track::Holder Track::CloneForUndo(const Track &) const
+{
+   return Clone();
+}
+
 Track::~Track()
 {
 }
@@ -419,6 +419,15 @@ private:
    // public nonvirtual duplication function that invokes Clone():
    virtual Holder Duplicate() const;
 
+   //! Like Duplicate(), for a state of undo history
+   /*!
+    @param pPrevious if not null, the copy of this track in an earlier state,
+    with which the result may share contents that did not change since; so
+    neither of them may be modified afterward, unless the other is first
+    discarded
+    */
+   Holder DuplicateForUndo(const Track *pPrevious) const;
+
    // Called when this track is merged to stereo with another, and should
    // take on some parameters of its partner.
    virtual void Merge(const Track &orig);
@@ -479,6 +488,14 @@ private:
    // the track data proper (not associated data such as for groups and views):
    virtual Holder Clone() const = 0;
 
+   //! Like Clone(), but may share contents of previous, another copy of
+   //! the same track; default just calls Clone()
+   virtual Holder CloneForUndo(const Track &previous) const;
+
+   //! Copy the attached objects to the copy of this track proper, completing
+   //! Duplicate() or DuplicateForUndo()
+   Holder WithAttachments(Holder result) const;
+
    template<typename T>
       friend std::enable_if_t< std::is_pointer_v<T>, T >
          track_cast(Track *track);
@@ -0,0 +1,143 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file ThreadPool.cpp
+
+**********************************************************************/
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+ThreadPool &ThreadPool::Get()
+{
+   static ThreadPool instance{
+      std::max(1u, std::thread::hardware_concurrency()) - 1 };
+   return instance;
+}
+
+ThreadPool::ThreadPool(size_t nThreads)
+{
+   mThreads.reserve(nThreads);
+   for (size_t ii = 0; ii < nThreads; ++ii)
+      mThreads.emplace_back([this]{ Work(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+   {
+      std::lock_guard<std::mutex> guard(mMutex);
+      mStop = true;
+      mWake.notify_all();
+   }
+   for (auto &thread : mThreads)
+      thread.join();
+}
+
+namespace {
+//! Shared by the threads taking part in one ParallelFor
+struct ForState {
+   ForState(size_t n, const std::function<void(size_t)> &fn)
+      : n{ n }, fn{ fn }
+   {}
+
+   void Run()
+   {
+      while (true) {
+         const auto ii = next.fetch_add(1);
+         if (ii >= n)
+            // fn may be gone already; don't touch it
+            return;
+         try {
+            fn(ii);
+         }
+         catch ( ... ) {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (ii < errorIndex) {
+               errorIndex = ii;
+               error = std::current_exception();
+            }
+         }
+         if (done.fetch_add(1) + 1 == n) {
+            std::lock_guard<std::mutex> guard(mutex);
+            finished.notify_all();
+         }
+      }
+   }
+
+   void Wait()
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      finished.wait(lock, [this]{ return done.load() == n; });
+   }
+
+   const size_t n;
+   const std::function<void(size_t)> &fn;
+   std::atomic<size_t> next{ 0 };
+   std::atomic<size_t> done{ 0 };
+
+   std::mutex mutex;
+   std::condition_variable finished;
+   size_t errorIndex{ n };
+   std::exception_ptr error;
+};
+}
+
+void ThreadPool::ParallelFor(
+   size_t n, const std::function<void(size_t)> &fn)
+{
+   if (n == 0)
+      return;
+
+   // Helpers may start after all items are done, so the state they share
+   // must outlive this call
+   auto pState = std::make_shared<ForState>(n, fn);
+   const auto nHelpers = std::min(n - 1, mThreads.size());
+   if (nHelpers > 0) {
+      std::lock_guard<std::mutex> guard(mMutex);
+      for (size_t ii = 0; ii < nHelpers; ++ii)
+         mTasks.emplace_back([pState]{ pState->Run(); });
+      mWake.notify_all();
+   }
+
+   pState->Run();
+   pState->Wait();
+
+   if (pState->error)
+      std::rethrow_exception(pState->error);
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+   if (mThreads.empty()) {
+      task();
+      return;
+   }
+   std::lock_guard<std::mutex> guard(mMutex);
+   mTasks.push_back(std::move(task));
+   mWake.notify_one();
+}
+
+void ThreadPool::Work()
+{
+   std::unique_lock<std::mutex> lock(mMutex);
+   while (true) {
+      mWake.wait(lock, [this]{ return mStop || !mTasks.empty(); });
+      if (mStop)
+         return;
+
+      auto task = std::move(mTasks.front());
+      mTasks.pop_front();
+      lock.unlock();
+      try {
+         task();
+      }
+      catch ( ... ) {
+      }
+      // Destroy captures before reacquiring the lock
+      task = nullptr;
+      lock.lock();
+   }
+}
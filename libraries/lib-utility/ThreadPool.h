@@ -0,0 +1,77 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file ThreadPool.h
+  @brief A fixed set of worker threads shared by parallel computations
+
+**********************************************************************/
+#ifndef __AUDACITY_THREAD_POOL__
+#define __AUDACITY_THREAD_POOL__
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! Runs tasks on a fixed number of worker threads
+/*!
+ Parallel loops let the calling thread take part in the work, so that a
+ loop started from a worker (or from a pool with no workers) still
+ completes.  Items of a loop are handed out one at a time from a shared
+ counter, so that threads finishing early take more of the remaining
+ items.
+
+ All member functions may be called from any thread.
+ */
+class UTILITY_API ThreadPool final
+{
+public:
+   //! The process-wide pool, with one worker fewer than the hardware threads
+   static ThreadPool &Get();
+
+   explicit ThreadPool(size_t nThreads);
+   ~ThreadPool();
+   ThreadPool(const ThreadPool&) = delete;
+   ThreadPool &operator=(const ThreadPool&) = delete;
+
+   size_t GetNumThreads() const { return mThreads.size(); }
+
+   //! Call fn(ii) for each ii in [0, n), and return when all calls are done
+   /*!
+    Calls may happen in any order and concurrently.  If any of them throw,
+    all of the others still complete, then the exception from the least
+    index is rethrown, so that the outcome does not depend on scheduling.
+    */
+   void ParallelFor(size_t n, const std::function<void(size_t)> &fn);
+
+   //! Queue a task for some worker; exceptions escaping it are lost
+   void Submit(std::function<void()> task);
+
+   //! Queue a task, and get its result or exception from the future
+   template<typename F> auto Async(F &&f) -> std::future<decltype(f())>
+   {
+      using Result = decltype(f());
+      auto pTask = std::make_shared<std::packaged_task<Result()>>(
+         std::forward<F>(f));
+      auto result = pTask->get_future();
+      Submit([pTask]{ (*pTask)(); });
+      return result;
+   }
+
+private:
+   void Work();
+
+   std::mutex mMutex;
+   std::condition_variable mWake;
+   std::deque<std::function<void()>> mTasks;
+   std::vector<std::thread> mThreads;
+   bool mStop{ false };
+};
+
+#endif
@@ -100,6 +100,7 @@ time warp info and AudioIOListener and whether the playback is looped.
 
 #include "Meter.h"
 #include "Mix.h"
+#include "RealtimeChecks.h"
 #include "RingBuffer.h"
 #include "Decibels.h"
 #include "Project.h"
@@ -139,13 +140,16 @@ AudioIO *AudioIO::Get()
 struct AudioIoCallback::TransportState {
    TransportState(std::weak_ptr<TenacityProject> wOwningProject,
       const WaveTrackArray &playbackTracks,
-      unsigned numPlaybackChannels, double rate)
+      unsigned numPlaybackChannels, double rate, size_t blockSize)
    {
       if (auto pOwningProject = wOwningProject.lock();
           pOwningProject && numPlaybackChannels > 0) {
+         mpOwningProject = move(pOwningProject);
+         mpRealtimeManager = &RealtimeEffectManager::Get(*mpOwningProject);
          // Setup for realtime playback at the rate of the realtime
          // stream, not the rate of the track.
-         mpRealtimeInitialization.emplace(move(wOwningProject), rate);
+         mpRealtimeInitialization.emplace(
+            move(wOwningProject), rate, blockSize);
          // The following adds a new effect processor for each logical track.
          for (size_t i = 0, cnt = playbackTracks.size(); i < cnt;) {
             auto vt = playbackTracks[i].get();
@@ -157,6 +161,11 @@ struct AudioIoCallback::TransportState {
       }
    }
 
+   //! Keeps the project, and so the effects, alive while the stream runs
+   /*! Taken and released in the main thread, so that the audio thread
+    neither locks it nor can be the one to destroy it */
+   std::shared_ptr<TenacityProject> mpOwningProject;
+   RealtimeEffectManager *mpRealtimeManager{};
    std::optional<RealtimeEffects::InitializationScope> mpRealtimeInitialization;
 };
 
@@ -206,6 +215,11 @@ void StartAudioIOThread()
       }
       gAudioIO->mAudioThreadTrackBufferExchangeLoopActive = false;
 
+      // Notify for the callback, which must not allocate
+      if (gAudioIO->mSoundActivationChanged.exchange(false))
+         if (auto pListener = gAudioIO->GetListener())
+            pListener->OnSoundActivationThreshold();
+
       std::this_thread::sleep_until(loopPassStart + interval);
    }
 }
@@ -584,6 +598,7 @@ int AudioIO::StartStream(const TransportTracks &tracks,
 {
    mLostSamples = 0;
    mLostCaptureIntervals.clear();
+   mLostCaptureIntervals.reserve(MaxLostCaptureIntervals);
    mDetectDropouts =
       gPrefs->Read( WarningDialogKey(wxT("DropoutDetected")), true ) != 0;
    auto cleanup = finally ( [this] { ClearRecordingException(); } );
@@ -671,9 +686,9 @@ int AudioIO::StartStream(const TransportTracks &tracks,
       }
    });
 
-   mPlaybackBuffers.reset();
+   mPlaybackBuffer.reset();
    mPlaybackMixers.clear();
-   mCaptureBuffers.reset();
+   mCaptureBuffer.reset();
    mResample.reset();
    mPlaybackSchedule.mTimeQueue.mData.reset();
 
@@ -744,7 +759,8 @@ int AudioIO::StartStream(const TransportTracks &tracks,
       return 0;
 
    mpTransportState = std::make_unique<TransportState>( mOwningProject,
-      mPlaybackTracks, mNumPlaybackChannels, mRate);
+      mPlaybackTracks, mNumPlaybackChannels, mRate,
+      GetConvertedLatencyPreference());
 
    if (options.pStartTime)
    {
@@ -942,12 +958,13 @@ bool AudioIO::AllocateBuffers(
       {
          if( mNumPlaybackChannels > 0 ) {
             // Allocate output buffers.  For every output track we allocate
-            // a ring buffer of ten seconds
+            // a channel of a ring buffer of ten seconds
             auto playbackBufferSize =
                (size_t)lrint(mRate * mPlaybackRingBufferSecs);
 
-            // Always make at least one playback buffer
-            mPlaybackBuffers.reinit(
+            // Always make at least one playback channel
+            mPlaybackBuffer = std::make_unique<RingBuffer>(floatSample,
+               playbackBufferSize,
                std::max<size_t>(1, mPlaybackTracks.size()));
             mPlaybackMixers.clear();
             mPlaybackMixers.resize(mPlaybackTracks.size());
@@ -959,20 +976,12 @@ bool AudioIO::AllocateBuffers(
             mPlaybackQueueMinimum =
                std::min( mPlaybackQueueMinimum, playbackBufferSize );
 
-            if (mPlaybackTracks.empty())
-               // Make at least one playback buffer
-               mPlaybackBuffers[0] =
-                  std::make_unique<RingBuffer>(floatSample, playbackBufferSize);
-
             for (unsigned int i = 0; i < mPlaybackTracks.size(); i++)
             {
                // Bug 1763 - We must fade in from zero to avoid a click on starting.
                mPlaybackTracks[i]->SetOldChannelGain(0, 0.0);
                mPlaybackTracks[i]->SetOldChannelGain(1, 0.0);
 
-               mPlaybackBuffers[i] =
-                  std::make_unique<RingBuffer>(floatSample, playbackBufferSize);
-
                // use track time for the end time, not real time!
                SampleTrackConstArray mixTracks;
                mixTracks.push_back(mPlaybackTracks[i]);
@@ -1015,7 +1024,7 @@ bool AudioIO::AllocateBuffers(
          if( mNumCaptureChannels > 0 )
          {
             // Allocate input buffers.  For every input track we allocate
-            // a ring buffer of five seconds
+            // a channel of a ring buffer of five seconds
             auto captureBufferSize =
                (size_t)(mRate * mCaptureRingBufferSecs + 0.5);
 
@@ -1026,14 +1035,20 @@ bool AudioIO::AllocateBuffers(
                throw std::bad_alloc();
             }
 
-            mCaptureBuffers.reinit(mCaptureTracks.size());
+            // Store samples in the widest of the tracks' formats; narrowing
+            // later for the other tracks, without dither, gives the same
+            // results as narrowing when storing
+            auto captureFormat = narrowestSampleFormat;
+            for (const auto &track : mCaptureTracks)
+               captureFormat =
+                  std::max(captureFormat, track->GetSampleFormat());
+            mCaptureBuffer = std::make_unique<RingBuffer>(
+               captureFormat, captureBufferSize, mCaptureTracks.size() );
             mResample.reinit(mCaptureTracks.size());
             mFactor = sampleRate / mRate;
 
             for( unsigned int i = 0; i < mCaptureTracks.size(); i++ )
             {
-               mCaptureBuffers[i] = std::make_unique<RingBuffer>(
-                  mCaptureTracks[i]->GetSampleFormat(), captureBufferSize );
                mResample[i] =
                   std::make_unique<Resample>(true, mFactor, mFactor);
                   // constant rate resampling
@@ -1070,9 +1085,9 @@ void AudioIO::StartStreamCleanup(bool bOnlyBuffers)
 {
    mpTransportState.reset();
 
-   mPlaybackBuffers.reset();
+   mPlaybackBuffer.reset();
    mPlaybackMixers.clear();
-   mCaptureBuffers.reset();
+   mCaptureBuffer.reset();
    mResample.reset();
    mPlaybackSchedule.mTimeQueue.mData.reset();
 
@@ -1183,6 +1198,9 @@ void AudioIO::StopStream()
       mPortStreamV19 = NULL;
    }
 
+   // The callback is finished; show anything it did that might wait
+   RealtimeChecks::Report();
+
    // No longer need effects processing. This must be done after the stream is stopped
    // to prevent the callback from being invoked after the effects are finalized.
    mpTransportState.reset();
@@ -1217,7 +1235,7 @@ void AudioIO::StopStream()
 
       if (mPlaybackTracks.size() > 0)
       {
-         mPlaybackBuffers.reset();
+         mPlaybackBuffer.reset();
          mPlaybackMixers.clear();
          mPlaybackSchedule.mTimeQueue.mData.reset();
       }
@@ -1227,7 +1245,7 @@ void AudioIO::StopStream()
       //
       if (mCaptureTracks.size() > 0)
       {
-         mCaptureBuffers.reset();
+         mCaptureBuffer.reset();
          mResample.reset();
 
          //
@@ -1455,10 +1473,7 @@ double AudioIO::GetStreamTime()
 
 size_t AudioIO::GetCommonlyFreePlayback()
 {
-   auto commonlyAvail = mPlaybackBuffers[0]->AvailForPut();
-   for (unsigned i = 1; i < mPlaybackTracks.size(); ++i)
-      commonlyAvail = std::min(commonlyAvail,
-         mPlaybackBuffers[i]->AvailForPut());
+   auto commonlyAvail = mPlaybackBuffer->AvailForPut();
    // MB: subtract a few samples because the code in TrackBufferExchange has rounding
    // errors
    return commonlyAvail - std::min(size_t(10), commonlyAvail);
@@ -1466,20 +1481,12 @@ size_t AudioIO::GetCommonlyFreePlayback()
 
 size_t AudioIoCallback::GetCommonlyReadyPlayback()
 {
-   auto commonlyAvail = mPlaybackBuffers[0]->AvailForGet();
-   for (unsigned i = 1; i < mPlaybackTracks.size(); ++i)
-      commonlyAvail = std::min(commonlyAvail,
-         mPlaybackBuffers[i]->AvailForGet());
-   return commonlyAvail;
+   return mPlaybackBuffer->AvailForGet();
 }
 
 size_t AudioIO::GetCommonlyAvailCapture()
 {
-   auto commonlyAvail = mCaptureBuffers[0]->AvailForGet();
-   for (unsigned i = 1; i < mCaptureTracks.size(); ++i)
-      commonlyAvail = std::min(commonlyAvail,
-         mCaptureBuffers[i]->AvailForGet());
-   return commonlyAvail;
+   return mCaptureBuffer->AvailForGet();
 }
 
 // This method is the data gateway between the audio thread (which
@@ -1496,11 +1503,8 @@ void AudioIO::FillPlayBuffers()
    if (mNumPlaybackChannels == 0)
       return;
 
-   // Though extremely unlikely, it is possible that some buffers
-   // will have more samples available than others.  This could happen
-   // if we hit this code during the PortAudio callback.  To keep
-   // things simple, we only write as much data as is vacant in
-   // ALL buffers, and advance the global time by that much.
+   // All channels of the ring buffer have the same vacancy, and we
+   // advance the global time by as much as we write to them.
    auto nAvailable = GetCommonlyFreePlayback();
 
    // Don't fill the buffers at all unless we can do the
@@ -1545,6 +1549,10 @@ void AudioIO::FillPlayBuffers()
       mPlaybackSchedule.mTimeQueue.Producer( mPlaybackSchedule, mRate,
          frames);
 
+      const auto region = mPlaybackBuffer->GetWritable(frames);
+      // wxASSERT(region.Length() == frames);
+      // but we can't assert in this thread
+
       for (size_t i = 0; i < mPlaybackTracks.size(); i++)
       {
          // The mixer here isn't actually mixing: it's just doing
@@ -1553,20 +1561,27 @@ void AudioIO::FillPlayBuffers()
          if (frames > 0)
          {
             size_t produced = 0;
-            if ( toProduce )
-               produced = mPlaybackMixers[i]->Process( toProduce );
+            if ( toProduce ) {
+               // The mixer writes directly into the ring buffer
+               const samplePtr first[]{
+                  mPlaybackBuffer->GetPtr(i, region.first.start) };
+               const samplePtr second[]{
+                  mPlaybackBuffer->GetPtr(i, region.second.start) };
+               produced = mPlaybackMixers[i]->Process(
+                  std::min( toProduce, region.Length() ),
+                  first, region.first.length, second );
+            }
             //wxASSERT(produced <= toProduce);
-            auto warpedSamples = mPlaybackMixers[i]->GetBuffer();
-            /* const auto put = */ mPlaybackBuffers[i]->Put(
-               warpedSamples, floatSample, produced, frames - produced);
-            // wxASSERT(put == frames);
-            // but we can't assert in this thread
+            // Pad with zeroes
+            mPlaybackBuffer->Clear(i, region.After(produced));
          }
       }
 
       if (mPlaybackTracks.empty())
-         // Produce silence in the single ring buffer
-         mPlaybackBuffers[0]->Put(nullptr, floatSample, 0, frames);
+         // Produce silence in the single channel
+         mPlaybackBuffer->Clear(0, region);
+
+      mPlaybackBuffer->CommitPut(region.Length());
 
       available -= frames;
       // wxASSERT(available >= 0); // don't assert on this thread
@@ -1627,38 +1642,40 @@ void AudioIO::DrainRecordBuffers()
          // The WaveTracks have their own buffering for efficiency.
          auto numChannels = mCaptureTracks.size();
 
+         size_t discarded = 0;
+         const auto correction = mRecordingSchedule.TotalCorrection();
+         if (!mRecordingSchedule.mLatencyCorrected && correction < 0) {
+            // Leftward shift
+            // discard some samples from all channels of the ring buffer.
+            size_t size = floor(
+               mRecordingSchedule.ToDiscard() * mRate );
+
+            // The ring buffer might have grown concurrently -- don't discard more
+            // than the "avail" value noted above.
+            discarded = mCaptureBuffer->Discard(std::min(avail, size));
+
+            if (discarded < size)
+               // We need to visit this again to complete the
+               // discarding.
+               latencyCorrected = false;
+         }
+
+         wxASSERT(discarded <= avail);
+         const auto region = mCaptureBuffer->GetReadable(avail - discarded);
+         const auto ringFormat = mCaptureBuffer->Format();
+
          for( size_t i = 0; i < numChannels; i++ )
          {
             sampleFormat trackFormat = mCaptureTracks[i]->GetSampleFormat();
 
-            size_t discarded = 0;
-
-            if (!mRecordingSchedule.mLatencyCorrected) {
-               const auto correction = mRecordingSchedule.TotalCorrection();
-               if (correction >= 0) {
-                  // Rightward shift
-                  // Once only (per track per recording), insert some initial
-                  // silence.
-                  size_t size = floor( correction * mRate * mFactor);
-                  SampleBuffer temp(size, trackFormat);
-                  ClearSamples(temp.ptr(), trackFormat, 0, size);
-                  mCaptureTracks[i]->Append(temp.ptr(), trackFormat, size, 1);
-               }
-               else {
-                  // Leftward shift
-                  // discard some samples from the ring buffers.
-                  size_t size = floor(
-                     mRecordingSchedule.ToDiscard() * mRate );
-
-                  // The ring buffer might have grown concurrently -- don't discard more
-                  // than the "avail" value noted above.
-                  discarded = mCaptureBuffers[i]->Discard(std::min(avail, size));
-
-                  if (discarded < size)
-                     // We need to visit this again to complete the
-                     // discarding.
-                     latencyCorrected = false;
-               }
+            if (!mRecordingSchedule.mLatencyCorrected && correction >= 0) {
+               // Rightward shift
+               // Once only (per track per recording), insert some initial
+               // silence.
+               size_t size = floor( correction * mRate * mFactor);
+               SampleBuffer temp(size, trackFormat);
+               ClearSamples(temp.ptr(), trackFormat, 0, size);
+               mCaptureTracks[i]->Append(temp.ptr(), trackFormat, size, 1);
             }
 
             const float *pCrossfadeSrc = nullptr;
@@ -1677,9 +1694,16 @@ void AudioIO::DrainRecordBuffers()
                }
             }
 
-            wxASSERT(discarded <= avail);
-            size_t toGet = avail - discarded;
+            size_t toGet = region.Length();
+            // Use the samples in the ring buffer in place when possible;
+            // the reader may modify them until it commits
+            const auto inPlace = [&](sampleFormat format){
+               return format == ringFormat && region.Contiguous()
+                  ? mCaptureBuffer->GetPtr(i, region.first.start)
+                  : nullptr;
+            };
             SampleBuffer temp;
+            samplePtr samples;
             size_t size;
             sampleFormat format;
             if( mFactor == 1.0 )
@@ -1691,11 +1715,12 @@ void AudioIO::DrainRecordBuffers()
                   format = floatSample;
                else
                   format = trackFormat;
-               temp.Allocate(size, format);
-               // const auto got =
-                  mCaptureBuffers[i]->Get(temp.ptr(), format, toGet);
-               // wxASSERT(got == toGet);
-               // but we can't assert in this thread
+               samples = inPlace(format);
+               if (!samples) {
+                  temp.Allocate(size, format);
+                  mCaptureBuffer->Read(i, region, temp.ptr(), format);
+                  samples = temp.ptr();
+               }
                if (double(size) > remainingSamples)
                   size = floor(remainingSamples);
             }
@@ -1703,12 +1728,15 @@ void AudioIO::DrainRecordBuffers()
             {
                size = lrint(toGet * mFactor);
                format = floatSample;
-               SampleBuffer temp1(toGet, floatSample);
+               SampleBuffer temp1;
+               auto input = inPlace(floatSample);
+               if (!input) {
+                  temp1.Allocate(toGet, floatSample);
+                  mCaptureBuffer->Read(i, region, temp1.ptr(), floatSample);
+                  input = temp1.ptr();
+               }
                temp.Allocate(size, format);
-               // const auto got =
-                  mCaptureBuffers[i]->Get(temp1.ptr(), floatSample, toGet);
-               // wxASSERT(got == toGet);
-               // but we can't assert in this thread
+               samples = temp.ptr();
                /* we are re-sampling on the fly. The last resampling call
                 * must flush any samples left in the rate conversion buffer
                 * so that they get recorded
@@ -1717,8 +1745,8 @@ void AudioIO::DrainRecordBuffers()
                   if (double(toGet) > remainingSamples)
                      toGet = floor(remainingSamples);
                   const auto results =
-                  mResample[i]->Process(mFactor, (float *)temp1.ptr(), toGet,
-                                        !IsStreamActive(), (float *)temp.ptr(), size);
+                  mResample[i]->Process(mFactor, (float *)input, toGet,
+                                        !IsStreamActive(), (float *)samples, size);
                   size = results.second;
                }
             }
@@ -1729,7 +1757,7 @@ void AudioIO::DrainRecordBuffers()
                if (crossfadeLength) {
                   auto ratio = double(crossfadeStart) / totalCrossfadeLength;
                   auto ratioStep = 1.0 / totalCrossfadeLength;
-                  auto pCrossfadeDst = (float*)temp.ptr();
+                  auto pCrossfadeDst = (float*)samples;
 
                   // Crossfade loop here
                   for (size_t ii = 0; ii < crossfadeLength; ++ii) {
@@ -1742,10 +1770,13 @@ void AudioIO::DrainRecordBuffers()
 
             // Now append
             // see comment in second handler about guarantee
-            newBlocks = mCaptureTracks[i]->Append(temp.ptr(), format, size, 1)
+            newBlocks = mCaptureTracks[i]->Append(samples, format, size, 1)
                || newBlocks;
          } // end loop over capture channels
 
+         // Consume from all channels at once
+         mCaptureBuffer->CommitGet(region.Length());
+
          // Now update the recording schedule position
          mRecordingSchedule.mPosition += avail / mRate;
          mRecordingSchedule.mLatencyCorrected = latencyCorrected;
@@ -1842,11 +1873,8 @@ void AudioIoCallback::CheckSoundActivatedRecordingLevel(
 
    bool bShouldBePaused = maxPeak < mSilenceLevel;
    if( bShouldBePaused != IsPaused() )
-   {
-      auto pListener = GetListener();
-      if ( pListener )
-         pListener->OnSoundActivationThreshold();
-   }
+      // The audio thread notifies the listener
+      mSoundActivationChanged.store(true);
 }
 
 // A function to apply the requested gain, fading up or down from the
@@ -1908,12 +1936,14 @@ void AudioIoCallback::UpdateBuffers()
    unsigned long newBufferSize = GetConvertedLatencyPreference();
    auto& memoryManager = AudioMemoryManager::Get();
 
+   // The callback converts the captured samples of all channels here
+   mTemporaryBufferSize = newBufferSize * std::max(1u, channels);
    mTemporaryBuffer.reset();
-   mTemporaryBuffer = memoryManager.GetBuffer(newBufferSize);
+   mTemporaryBuffer = memoryManager.GetBuffer(mTemporaryBufferSize);
    if (!mTemporaryBuffer)
    {
-      memoryManager.CreateBuffer(newBufferSize);
-      mTemporaryBuffer = memoryManager.GetBuffer(newBufferSize);
+      memoryManager.CreateBuffer(mTemporaryBufferSize);
+      mTemporaryBuffer = memoryManager.GetBuffer(mTemporaryBufferSize);
    }
 
    if (mTrackChannelsBuffer.size() < channels)
@@ -1927,6 +1957,7 @@ void AudioIoCallback::UpdateBuffers()
    {
       buffer = mScratchBufferAllocator.Allocate(true, newBufferSize);
    }
+   mChannelPointers = mScratchBuffers;
 
    mBuffersPrepared = true;
 }
@@ -1972,18 +2003,20 @@ bool AudioIoCallback::FillOutputBuffers(
    }
 
    {
-      auto pProject = mOwningProject.lock();
+      // Don't lock mOwningProject here:  the transport state holds the
+      // project for the whole stream
       std::optional<RealtimeEffects::ProcessingScope> pScope;
       if (mpTransportState && mpTransportState->mpRealtimeInitialization)
-         pScope.emplace( *mpTransportState->mpRealtimeInitialization, mOwningProject );
+         pScope.emplace( *mpTransportState->mpRealtimeInitialization,
+            *mpTransportState->mpRealtimeManager );
 
       bool selected = false;
       int group = 0;
       int chanCnt = 0;
 
-      // Choose a common size to take from all ring buffers
-      const auto toGet =
-         std::min<size_t>(framesPerBuffer, GetCommonlyReadyPlayback());
+      // Take a common size from all channels of the ring buffer
+      const auto region = mPlaybackBuffer->GetReadable(framesPerBuffer);
+      const auto toGet = region.Length();
 
       // The drop and dropQuickly booleans are so named for historical reasons.
       // JKC: The original code attempted to be faster by doing nothing on silenced audio.
@@ -2025,6 +2058,7 @@ bool AudioIoCallback::FillOutputBuffers(
                // TODO: more-than-two-channels
                auto buf = mScratchBuffers[1];
                memset(buf, 0, framesPerBuffer * sizeof(float));
+               mChannelPointers[1] = buf;
             }
             drop = TrackShouldBeSilent( *vt );
             dropQuickly = drop;
@@ -2035,29 +2069,31 @@ bool AudioIoCallback::FillOutputBuffers(
             
          decltype(framesPerBuffer) len = 0;
 
+         // All channels are consumed together after the loop
+         len = toGet;
          if (dropQuickly)
          {
-            len = mPlaybackBuffers[t]->Discard(toGet);
             // keep going here.  
             // we may still need to issue a paComplete.
          }
          else
          {
-            len = mPlaybackBuffers[t]->Get((samplePtr)mScratchBuffers[chanCnt],
-                                                      floatSample,
-                                                      toGet);
-            // assert( len == toGet );
-            if (len < framesPerBuffer)
-            {
-               // This used to happen normally at the end of non-looping
-               // plays, but it can also be an anomalous case where the
-               // supply from TrackBufferExchange fails to keep up with the
-               // real-time demand in this thread (see bug 1932).  We
-               // must supply something to the sound card, so pad it with
-               // zeroes and not random garbage.
-               memset((void*)&mScratchBuffers[chanCnt][len], 0,
-                  (framesPerBuffer - len) * sizeof(float));
+            if (region.Contiguous())
+               // Use the samples in place; realtime effects may also
+               // modify them there
+               mChannelPointers[chanCnt] =
+                  (float*)mPlaybackBuffer->GetPtr(t, region.first.start);
+            else {
+               mPlaybackBuffer->Read(t, region,
+                  (samplePtr)mScratchBuffers[chanCnt], floatSample);
+               mChannelPointers[chanCnt] = mScratchBuffers[chanCnt];
             }
+            // len may be less than framesPerBuffer.  This used to happen
+            // normally at the end of non-looping plays, but it can also be
+            // an anomalous case where the supply from TrackBufferExchange
+            // fails to keep up with the real-time demand in this thread
+            // (see bug 1932).  Only len samples are added to the output,
+            // so the sound card gets zeroes and not random garbage after.
             chanCnt++;
          }
 
@@ -2079,7 +2115,7 @@ bool AudioIoCallback::FillOutputBuffers(
          // Do realtime effects
          if( !dropQuickly && len > 0 ) {
             if (pScope)
-               pScope->Process(mTrackChannelsBuffer[0], mScratchBuffers.data(), len);
+               pScope->Process(mTrackChannelsBuffer[0], mChannelPointers.data(), len);
             // Mix the results with the existing output (software playthrough) and
             // apply panning.  If post panning effects are desired, the panning would
             // need to be be split out from the mixing and applied in a separate step.
@@ -2102,12 +2138,12 @@ bool AudioIoCallback::FillOutputBuffers(
                   if (vt->GetChannelIgnoringPan() == Track::LeftChannel ||
                         vt->GetChannelIgnoringPan() == Track::MonoChannel )
                      AddToOutputChannel( 0, outputMeterFloats, outputFloats,
-                        mScratchBuffers[c], drop, len, *vt);
+                        mChannelPointers[c], drop, len, *vt);
 
                   if (vt->GetChannelIgnoringPan() == Track::RightChannel ||
                         vt->GetChannelIgnoringPan() == Track::MonoChannel  )
                      AddToOutputChannel( 1, outputMeterFloats, outputFloats,
-                        mScratchBuffers[c], drop, len, *vt);
+                        mChannelPointers[c], drop, len, *vt);
                }
             }
          }
@@ -2124,10 +2160,12 @@ bool AudioIoCallback::FillOutputBuffers(
       // do it here instead (but not if looping or scrubbing)
       // PRL:  Also consume from the single playback ring buffer
       if (numPlaybackTracks == 0) {
-         mMaxFramesOutput = mPlaybackBuffers[0]->Discard(toGet);
+         mMaxFramesOutput = toGet;
          CallbackCheckCompletion(mCallbackReturn, 0);
       }
 
+      mPlaybackBuffer->CommitGet(toGet);
+
       // assert( maxLen == toGet );
    }
 
@@ -2160,8 +2198,7 @@ void AudioIoCallback::UpdateTimePosition(unsigned long framesPerBuffer)
 void AudioIoCallback::DrainInputBuffers(
    constSamplePtr inputBuffer,
    unsigned long framesPerBuffer,
-   const PaStreamCallbackFlags statusFlags,
-   float * tempFloats
+   const PaStreamCallbackFlags statusFlags
 )
 {
    const auto numPlaybackTracks = mPlaybackTracks.size();
@@ -2192,9 +2229,8 @@ void AudioIoCallback::DrainInputBuffers(
    // So we have not decided to enable this extra detection yet in
    // production
 
-   size_t len = framesPerBuffer;
-   for(unsigned t = 0; t < numCaptureChannels; t++)
-      len = std::min( len, mCaptureBuffers[t]->AvailForPut() );
+   size_t len = std::min<size_t>(
+      framesPerBuffer, mCaptureBuffer->AvailForPut() );
 
    if (mSimulateRecordingErrors && 100LL * rand() < RAND_MAX)
       // Make spurious errors for purposes of testing the error
@@ -2203,7 +2239,7 @@ void AudioIoCallback::DrainInputBuffers(
 
    // A different symptom is that len < framesPerBuffer because
    // the other thread, executing TrackBufferExchange, isn't consuming fast
-   // enough from mCaptureBuffers; maybe it's CPU-bound, or maybe the
+   // enough from mCaptureBuffer; maybe it's CPU-bound, or maybe the
    // storage device it writes is too slow
    if (mDetectDropouts &&
          ((mDetectUpstreamDropouts && inputError) ||
@@ -2219,64 +2255,31 @@ void AudioIoCallback::DrainInputBuffers(
           fabs(pLast->first + pLast->second - start) < 0.5/mRate)
          // Make one bigger interval, not two butting intervals
          pLast->second = start + duration - pLast->first;
-      else
+      else if (mLostCaptureIntervals.size() <
+               mLostCaptureIntervals.capacity())
+         // Don't grow the vector here; beyond its reserved capacity, the
+         // dropouts are only counted in mLostSamples
          mLostCaptureIntervals.emplace_back( start, duration );
    }
 
    if (len < framesPerBuffer)
-   {
       mLostSamples += (framesPerBuffer - len);
-      std::cout << "lost " << (int)(framesPerBuffer - len) << " samples" << std::endl;
-   }
 
    if (len <= 0) 
       return;
 
-   // We have an ASSERT in the AudioIO constructor to alert us to 
-   // possible issues with the (short*) cast.  We'd have a problem if
-   // sizeof(short) > sizeof(float) since our buffers are sized for floats.
-   for(unsigned t = 0; t < numCaptureChannels; t++) {
-
-      // dmazzoni:
-      // Un-interleave.  Ugly special-case code required because the
-      // capture channels could be in three different sample formats;
-      // it'd be nice to be able to call CopySamples, but it can't
-      // handle multiplying by the gain and then clipping.  Bummer.
-
-      switch(mCaptureFormat) {
-         case floatSample: {
-            auto inputFloats = (const float *)inputBuffer;
-            for(unsigned i = 0; i < len; i++)
-               tempFloats[i] =
-                  inputFloats[numCaptureChannels*i+t];
-         } break;
-         case int24Sample:
-            // We should never get here. Audacity's int24Sample format
-            // is different from PortAudio's sample format and so we
-            // make PortAudio return float samples when recording in
-            // 24-bit samples.
-            assert(false);
-            break;
-         case int16Sample: {
-            auto inputShorts = (const short *)inputBuffer;
-            short *tempShorts = (short *)tempFloats;
-            for( unsigned i = 0; i < len; i++) {
-               float tmp = inputShorts[numCaptureChannels*i+t];
-               tmp = wxClip( -32768, tmp, 32767 );
-               tempShorts[i] = (short)(tmp);
-            }
-         } break;
-      } // switch
-
-      // JKC: mCaptureFormat must be for samples with sizeof(float) or
-      // fewer bytes (because tempFloats is sized for floats).  All 
-      // formats are 2 or 4 bytes, so we are OK.
-      //const auto put = // unused
-         mCaptureBuffers[t]->Put(
-            (samplePtr)tempFloats, mCaptureFormat, len);
-      // assert(put == len);
-      // but we can't assert in this thread
-   }
+   // Un-interleave directly into the ring buffer, converting the format
+   // without dither
+   // Audacity's int24Sample format is different from PortAudio's sample
+   // format and so we make PortAudio return float samples when recording in
+   // 24-bit samples.
+   assert(mCaptureFormat != int24Sample);
+   const auto region = mCaptureBuffer->GetWritable(len);
+   const auto sampleSize = SAMPLE_SIZE(mCaptureFormat);
+   for(unsigned t = 0; t < numCaptureChannels; t++)
+      mCaptureBuffer->Write(t, region,
+         inputBuffer + t * sampleSize, mCaptureFormat, numCaptureChannels);
+   mCaptureBuffer->CommitPut(region.Length());
 }
 
 
@@ -2372,7 +2375,6 @@ void AudioIoCallback::SendVuInputMeterData(
       *     is allowed to actually do the updating.
       * Note that mUpdatingMeters must be set first to avoid a race condition.
       */
-   //TODO use atomics instead.
    mUpdatingMeters = true;
    if (mUpdateMeters) {
          pInputMeter->UpdateDisplay(numCaptureChannels,
@@ -2503,6 +2505,9 @@ int AudioIoCallback::AudioCallback(
    const PaStreamCallbackTimeInfo *timeInfo,
    const PaStreamCallbackFlags statusFlags, void * /* userData */ )
 {
+   // Nothing here may allocate or wait
+   RealtimeChecks::Scope checks;
+
    // Poll tracks for change of state.  User might click mute and solo buttons.
    mbHasSoloTracks = CountSoloingTracks() > 0 ;
    mCallbackReturn = paContinue;
@@ -2524,42 +2529,40 @@ int AudioIoCallback::AudioCallback(
          mRate, mNumPauseFrames, IsPaused(), mbHasSoloTracks);
    }
 
-   // ------ MEMORY ALLOCATIONS -----------------------------------------------
-   // tempFloats will be a reusable scratch pad for (possibly format converted)
-   // audio data.  One temporary use is for the InputMeter data.
-   const auto numPlaybackChannels = mNumPlaybackChannels;
+   // tempFloats is a scratch pad, allocated by UpdateBuffers(), for format
+   // converted input for the InputMeter
    const auto numCaptureChannels = mNumCaptureChannels;
-   std::unique_ptr<float> tempFloats(
-      new float[framesPerBuffer * std::max(numCaptureChannels, numPlaybackChannels)]
-   );
-   // ----- END of MEMORY ALLOCATIONS ------------------------------------------
+   float *const tempFloats = mTemporaryBuffer.get();
 
    if (inputBuffer && numCaptureChannels) {
-      float *inputSamples;
+      float *inputSamples = nullptr;
 
       if (mCaptureFormat == floatSample) {
          inputSamples = (float *) inputBuffer;
       }
-      else {
+      else if (framesPerBuffer * numCaptureChannels <= mTemporaryBufferSize) {
          SamplesToFloats(reinterpret_cast<constSamplePtr>(inputBuffer),
-            mCaptureFormat, tempFloats.get(), framesPerBuffer * numCaptureChannels);
-         inputSamples = tempFloats.get();
+            mCaptureFormat, tempFloats, framesPerBuffer * numCaptureChannels);
+         inputSamples = tempFloats;
+      }
+      // else PortAudio gave a bigger buffer than requested; skip metering
+
+      if (inputSamples) {
+         SendVuInputMeterData(
+            inputSamples,
+            framesPerBuffer);
+
+         // This function may queue up a pause or resume.
+         // TODO this is a bit dodgy as it toggles the Pause, and
+         // relies on an idle event to have handled that, so could 
+         // queue up multiple toggle requests and so do nothing.
+         // Eventually it will sort itself out by random luck, but
+         // the net effect is a delay in starting/stopping sound activated 
+         // recording.
+         CheckSoundActivatedRecordingLevel(
+            inputSamples,
+            framesPerBuffer);
       }
-
-      SendVuInputMeterData(
-         inputSamples,
-         framesPerBuffer);
-
-      // This function may queue up a pause or resume.
-      // TODO this is a bit dodgy as it toggles the Pause, and
-      // relies on an idle event to have handled that, so could 
-      // queue up multiple toggle requests and so do nothing.
-      // Eventually it will sort itself out by random luck, but
-      // the net effect is a delay in starting/stopping sound activated 
-      // recording.
-      CheckSoundActivatedRecordingLevel(
-         inputSamples,
-         framesPerBuffer);
    }
 
    // Even when paused, we do playthrough.
@@ -2590,8 +2593,7 @@ int AudioIoCallback::AudioCallback(
    DrainInputBuffers(
       inputBuffer,
       framesPerBuffer,
-      statusFlags,
-      tempFloats.get());
+      statusFlags);
 
    SendVuOutputMeterData( outputBuffer, framesPerBuffer);
 
@@ -2600,6 +2602,9 @@ int AudioIoCallback::AudioCallback(
 
 int AudioIoCallback::CallbackDoSeek()
 {
+   // Seeking waits for the audio thread on purpose
+   RealtimeChecks::Allowance allowance;
+
    const int token = mStreamToken;
    std::lock_guard<std::mutex> locker(mSuspendAudioThread);
    if (token != mStreamToken)
@@ -2628,13 +2633,11 @@ int AudioIoCallback::CallbackDoSeek()
    {
       const bool skipping = true;
       mPlaybackMixers[i]->Reposition( time, skipping );
-      const auto toDiscard =
-         mPlaybackBuffers[i]->AvailForGet();
-      const auto discarded =
-         mPlaybackBuffers[i]->Discard( toDiscard );
-      // assert( discarded == toDiscard );
-      // but we can't assert in this thread
    }
+   const auto toDiscard = mPlaybackBuffer->AvailForGet();
+   const auto discarded = mPlaybackBuffer->Discard( toDiscard );
+   // assert( discarded == toDiscard );
+   // but we can't assert in this thread
 
    mPlaybackSchedule.mTimeQueue.Prime(time);
 
@@ -17,6 +17,7 @@
 #include "AudioIOBase.h" // to inherit
 #include "PlaybackSchedule.h" // member variable
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -211,8 +212,7 @@ public:
    void DrainInputBuffers(
       constSamplePtr inputBuffer, 
       unsigned long framesPerBuffer,
-      const PaStreamCallbackFlags statusFlags,
-      float * tempFloats
+      const PaStreamCallbackFlags statusFlags
    );
    void UpdateTimePosition(
       unsigned long framesPerBuffer
@@ -237,8 +237,12 @@ protected:
    // Buffers
    std::vector<WaveTrack*> mTrackChannelsBuffer;
    std::vector<float*>     mScratchBuffers;
+   //! Either mScratchBuffers, or places in mPlaybackBuffer
+   std::vector<float*>     mChannelPointers;
    AutoAllocator<float>    mScratchBufferAllocator;
    std::shared_ptr<float>  mTemporaryBuffer;
+   //! Floats in mTemporaryBuffer, enough for all channels of one callback
+   size_t                  mTemporaryBufferSize{ 0 };
 
    // Bufer preparation status
    bool mBuffersPrepared;
@@ -259,9 +263,11 @@ public:
    long    mNumPauseFrames;
 
    ArrayOf<std::unique_ptr<Resample>> mResample;
-   ArrayOf<std::unique_ptr<RingBuffer>> mCaptureBuffers;
+   //! One channel for each of mCaptureTracks
+   std::unique_ptr<RingBuffer> mCaptureBuffer;
    WaveTrackArray      mCaptureTracks;
-   ArrayOf<std::unique_ptr<RingBuffer>> mPlaybackBuffers;
+   //! One channel for each of mPlaybackTracks, but at least one
+   std::unique_ptr<RingBuffer> mPlaybackBuffer;
    WaveTrackArray      mPlaybackTracks;
 
    std::vector<std::unique_ptr<Mixer>> mPlaybackMixers;
@@ -293,6 +299,8 @@ public:
    volatile bool       mAudioThreadTrackBufferExchangeLoopActive;
 
    std::atomic<bool>   mForceFadeOut{ false };
+   //! Set by the callback, which may not notify the listener itself
+   std::atomic<bool>   mSoundActivationChanged{ false };
 
    std::chrono::milliseconds mLastPlaybackTimeMillis;
 
@@ -311,8 +319,10 @@ protected:
    */
    long GetConvertedLatencyPreference();
 
-   bool                mUpdateMeters;
-   volatile bool       mUpdatingMeters;
+   //! Sequentially consistent, so that StopStream() never misses the
+   //! callback entering the meters
+   std::atomic<bool>   mUpdateMeters{ false };
+   std::atomic<bool>   mUpdatingMeters{ false };
 
    std::weak_ptr< AudioIOListener > mListener;
 
@@ -344,6 +354,8 @@ protected:
       }
    }
 
+   //! Reserved at the start of the stream, so the callback never allocates
+   static constexpr size_t MaxLostCaptureIntervals = 1000;
    std::vector< std::pair<double, double> > mLostCaptureIntervals;
    bool mDetectDropouts{ true };
 
@@ -0,0 +1,223 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file BlockPrefetcher.cpp
+@brief Implements BlockPrefetcher
+
+**********************************************************************/
+
+#include "BlockPrefetcher.h"
+
+#include <algorithm>
+
+// Tenacity libraries
+#include <lib-basic-ui/BasicUI.h>
+#include <lib-math/SampleCount.h>
+#include <lib-sample-track/Mix.h>
+
+#include "DBConnection.h"
+#include "Sequence.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+
+namespace {
+//! Number of worker threads; reads of one database are serialized by
+//! SQLite anyway, so more would only help with several projects open
+constexpr size_t NumThreads = 2;
+
+//! Beyond this, the oldest requests are dropped, being the least urgent
+constexpr size_t MaxJobs = 64;
+}
+
+BlockPrefetcher &BlockPrefetcher::Get()
+{
+   static BlockPrefetcher instance;
+   return instance;
+}
+
+BlockPrefetcher::BlockPrefetcher() = default;
+
+BlockPrefetcher::~BlockPrefetcher()
+{
+   Stop();
+}
+
+void BlockPrefetcher::Request(
+   const WaveTrack &track, sampleCount start, sampleCount len)
+{
+   const auto &pFactory = track.GetSampleBlockFactory();
+   if (!pFactory || len <= 0)
+      return;
+
+   Job job;
+   job.pFactory = pFactory;
+   job.key = pFactory.get();
+
+   // Find the blocks overlapping the range, as WaveTrack::Get() would
+   const auto end = start + len;
+   for (const auto &pClip : track.GetClips()) {
+      const auto clipStart = pClip->GetPlayStartSample();
+      const auto clipEnd = pClip->GetPlayEndSample();
+      if (clipEnd <= start || clipStart >= end)
+         continue;
+
+      // Positions in the sequence, as in WaveClip::GetSamples()
+      const auto trim = pClip->TimeToSamples(pClip->GetTrimLeft());
+      const auto s0 = std::max(start, clipStart) - clipStart + trim;
+      const auto s1 = std::min(end, clipEnd) - clipStart + trim;
+
+      const auto &sequence = *pClip->GetSequence();
+      const auto &blocks = sequence.GetBlockArray();
+      if (blocks.empty() || s0 < 0 || s0 >= sequence.GetNumSamples())
+         continue;
+
+      for (size_t b = sequence.FindBlock(s0);
+           b < blocks.size() && blocks[b].start < s1; ++b) {
+         job.blocks.push_back(blocks[b].sb);
+         job.ids.push_back(blocks[b].sb->GetBlockID());
+      }
+   }
+
+   std::lock_guard<std::mutex> guard(mMutex);
+
+   // Don't queue a block twice
+   size_t kept = 0;
+   for (size_t ii = 0; ii < job.ids.size(); ++ii) {
+      if (!mQueued.insert({ job.key, job.ids[ii] }).second)
+         continue;
+      job.blocks[kept] = std::move(job.blocks[ii]);
+      job.ids[kept] = job.ids[ii];
+      ++kept;
+   }
+   job.blocks.resize(kept);
+   job.ids.resize(kept);
+   if (job.ids.empty())
+      return;
+
+   if (mThreads.empty())
+      Start();
+
+   if (mJobs.size() >= MaxJobs) {
+      auto &oldest = mJobs.front();
+      for (auto id : oldest.ids)
+         mQueued.erase({ oldest.key, id });
+      mJobs.pop_front();
+      ++mDropped;
+   }
+
+   mJobs.push_back(std::move(job));
+   ++mRequested;
+   mWake.notify_one();
+}
+
+void BlockPrefetcher::Cancel(const SampleBlockFactory *pFactory)
+{
+   std::unique_lock<std::mutex> lock(mMutex);
+   if (!pFactory) {
+      mJobs.clear();
+      mQueued.clear();
+      mIdle.wait(lock, [this]{ return mBusy.empty(); });
+      return;
+   }
+
+   for (auto it = mJobs.begin(); it != mJobs.end();) {
+      if (it->key == pFactory) {
+         for (auto id : it->ids)
+            mQueued.erase({ it->key, id });
+         it = mJobs.erase(it);
+      }
+      else
+         ++it;
+   }
+   mIdle.wait(lock, [this, pFactory]{ return mBusy.count(pFactory) == 0; });
+}
+
+auto BlockPrefetcher::GetStats() const -> Stats
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   return { mRequested, mDropped };
+}
+
+void BlockPrefetcher::Start()
+{
+   // mMutex is held
+   for (size_t ii = 0; ii < NumThreads; ++ii)
+      mThreads.emplace_back([this]{ Work(); });
+}
+
+void BlockPrefetcher::Stop()
+{
+   {
+      std::lock_guard<std::mutex> guard(mMutex);
+      mStop = true;
+      mJobs.clear();
+      mWake.notify_all();
+   }
+   for (auto &thread : mThreads)
+      if (thread.joinable())
+         thread.join();
+   mThreads.clear();
+}
+
+void BlockPrefetcher::Work()
+{
+   std::unique_lock<std::mutex> lock(mMutex);
+   while (true) {
+      mWake.wait(lock, [this]{ return mStop || !mJobs.empty(); });
+      if (mStop)
+         return;
+
+      auto job = std::move(mJobs.front());
+      mJobs.pop_front();
+      const auto busy = mBusy.insert(job.key);
+      lock.unlock();
+
+      {
+         auto pFactory = job.pFactory.lock();
+         auto pBlocks = std::make_shared<std::vector<SampleBlockPtr>>();
+         for (auto &wBlock : job.blocks)
+            if (auto pBlock = wBlock.lock())
+               pBlocks->push_back(std::move(pBlock));
+
+         if (pFactory && !pBlocks->empty()) {
+            try {
+               pFactory->Prefetch(*pBlocks);
+            }
+            catch ( ... ) {
+               // Only a hint; let the real read report any error
+            }
+
+            // This thread might now hold the last references, and the
+            // destructors of blocks and factories belong in the main thread
+            GenericUI::CallAfter(
+               [pFactory = std::move(pFactory), pBlocks = std::move(pBlocks)]{}
+            );
+         }
+      }
+
+      lock.lock();
+      for (auto id : job.ids)
+         mQueued.erase({ job.key, id });
+      mBusy.erase(busy);
+      mIdle.notify_all();
+   }
+}
+
+// Stop reading ahead with a connection about to close
+static Observer::Subscription sClosing =
+   DBConnectionClosing::Get().Subscribe(
+      [](const DBConnectionClosingMessage &message)
+{
+   BlockPrefetcher::Get().Cancel(message.pProject
+      ? WaveTrackFactory::Get(*message.pProject).GetSampleBlockFactory().get()
+      : nullptr);
+} );
+
+// Receive the read-ahead requests of all mixers
+static Mixer::ReadAhead::Scope scope{
+   [](const SampleTrack &track, sampleCount start, sampleCount len)
+{
+   if (auto pTrack = dynamic_cast<const WaveTrack*>(&track))
+      BlockPrefetcher::Get().Request(*pTrack, start, len);
+} };
@@ -0,0 +1,90 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file BlockPrefetcher.h
+@brief Reads sample blocks ahead of playback and export on worker threads
+
+**********************************************************************/
+
+#ifndef __AUDACITY_BLOCK_PREFETCHER__
+#define __AUDACITY_BLOCK_PREFETCHER__
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "SampleBlock.h"
+
+class sampleCount;
+class WaveTrack;
+
+///\brief Warms the SampleBlockCache with blocks about to be mixed
+/*!
+ Mixer reports, through Mixer::ReadAhead, the range of each track that it
+ will soon need.  This service finds the blocks of that range and has the
+ SampleBlockFactory fetch them on a worker thread, so that the thread that
+ mixes for playback or export usually finds them in memory.
+
+ Requests are only hints: they are dropped when the queue is long, and
+ failures to read are ignored, to be reported later by the real read.
+ */
+class TENACITY_DLL_API BlockPrefetcher final
+{
+public:
+   static BlockPrefetcher &Get();
+
+   BlockPrefetcher();
+   ~BlockPrefetcher();
+   BlockPrefetcher(const BlockPrefetcher&) = delete;
+   BlockPrefetcher &operator=(const BlockPrefetcher&) = delete;
+
+   //! Queue the blocks of the track overlapping the range; any thread
+   void Request(const WaveTrack &track, sampleCount start, sampleCount len);
+
+   //! Discard pending requests and wait for those in progress, of blocks
+   //! of one factory, or of all if it is null
+   /*! Called before a connection of the factory's project closes */
+   void Cancel(const SampleBlockFactory *pFactory);
+
+   struct Stats {
+      unsigned long long requested{ 0 };
+      unsigned long long dropped{ 0 };
+   };
+   Stats GetStats() const;
+
+private:
+   struct Job {
+      std::weak_ptr<SampleBlockFactory> pFactory;
+      //! Identifies the factory in mQueued, even after it is destroyed
+      const SampleBlockFactory *key{};
+      std::vector<std::weak_ptr<SampleBlock>> blocks;
+      std::vector<SampleBlockID> ids;
+   };
+
+   void Start();
+   void Stop();
+   void Work();
+
+   using QueuedID = std::pair<const SampleBlockFactory*, SampleBlockID>;
+
+   mutable std::mutex mMutex;
+   std::condition_variable mWake;
+   std::condition_variable mIdle;
+   std::deque<Job> mJobs;
+   std::set<QueuedID> mQueued;
+   std::vector<std::thread> mThreads;
+   //! Factories of the jobs in progress
+   std::multiset<const SampleBlockFactory*> mBusy;
+   bool mStop{ false };
+
+   unsigned long long mRequested{ 0 };
+   unsigned long long mDropped{ 0 };
+};
+
+#endif
@@ -13,6 +13,8 @@ Paul Licameli -- split from ProjectFileIO.cpp
 
 #include "sqlite3.h"
 
+#include <algorithm>
+
 #include <wx/string.h>
 
 // Tenacity libraries
@@ -21,9 +23,11 @@ Paul Licameli -- split from ProjectFileIO.cpp
 #include <lib-files/FileNames.h>
 #include <lib-files/TenacityLogger.h>
 #include <lib-files/wxFileNameWrapper.h>
+#include <lib-preferences/Prefs.h>
 #include <lib-strings/Internat.h>
 
 #include "Project.h"
+#include "SampleBlockCache.h"
 
 // Configuration to provide "safe" connections
 static const char *SafeConfig =
@@ -40,6 +44,18 @@ static const char *FastConfig =
    "PRAGMA <schema>.synchronous = OFF;"
    "PRAGMA <schema>.journal_mode = OFF;";
 
+BoolSetting ProjectHighThroughput{
+   L"/Performance/ProjectHighThroughput", false };
+IntSetting ProjectMmapSizeMB{ L"/Performance/ProjectMmapMB", 1024 };
+IntSetting ProjectCacheSizeMB{ L"/Performance/ProjectCacheMB", 64 };
+IntSetting ProjectPageSize{ L"/Performance/ProjectPageSize", 0 };
+
+DBConnectionClosing &DBConnectionClosing::Get()
+{
+   static DBConnectionClosing instance;
+   return instance;
+}
+
 DBConnection::DBConnection(
    const std::weak_ptr<TenacityProject> &pProject,
    const std::shared_ptr<DBConnectionErrors> &pErrors,
@@ -140,6 +156,8 @@ int DBConnection::Open(const FilePath fileName)
    mCheckpointStop = false;
    mCheckpointPending = false;
    mCheckpointActive = false;
+   static std::atomic<unsigned long long> sGenerations{ 0 };
+   mGeneration = ++sGenerations;
    rc = OpenStepByStep( fileName );
    if ( rc != SQLITE_OK)
    {
@@ -173,6 +191,9 @@ int DBConnection::OpenStepByStep(const FilePath fileName)
       return rc;
    }
 
+   // Before anything is written to a new file
+   PageSizeConfig();
+
    // Set default mode
    // (See comments in ProjectFileIO::SaveProject() about threading
    rc = SafeMode();
@@ -182,6 +203,10 @@ int DBConnection::OpenStepByStep(const FilePath fileName)
       return rc;
    }
 
+   // Failure is not fatal; reads are only slower
+   if (ProjectHighThroughput.Read())
+      ThroughputMode(true);
+
    rc = sqlite3_open(name, &mCheckpointDB);
    if (rc != SQLITE_OK)
    {
@@ -222,6 +247,10 @@ bool DBConnection::Close()
    // are sent our way.  (Though this shouldn't really happen.)
    sqlite3_wal_hook(mDB, nullptr, nullptr);
 
+   // Don't let work in the background, such as read-ahead of sample blocks,
+   // use the connection any longer
+   DBConnectionClosing::Get().Publish({ mpProject.lock().get() });
+
    // Display a progress dialog if there's active or pending checkpoints
    if (mCheckpointPending || mCheckpointActive)
    {
@@ -281,6 +310,10 @@ bool DBConnection::Close()
       mStatements.clear();
    }
 
+   // Cached sample block contents are keyed by the handle, which might be
+   // reused by a later connection
+   SampleBlockCache::Get().Invalidate(mDB);
+
    // Not much we can do if the closes fail, so just report the error
 
    // Close the checkpoint connection
@@ -332,6 +365,35 @@ int DBConnection::FastMode(const char *schema /* = "main" */)
    return ModeConfig(mDB, schema, FastConfig);
 }
 
+int DBConnection::ThroughputMode(bool enable, const char *schema /* = "main" */)
+{
+   // Mapped pages are read without copying them into the page cache, which
+   // then holds mostly the interior pages of the b-trees.  Negative
+   // cache_size is in KiB, and -2000 is the SQLite default.
+   const long long mmapBytes = enable
+      ? std::max(0, ProjectMmapSizeMB.Read()) * 1048576LL
+      : 0;
+   const long long cacheKB = enable
+      ? std::max(1, ProjectCacheSizeMB.Read()) * 1024LL
+      : 2000;
+   const auto config = wxString::Format(
+      "PRAGMA <schema>.mmap_size = %lld;"
+      "PRAGMA <schema>.cache_size = -%lld;",
+      mmapBytes, cacheKB);
+   return ModeConfig(mDB, schema, config.ToUTF8());
+}
+
+int DBConnection::PageSizeConfig(const char *schema /* = "main" */)
+{
+   const auto pageSize = ProjectPageSize.Read();
+   if (pageSize <= 0)
+      return SQLITE_OK;
+   // SQLite ignores sizes that are not powers of 2 from 512 to 65536
+   const auto config =
+      wxString::Format("PRAGMA <schema>.page_size = %d;", pageSize);
+   return ModeConfig(mDB, schema, config.ToUTF8());
+}
+
 int DBConnection::ModeConfig(sqlite3 *db, const char *schema, const char *config)
 {
    // Ensure attached DB connection gets configured
@@ -24,12 +24,25 @@ Paul Licameli -- split from ProjectFileIO.h
 
 // Tenacity libraries
 #include <lib-strings/Identifier.h>
+#include <lib-utility/Observer.h>
 
 struct sqlite3;
 struct sqlite3_stmt;
 class wxString;
+class BoolSetting;
+class IntSetting;
 class TenacityProject;
 
+//! Whether project connections map the file into memory for reading, and
+//! keep a bigger page cache
+extern TENACITY_DLL_API BoolSetting ProjectHighThroughput;
+//! Limit of the memory mapping in that mode
+extern TENACITY_DLL_API IntSetting ProjectMmapSizeMB;
+//! Size of the page cache in that mode
+extern TENACITY_DLL_API IntSetting ProjectCacheSizeMB;
+//! Page size in bytes of new project files, or 0 for the SQLite default
+extern TENACITY_DLL_API IntSetting ProjectPageSize;
+
 struct DBConnectionErrors
 {
    TranslatableString mLastError;
@@ -38,6 +51,29 @@ struct DBConnectionErrors
    wxString mLog;
 };
 
+//! Sent by DBConnection::Close() before the connection closes
+struct DBConnectionClosingMessage
+{
+   //! The project of the connection, or null if it is gone already
+   TenacityProject *pProject;
+};
+
+class DBConnection;
+
+//! Lets those who read sample blocks in the background stop using a
+//! connection before it closes, without the connection knowing of them
+/*! Subscribers stop only the work of the message's project, unless it is
+ null, and must not return until that work is done */
+class TENACITY_DLL_API DBConnectionClosing final
+   : public Observer::Publisher<DBConnectionClosingMessage>
+{
+public:
+   static DBConnectionClosing &Get();
+
+private:
+   friend DBConnection;
+};
+
 class DBConnection
 {
 public:
@@ -61,23 +97,38 @@ public:
 
    int SafeMode(const char *schema = "main");
    int FastMode(const char *schema = "main");
+   //! Read with memory mapping and a bigger page cache, or not
+   /*! Independent of SafeMode() and FastMode() */
+   int ThroughputMode(bool enable, const char *schema = "main");
+   //! Set the page size from ProjectPageSize; no effect unless the database
+   //! is still empty
+   int PageSizeConfig(const char *schema = "main");
 
    bool Assign(sqlite3 *handle);
    sqlite3 *Detach();
 
    sqlite3 *DB();
 
+   //! Distinguishes each opening of any connection from all others, even
+   //! if the object or the handle is reused
+   unsigned long long GetGeneration() const { return mGeneration; }
+
    int GetLastRC() const ;
    const wxString GetLastMessage() const;
 
    enum StatementID
    {
       GetSamples,
+      GetSamplesBatch,
       GetSummary256,
       GetSummary64k,
       LoadSampleBlock,
       InsertSampleBlock,
       DeleteSampleBlock,
+      LoadDerivedData,
+      InsertDerivedData,
+      CountDerivedData,
+      DeleteOtherDerivedData,
       GetRootPage,
       GetDBPage
    };
@@ -126,6 +177,8 @@ private:
 
    // Bypass transactions if database will be deleted after close
    bool mBypass;
+
+   std::atomic<unsigned long long> mGeneration{ 0 };
 };
 
 using Connection = std::unique_ptr<DBConnection>;
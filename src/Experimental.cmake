@@ -31,10 +31,6 @@ set( EXPERIMENTAL_OPTIONS_LIST
    # Experimental project import
    IMPORT_AUP3
   
-   # ACH 08 Jan 2014
-   # EQ accelerated code
-   #EQ_SSE_THREADED
-
    # LLL, 09 Nov 2013:
    # Allow all WASAPI devices, not just loopback
    FULL_WASAPI
@@ -207,17 +207,17 @@ void HistoryDialog::DoUpdate()
 
    mList->DeleteAllItems();
 
-   wxLongLong_t total = 0;
    mSelected = mManager->GetCurrentState();
    for (i = 0; i < (int)mManager->GetNumStates(); i++) {
       TranslatableString desc, size;
 
-      total += mManager->GetLongDescription(i, &desc, &size);
+      mManager->GetLongDescription(i, &desc, &size);
       mList->InsertItem(i, desc.Translation(), i == mSelected ? 1 : 0);
       mList->SetItem(i, 1, size.Translation());
    }
 
-   mTotal->SetValue(Internat::FormatSize(total).Translation());
+   mTotal->SetValue(
+      Internat::FormatSize(mManager->GetTotalSpaceUsage()).Translation());
 
    auto clipboardUsage = mManager->GetClipboardSpaceUsage();
    mClipboard->SetValue(Internat::FormatSize(clipboardUsage).Translation());
@@ -14,6 +14,9 @@ Paul Licameli split from TenacityProject.cpp
 #include <sqlite3.h>
 #include <optional>
 #include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 #include <wx/app.h>
 #include <wx/crt.h>
@@ -36,6 +39,7 @@ Paul Licameli split from TenacityProject.cpp
 #include "ProjectSerializer.h"
 #include "ProjectWindows.h"
 #include "SampleBlock.h"
+#include "SampleBlockCache.h"
 #include "TempDirectory.h"
 #include "TransactionScope.h"
 #include "WaveTrack.h"
@@ -168,6 +172,56 @@ static const char *ProjectFileSchema =
    "  samples              BLOB"
    ");";
 
+// CREATE SQL autosavedelta
+// Older project files lack this table, so it is created when first needed,
+// and dropped again when the autosave is deleted.
+// Row 0 holds the dictionary, and in doc, the parts of the autosave
+// document outside of the tracks, and a list saying where each track is:
+// either in the autosave row, or in another row of this table, whose doc
+// holds the binary representation of just that track.
+// Rows are only meaningful together with the autosave row they amend.
+static const char *AutoSaveDeltaSchema =
+   "CREATE TABLE IF NOT EXISTS main.autosavedelta"
+   "("
+   "  id                   INTEGER PRIMARY KEY,"
+   "  dict                 BLOB,"
+   "  doc                  BLOB"
+   ");";
+
+// CREATE SQL derivedblockdata
+// Made by InstallDerivedDataSchema() when derived data are first stored,
+// not with the rest of the schema, so that project files are unchanged
+// unless they are.  The trigger deletes the rows of a block after its row
+// in sampleblocks is deleted, by any version of the program.
+//
+// A row is a cache of something computed from the samples of the block,
+// which never change.  key names the computation and its parameters.  For
+// spectrograms it is "spectrogram/a<algorithm>/w<window size>/z<zero
+// padding factor>/t<window type>/h<hop>", then "/r<rate>" for pitch (EAC);
+// data is that of the columns one hop apart, of all windows lying in the
+// block, each of NBins() floats in the byte order of the machine.  A row
+// of the wrong size is ignored and replaced.
+//
+// CopyTo() copies the rows of the blocks it copies.  SqliteSampleBlockFactory
+// keeps the total size of the data within a limit, forgetting the rows of
+// other keys first.
+//
+// Versions that do not know the table ignore it, so user_version is not
+// changed for it.
+static const char *DerivedDataSchema =
+   "CREATE TABLE IF NOT EXISTS <schema>.derivedblockdata"
+   "("
+   "  blockid              INTEGER,"
+   "  key                  TEXT,"
+   "  data                 BLOB,"
+   "  PRIMARY KEY (blockid, key)"
+   ") WITHOUT ROWID;"
+   "CREATE TRIGGER IF NOT EXISTS <schema>.derivedblockdata_delete"
+   "  AFTER DELETE ON sampleblocks"
+   "  BEGIN"
+   "    DELETE FROM derivedblockdata WHERE blockid = old.blockid;"
+   "  END;";
+
 // This singleton handles initialization/shutdown of the SQLite library.
 // It is needed because our local SQLite is built with SQLITE_OMIT_AUTOINIT
 // defined.
@@ -424,6 +478,143 @@ protected:
 
 constexpr std::array<const char*, 2> BufferedProjectBlobStream::Columns;
 
+class BufferedMemoryStream final : public BufferedStreamReader
+{
+public:
+   explicit BufferedMemoryStream(std::vector<uint8_t> data)
+      : BufferedStreamReader(32 * 1024)
+      , mData{ std::move(data) }
+   {
+   }
+
+protected:
+   bool HasMoreData() const override
+   {
+      return mOffset < mData.size();
+   }
+
+   size_t ReadData(void* buffer, size_t maxBytes) override
+   {
+      maxBytes = std::min(maxBytes, mData.size() - mOffset);
+      memcpy(buffer, mData.data() + mOffset, maxBytes);
+      mOffset += maxBytes;
+      return maxBytes;
+   }
+
+private:
+   const std::vector<uint8_t> mData;
+   size_t mOffset { 0 };
+};
+
+//! The serialized tracks of the last autosave, so that the next one may
+//! find which tracks changed, by comparing bytes
+struct ProjectFileIO::AutoSaveState
+{
+   struct Segment
+   {
+      std::string bytes;
+      //! Row of autosavedelta holding the bytes, or 0 for the autosave row
+      int64_t row { 0 };
+      //! Position of the bytes in the autosave doc, when row is 0
+      size_t offset { 0 };
+   };
+   using SegmentPtr = std::shared_ptr<const Segment>;
+   //! Keyed by hash of the bytes; tracks with equal bytes share a segment
+   using Segments = std::unordered_multimap<size_t, SegmentPtr>;
+
+   static SegmentPtr Find(
+      const Segments &segments, size_t hash, std::string_view bytes)
+   {
+      auto range = segments.equal_range(hash);
+      for (auto iter = range.first; iter != range.second; ++iter)
+         if (iter->second->bytes == bytes)
+            return iter->second;
+      return {};
+   }
+
+   Segments segments;
+   //! Size of the autosave doc
+   size_t checkpointSize { 0 };
+   //! HashCheckpoint() of the autosave row
+   uint64_t checkpointHash { 0 };
+   //! Total size of the segments in autosavedelta
+   size_t deltaSize { 0 };
+   int64_t nextRow { 1 };
+};
+
+namespace {
+// The doc of row 0 of autosavedelta is a sequence of 64 bit integers in
+// native byte order, and byte strings prefixed by their lengths:
+// the size of the autosave doc amended, and the HashCheckpoint() of its
+// row, to detect that it was replaced, perhaps by a version of the program
+// that knows nothing of deltas; the part of the document before the
+// tracks; the number of tracks; for each track, its row, offset and
+// length; then the part after the tracks.
+
+//! 64 bit FNV-1a of the dict and the doc of the autosave row
+/*! Not std::hash, which may differ in the build that recovers the file */
+uint64_t HashCheckpoint(const void *dict, size_t dictSize,
+   const void *doc, size_t docSize)
+{
+   uint64_t hash = 14695981039346656037ULL;
+   const auto add = [&](const void *data, size_t size)
+   {
+      auto bytes = static_cast<const uint8_t *>(data);
+      for (size_t ii = 0; ii < size; ++ii)
+         hash = (hash ^ bytes[ii]) * 1099511628211ULL;
+   };
+   add(dict, dictSize);
+   add(doc, docSize);
+   return hash;
+}
+
+void AppendInt(std::vector<uint8_t> &buffer, int64_t value)
+{
+   auto bytes = reinterpret_cast<const uint8_t *>(&value);
+   buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+}
+
+void AppendBytes(std::vector<uint8_t> &buffer, std::string_view bytes)
+{
+   AppendInt(buffer, bytes.size());
+   buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+}
+
+bool ReadInt(const std::vector<uint8_t> &buffer, size_t &pos, int64_t &value)
+{
+   if (buffer.size() - pos < sizeof(value))
+      return false;
+   memcpy(&value, buffer.data() + pos, sizeof(value));
+   pos += sizeof(value);
+   return true;
+}
+
+bool ReadBytes(const std::vector<uint8_t> &buffer, size_t &pos,
+   std::vector<uint8_t> &out)
+{
+   int64_t length;
+   if (!ReadInt(buffer, pos, length) ||
+       length < 0 || uint64_t(length) > buffer.size() - pos)
+      return false;
+   out.insert(out.end(), buffer.begin() + pos, buffer.begin() + pos + length);
+   pos += length;
+   return true;
+}
+
+//! Read one column of one row into the buffer, replacing its contents
+bool ReadBlob(sqlite3_stmt *stmt, int64_t id, std::vector<uint8_t> &buffer)
+{
+   sqlite3_reset(stmt);
+   if (sqlite3_bind_int64(stmt, 1, id) != SQLITE_OK ||
+       sqlite3_step(stmt) != SQLITE_ROW)
+      return false;
+   auto data = static_cast<const uint8_t *>(sqlite3_column_blob(stmt, 0));
+   auto size = sqlite3_column_bytes(stmt, 0);
+   buffer.assign(data, data + size);
+   return true;
+}
+}
+
 bool ProjectFileIO::InitializeSQL()
 {
    static SQLiteIniter sqliteIniter;
@@ -894,6 +1085,15 @@ bool ProjectFileIO::InstallSchema(sqlite3 *db, const char *schema /* = "main" */
    return true;
 }
 
+bool ProjectFileIO::InstallDerivedDataSchema(
+   sqlite3 *db, const char *schema /* = "main" */)
+{
+   wxString sql{ DerivedDataSchema };
+   sql.Replace("<schema>", schema);
+
+   return sqlite3_exec(db, sql, nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
 // The orphan block handling should be removed once autosave and related
 // blocks become part of the same transaction.
 
@@ -966,6 +1166,9 @@ bool ProjectFileIO::DeleteBlocks(const BlockIDs &blockids, bool complement)
       return false;
    }
 
+   // Deleted row ids may be reused, so forget what was read from them
+   SampleBlockCache::Get().Invalidate(db);
+
    // Mark the project recovered if we deleted any rows
    int changes = sqlite3_changes(db);
    if (changes > 0)
@@ -1082,6 +1285,7 @@ bool ProjectFileIO::CopyTo(const FilePath &destpath,
    //
    // NOTE:  Between the above attach and setting the mode here, a normal DELETE
    //        mode journal will be used and will briefly appear in the filesystem.
+   pConn->PageSizeConfig("outbound");
    if ( pConn->FastMode("outbound") != SQLITE_OK)
    {
       SetDBError(
@@ -1098,16 +1302,35 @@ bool ProjectFileIO::CopyTo(const FilePath &destpath,
       return false;
    }
 
+   // And the table of derived data, if this database has it
+   int64_t derivedTables = 0;
+   if (!GetValue("SELECT Count(*) FROM main.sqlite_master"
+                 "  WHERE type = 'table' AND name = 'derivedblockdata';",
+                 derivedTables))
+   {
+      // Error message already captured.
+      return false;
+   }
+   const bool copyDerived = derivedTables > 0;
+   if (copyDerived && !InstallDerivedDataSchema(db, "outbound"))
+   {
+      SetDBError(
+         XO("Unable to initialize the project file")
+      );
+      return false;
+   }
+
    {
-      // Ensure statement gets cleaned up
+      // Ensure statements get cleaned up
       sqlite3_stmt *stmt = nullptr;
+      sqlite3_stmt *derivedStmt = nullptr;
       auto cleanup = finally([&]
       {
+         // No need to check return codes
          if (stmt)
-         {
-            // No need to check return code
             sqlite3_finalize(stmt);
-         }
+         if (derivedStmt)
+            sqlite3_finalize(derivedStmt);
       });
 
       // Prepare the statement only once
@@ -1126,6 +1349,24 @@ bool ProjectFileIO::CopyTo(const FilePath &destpath,
          return false;
       }
 
+      if (copyDerived)
+      {
+         rc = sqlite3_prepare_v2(db,
+                                 "INSERT INTO outbound.derivedblockdata"
+                                 "  SELECT * FROM main.derivedblockdata"
+                                 "  WHERE blockid = ?;",
+                                 -1,
+                                 &derivedStmt,
+                                 nullptr);
+         if (rc != SQLITE_OK)
+         {
+            SetDBError(
+               XO("Unable to prepare project file command:\n\n%s").Format(sql)
+            );
+            return false;
+         }
+      }
+
       /* i18n-hint: This title appears on a dialog that indicates the progress
          in doing something.*/
       ProgressDialog progress(XO("Progress"), msg, pdlgHideStopButton);
@@ -1173,6 +1414,34 @@ bool ProjectFileIO::CopyTo(const FilePath &destpath,
             THROW_INCONSISTENCY_EXCEPTION;
          }
 
+         // Copy the derived data of the block too
+         if (derivedStmt)
+         {
+            rc = sqlite3_bind_int64(derivedStmt, 1, blockid);
+            if (rc != SQLITE_OK)
+            {
+               SetDBError(
+                  XO("Failed to bind SQL parameter")
+               );
+
+               return false;
+            }
+
+            rc = sqlite3_step(derivedStmt);
+            if (rc != SQLITE_DONE)
+            {
+               SetDBError(
+                  XO("Failed to update the project file.\nThe following command failed:\n\n%s").Format(sql)
+               );
+               return false;
+            }
+
+            if (sqlite3_reset(derivedStmt) != SQLITE_OK)
+            {
+               THROW_INCONSISTENCY_EXCEPTION;
+            }
+         }
+
          result = progress.Update(++count, total);
          if (result != ProgressResult::Success)
          {
@@ -1652,6 +1921,9 @@ void ProjectFileIO::SetFileName(const FilePath &fileName)
 
    mFileName = fileName;
 
+   // The connection may have changed, so start over with a full autosave
+   mpAutoSaveState.reset();
+
    if (!mFileName.empty())
    {
       ActiveProjects::Add(mFileName);
@@ -1777,7 +2049,8 @@ void ProjectFileIO::WriteXMLHeader(XMLWriter &xmlFile) const
 
 void ProjectFileIO::WriteXML(XMLWriter &xmlFile,
                              bool recording /* = false */,
-                             const TrackList *tracks /* = nullptr */)
+                             const TrackList *tracks /* = nullptr */,
+                             const std::function<void()> &beforeTrack /* = {} */)
 // may throw
 {
    auto &proj = mProject;
@@ -1810,9 +2083,14 @@ void ProjectFileIO::WriteXML(XMLWriter &xmlFile,
          // when pushing.  Don't auto-save it.
          return;
       }
+      if (beforeTrack)
+         beforeTrack();
       useTrack->WriteXML(xmlFile);
    });
 
+   if (beforeTrack)
+      beforeTrack();
+
    xmlFile.EndTag(wxT("project"));
 
    //TIMER_STOP( xml_writer_timer );
@@ -1822,17 +2100,221 @@ bool ProjectFileIO::AutoSave(bool recording)
 {
    ProjectSerializer autosave;
    WriteXMLHeader(autosave);
-   WriteXML(autosave, recording);
+   std::vector<size_t> bounds;
+   WriteXML(autosave, recording, nullptr,
+      [&]{ bounds.push_back(autosave.GetData().GetSize()); });
+
+   // Without knowing what the rows hold, rewrite everything
+   const bool success = mpAutoSaveState
+      ? WriteAutoSaveDelta(autosave, bounds)
+      : WriteAutoSaveCheckpoint(autosave, bounds);
 
-   if (WriteDoc("autosave", autosave))
+   if (success)
    {
       mModified = true;
       return true;
    }
 
+   mpAutoSaveState.reset();
    return false;
 }
 
+bool ProjectFileIO::WriteAutoSaveCheckpoint(
+   const ProjectSerializer &autosave, const std::vector<size_t> &bounds)
+{
+   mpAutoSaveState.reset();
+
+   TransactionScope transaction(mProject, "AutoSave");
+
+   // Deltas amending an older autosave doc must go
+   if (!Query(AutoSaveDeltaSchema, [](auto...) { return 0; }) ||
+       !Query("DELETE FROM main.autosavedelta;", [](auto...) { return 0; }))
+      return false;
+
+   if (!WriteDoc("autosave", autosave))
+      return false;
+
+   if (!transaction.Commit())
+      return false;
+
+   const auto &data = autosave.GetData();
+   const auto &dict = autosave.GetDict();
+   auto state = std::make_unique<AutoSaveState>();
+   state->checkpointSize = data.GetSize();
+   state->checkpointHash = HashCheckpoint(
+      dict.GetData(), dict.GetSize(), data.GetData(), data.GetSize());
+   const auto doc = static_cast<const char *>(data.GetData());
+   for (size_t ii = 0; ii + 1 < bounds.size(); ++ii)
+   {
+      const std::string_view bytes{
+         doc + bounds[ii], bounds[ii + 1] - bounds[ii] };
+      const auto hash = std::hash<std::string_view>{}(bytes);
+      if (!AutoSaveState::Find(state->segments, hash, bytes))
+         state->segments.emplace(hash,
+            std::make_shared<AutoSaveState::Segment>(
+               AutoSaveState::Segment{ std::string{ bytes }, 0, bounds[ii] }));
+   }
+   mpAutoSaveState = std::move(state);
+
+   return true;
+}
+
+bool ProjectFileIO::WriteAutoSaveDelta(
+   const ProjectSerializer &autosave, const std::vector<size_t> &bounds)
+{
+   auto &state = *mpAutoSaveState;
+   using SegmentPtr = AutoSaveState::SegmentPtr;
+
+   const auto &data = autosave.GetData();
+   const auto doc = static_cast<const char *>(data.GetData());
+   const auto size = data.GetSize();
+   const auto prefixSize = bounds.empty() ? size : bounds.front();
+   const auto suffixStart = bounds.empty() ? size : bounds.back();
+
+   // Find the segment for each track, reusing unchanged ones
+   AutoSaveState::Segments segments;
+   std::vector<SegmentPtr> tracks, added;
+   auto nextRow = state.nextRow;
+   size_t deltaSize = 0;
+   for (size_t ii = 0; ii + 1 < bounds.size(); ++ii)
+   {
+      const std::string_view bytes{
+         doc + bounds[ii], bounds[ii + 1] - bounds[ii] };
+      const auto hash = std::hash<std::string_view>{}(bytes);
+      auto pSegment = AutoSaveState::Find(segments, hash, bytes);
+      if (!pSegment)
+      {
+         pSegment = AutoSaveState::Find(state.segments, hash, bytes);
+         if (!pSegment)
+         {
+            pSegment = std::make_shared<AutoSaveState::Segment>(
+               AutoSaveState::Segment{ std::string{ bytes }, nextRow++, 0 });
+            added.push_back(pSegment);
+         }
+         segments.emplace(hash, pSegment);
+         if (pSegment->row != 0)
+            deltaSize += bytes.size();
+      }
+      tracks.push_back(pSegment);
+   }
+
+   // Compact when the deltas outgrow a fraction of the document, so that
+   // neither the file nor the time to recover grows without bound
+   if (deltaSize > state.checkpointSize / 2)
+      return WriteAutoSaveCheckpoint(autosave, bounds);
+
+   std::vector<uint8_t> head;
+   AppendInt(head, state.checkpointSize);
+   AppendInt(head, state.checkpointHash);
+   AppendBytes(head, { doc, prefixSize });
+   AppendInt(head, tracks.size());
+   for (const auto &pSegment : tracks)
+   {
+      AppendInt(head, pSegment->row);
+      AppendInt(head, pSegment->offset);
+      AppendInt(head, pSegment->bytes.size());
+   }
+   AppendBytes(head, { doc + suffixStart, size - suffixStart });
+
+   TransactionScope transaction(mProject, "AutoSave");
+
+   auto db = DB();
+   sqlite3_stmt *stmt = nullptr;
+   auto cleanup = finally([&]
+   {
+      if (stmt)
+      {
+         sqlite3_finalize(stmt);
+      }
+   });
+
+   const auto prepare = [&](const char *sql)
+   {
+      if (stmt)
+         sqlite3_finalize(stmt);
+      stmt = nullptr;
+      if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+      {
+         SetDBError(
+            XO("Unable to prepare project file command:\n\n%s").Format(sql)
+         );
+         return false;
+      }
+      return true;
+   };
+
+   const auto step = [&](const char *sql)
+   {
+      if (sqlite3_step(stmt) != SQLITE_DONE)
+      {
+         SetDBError(
+            XO("Failed to update the project file.\nThe following command failed:\n\n%s").Format(sql)
+         );
+         return false;
+      }
+      sqlite3_reset(stmt);
+      return true;
+   };
+
+   const char *insertSql =
+      "INSERT INTO main.autosavedelta(id, dict, doc) VALUES(?1, NULL, ?2);";
+   if (!prepare(insertSql))
+      return false;
+   for (const auto &pSegment : added)
+   {
+      if (sqlite3_bind_int64(stmt, 1, pSegment->row) ||
+          sqlite3_bind_blob64(stmt, 2, pSegment->bytes.data(),
+             pSegment->bytes.size(), SQLITE_STATIC))
+      {
+         SetDBError(XO("Unable to bind to blob"));
+         return false;
+      }
+      if (!step(insertSql))
+         return false;
+   }
+
+   const char *headSql =
+      "INSERT INTO main.autosavedelta(id, dict, doc) VALUES(0, ?1, ?2)"
+      "       ON CONFLICT(id) DO UPDATE SET dict = ?1, doc = ?2;";
+   if (!prepare(headSql))
+      return false;
+   const auto &dict = autosave.GetDict();
+   if (sqlite3_bind_blob64(stmt, 1, dict.GetData(), dict.GetSize(),
+          SQLITE_STATIC) ||
+       sqlite3_bind_blob64(stmt, 2, head.data(), head.size(), SQLITE_STATIC))
+   {
+      SetDBError(XO("Unable to bind to blob"));
+      return false;
+   }
+   if (!step(headSql))
+      return false;
+
+   // Delete the rows of tracks that changed or went away
+   const char *deleteSql = "DELETE FROM main.autosavedelta WHERE id = ?1;";
+   if (!prepare(deleteSql))
+      return false;
+   for (const auto &[hash, pSegment] : state.segments)
+   {
+      if (pSegment->row == 0 ||
+          AutoSaveState::Find(segments, hash, pSegment->bytes))
+         continue;
+      if (sqlite3_bind_int64(stmt, 1, pSegment->row) || !step(deleteSql))
+         return false;
+   }
+
+   sqlite3_finalize(stmt);
+   stmt = nullptr;
+
+   if (!WriteRequiredVersion() || !transaction.Commit())
+      return false;
+
+   state.segments = std::move(segments);
+   state.deltaSize = deltaSize;
+   state.nextRow = nextRow;
+
+   return true;
+}
+
 bool ProjectFileIO::AutoSaveDelete(sqlite3 *db /* = nullptr */)
 {
    int rc;
@@ -1842,7 +2324,11 @@ bool ProjectFileIO::AutoSaveDelete(sqlite3 *db /* = nullptr */)
       db = DB();
    }
 
-   rc = sqlite3_exec(db, "DELETE FROM autosave;", nullptr, nullptr, nullptr);
+   mpAutoSaveState.reset();
+
+   rc = sqlite3_exec(db,
+      "DELETE FROM autosave;"
+      "DROP TABLE IF EXISTS autosavedelta;", nullptr, nullptr, nullptr);
    if (rc != SQLITE_OK)
    {
       SetDBError(
@@ -1978,6 +2464,14 @@ bool ProjectFileIO::WriteDoc(const char *table,
    if (!writeStream("doc", data))
       return false;
 
+   if (!WriteRequiredVersion())
+      return false;
+
+   return transaction.Commit();
+}
+
+bool ProjectFileIO::WriteRequiredVersion()
+{
    const auto requiredVersion =
       ProjectFormatExtensionsRegistry::Get().GetRequiredVersion(mProject);
 
@@ -1989,11 +2483,89 @@ bool ProjectFileIO::WriteDoc(const char *table,
       // DV: Very unlikely case.
       // Since we need to improve the error messages in the future, let's use
       // the generic message for now, so no new strings are needed
-      reportError(setVersionSql);
+      SetDBError(
+         XO("Failed to update the project file.\nThe following command failed:\n\n%s")
+            .Format(setVersionSql));
       return false;
    }
 
-   return transaction.Commit();
+   return true;
+}
+
+bool ProjectFileIO::ReadAutoSaveDelta(std::vector<uint8_t> &doc)
+{
+   auto db = DB();
+
+   sqlite3_stmt *stmt = nullptr;
+   auto cleanup = finally([&]
+   {
+      if (stmt)
+      {
+         sqlite3_finalize(stmt);
+      }
+   });
+
+   std::vector<uint8_t> head, checkpoint, segment;
+
+   // The dictionary comes first, as in the other documents
+   const char *headSql = "SELECT dict, doc FROM main.autosavedelta WHERE id = ?1;";
+   if (sqlite3_prepare_v2(db, headSql, -1, &stmt, nullptr) != SQLITE_OK ||
+       !ReadBlob(stmt, 0, doc))
+      return false;
+   {
+      auto data = static_cast<const uint8_t *>(sqlite3_column_blob(stmt, 1));
+      head.assign(data, data + sqlite3_column_bytes(stmt, 1));
+   }
+   sqlite3_finalize(stmt);
+   stmt = nullptr;
+
+   uint64_t checkpointHash;
+   const char *checkpointSql =
+      "SELECT doc, dict FROM main.autosave WHERE id = ?1;";
+   if (sqlite3_prepare_v2(db, checkpointSql, -1, &stmt, nullptr) != SQLITE_OK ||
+       !ReadBlob(stmt, 1, checkpoint))
+      return false;
+   checkpointHash = HashCheckpoint(
+      sqlite3_column_blob(stmt, 1), sqlite3_column_bytes(stmt, 1),
+      checkpoint.data(), checkpoint.size());
+   sqlite3_finalize(stmt);
+   stmt = nullptr;
+
+   const char *segmentSql = "SELECT doc FROM main.autosavedelta WHERE id = ?1;";
+   if (sqlite3_prepare_v2(db, segmentSql, -1, &stmt, nullptr) != SQLITE_OK)
+      return false;
+
+   size_t pos = 0;
+   int64_t checkpointSize, headHash, nTracks;
+   if (!ReadInt(head, pos, checkpointSize) ||
+       uint64_t(checkpointSize) != checkpoint.size() ||
+       !ReadInt(head, pos, headHash) ||
+       uint64_t(headHash) != checkpointHash ||
+       !ReadBytes(head, pos, doc) || !ReadInt(head, pos, nTracks))
+      return false;
+   for (int64_t ii = 0; ii < nTracks; ++ii)
+   {
+      int64_t row, offset, length;
+      if (!ReadInt(head, pos, row) || !ReadInt(head, pos, offset) ||
+          !ReadInt(head, pos, length))
+         return false;
+      if (row == 0)
+      {
+         if (offset < 0 || length < 0 ||
+             uint64_t(offset) > checkpoint.size() ||
+             uint64_t(length) > checkpoint.size() - offset)
+            return false;
+         doc.insert(doc.end(), checkpoint.begin() + offset,
+            checkpoint.begin() + offset + length);
+      }
+      else
+      {
+         if (!ReadBlob(stmt, row, segment) || segment.size() != uint64_t(length))
+            return false;
+         doc.insert(doc.end(), segment.begin(), segment.end());
+      }
+   }
+   return ReadBytes(head, pos, doc);
 }
 
 bool ProjectFileIO::LoadProject(const FilePath &fileName, bool ignoreAutosave)
@@ -2045,11 +2617,29 @@ bool ProjectFileIO::LoadProject(const FilePath &fileName, bool ignoreAutosave)
    }
    else
    {
-      // Load 'er up
-      BufferedProjectBlobStream stream(
-         DB(), "main", useAutosave ? "autosave" : "project", rowId);
+      // Load 'er up, with any deltas amending the autosave
+      int64_t deltaRowId = -1;
+      std::vector<uint8_t> doc;
+      if (useAutosave &&
+          GetValue("SELECT ROWID FROM main.autosavedelta WHERE id = 0;",
+             deltaRowId, true) &&
+          !ReadAutoSaveDelta(doc))
+      {
+         wxLogWarning("Failed to read autosave deltas; using the last full autosave");
+         doc.clear();
+      }
 
-      success = ProjectSerializer::Decode(stream, this);
+      if (!doc.empty())
+      {
+         BufferedMemoryStream stream(std::move(doc));
+         success = ProjectSerializer::Decode(stream, this);
+      }
+      else
+      {
+         BufferedProjectBlobStream stream(
+            DB(), "main", useAutosave ? "autosave" : "project", rowId);
+         success = ProjectSerializer::Decode(stream, this);
+      }
 
       if (!success)
       {
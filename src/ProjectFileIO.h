@@ -11,8 +11,11 @@ Paul Licameli split from TenacityProject.h
 #ifndef __AUDACITY_PROJECT_FILE_IO__
 #define __AUDACITY_PROJECT_FILE_IO__
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include <wx/event.h>
 
@@ -91,6 +94,8 @@ public:
    bool IsTemporary() const;
    bool IsRecovered() const;
 
+   //! Write the project for recovery; only the tracks changed since the
+   //! last autosave, when that is cheaper than rewriting the whole document
    bool AutoSave(bool recording = false);
    bool AutoSaveDelete(sqlite3 *db = nullptr);
 
@@ -120,6 +125,11 @@ public:
    // specific database. This is the workhorse for the above 3 methods.
    static int64_t GetDiskUsage(DBConnection &conn, SampleBlockID blockid);
 
+   //! Create the table of data derived from sample blocks, and its trigger,
+   //! unless the schema has them already
+   static bool InstallDerivedDataSchema(
+      sqlite3 *db, const char *schema = "main");
+
    // Displays an error dialog with a button that offers help
    void ShowError(const GenericUI::WindowPlacement &placement,
                   const TranslatableString &dlogTitle,
@@ -209,8 +219,11 @@ private:
    void OnCheckpointFailure();
 
    void WriteXMLHeader(XMLWriter &xmlFile) const;
+   //! @param beforeTrack called before each track is written, and after the
+   //! last one
    void WriteXML(XMLWriter &xmlFile, bool recording = false,
-      const TrackList *tracks = nullptr) /* not override */;
+      const TrackList *tracks = nullptr,
+      const std::function<void()> &beforeTrack = {}) /* not override */;
 
    // XMLTagHandler callback methods
    bool HandleXMLTag(const std::string_view& tag, const AttributesList &attrs) override;
@@ -251,6 +264,17 @@ private:
 
    // Write project or autosave XML (binary) documents
    bool WriteDoc(const char *table, const ProjectSerializer &autosave, const char *schema = "main");
+   bool WriteRequiredVersion();
+
+   // Write the whole autosave document, or only its changed tracks; bounds
+   // are the positions in the document where tracks begin, and the end of
+   // the last one
+   bool WriteAutoSaveCheckpoint(
+      const ProjectSerializer &autosave, const std::vector<size_t> &bounds);
+   bool WriteAutoSaveDelta(
+      const ProjectSerializer &autosave, const std::vector<size_t> &bounds);
+   // Reassemble the autosave document from the checkpoint and the deltas
+   bool ReadAutoSaveDelta(std::vector<uint8_t> &doc);
 
    // Application defined function to verify blockid exists is in set of blockids
    static void InSet(sqlite3_context *context, int argc, sqlite3_value **argv);
@@ -312,6 +336,10 @@ private:
    Connection mPrevConn;
    FilePath mPrevFileName;
    bool mPrevTemporary;
+
+   // What the autosave rows of the current connection hold
+   struct AutoSaveState;
+   std::unique_ptr<AutoSaveState> mpAutoSaveState;
 };
 
 class wxTopLevelWindow;
@@ -19,11 +19,14 @@ Paul Licameli split from TenacityProject.cpp
 #include <wx/frame.h>
 #include <wx/log.h>
 
+#include <algorithm>
+#include <chrono>
 #include <optional>
 
 // Tenacity libraries
 #include <lib-basic-ui/BasicUI.h>
 #include <lib-string-utils/CodeConversions.h>
+#include <lib-utility/ThreadPool.h>
 #include <lib-xml/XMLFileReader.h>
 
 #include "Legacy.h"
@@ -52,9 +55,11 @@ Paul Licameli split from TenacityProject.cpp
 #include "export/Export.h"
 #include "import/Import.h"
 #include "import/ImportMIDI.h"
+#include "import/ImportPlugin.h"
 #include "toolbars/SelectionBar.h"
 #include "widgets/AudacityMessageBox.h"
 #include "widgets/FileHistory.h"
+#include "widgets/ProgressDialog.h"
 #include "widgets/UnwritableLocationErrorDialog.h"
 #include "widgets/Warning.h"
 #include "widgets/wxPanelWrapper.h"
@@ -1346,6 +1351,136 @@ bool ProjectFileManager::Import(
    return true;
 }
 
+namespace {
+//! Whether a file must go through the other overload of Import()
+bool ImportsOnlyInForeground(const FilePath &fileName)
+{
+#ifdef USE_MIDI
+   if (FileNames::IsMidi(fileName))
+      return true;
+#endif
+   const auto extension = fileName.AfterLast('.');
+   for (auto special : { wxT("aup"), wxT("aup3"), wxT("lof"), wxT("doc") })
+      if (extension.IsSameAs(special, false))
+         return true;
+   return false;
+}
+}
+
+void ProjectFileManager::Import(
+   const wxArrayString &fileNames, bool addToHistory /* = true */)
+{
+   auto &project = mProject;
+   auto &trackFactory = WaveTrackFactory::Get( project );
+   auto &pool = ThreadPool::Get();
+
+   struct BackgroundImport {
+      std::unique_ptr<ImportFileHandle> handle;
+      std::shared_ptr<Tags> tags;
+      TrackHolders tracks;
+      LabelHolders labels;
+      std::future<ProgressResult> result;
+   };
+   std::vector<BackgroundImport> imports(fileNames.size());
+   ImportFileHandle::BackgroundProgress progress;
+   // Workers refer to the imports until they finish
+   auto waitAll = finally([&]{
+      for (auto &import : imports)
+         if (import.result.valid())
+            import.result.wait();
+   });
+
+   // Open files, and make their tracks, in this thread
+   size_t nBackground = 0;
+   if (pool.GetNumThreads() > 0 && fileNames.size() > 1) {
+      for (size_t ii = 0; ii < fileNames.size(); ++ii) {
+         if (ImportsOnlyInForeground(fileNames[ii]))
+            continue;
+         auto &import = imports[ii];
+         import.handle =
+            Importer::Get().OpenForBackground(project, fileNames[ii]);
+         if (!import.handle)
+            continue;
+         // Tags are constructed with defaults from preferences; importers
+         // only add to them
+         import.tags = std::make_shared<Tags>();
+         import.tags->Clear();
+         import.handle->PrepareBackgroundImport(&trackFactory, progress);
+         ++nBackground;
+      }
+   }
+
+   // One file gains nothing from another thread
+   if (nBackground < 2)
+      for (auto &import : imports)
+         import.handle.reset();
+   else {
+      auto cleanup = valueRestorer( project.mbBusyImporting, true );
+      for (auto &import : imports) {
+         if (!import.handle)
+            continue;
+         import.result = pool.Async([&import, &trackFactory]{
+            return import.handle->Import(&trackFactory,
+               import.tracks, import.tags.get(), import.labels);
+         });
+      }
+
+      // All must finish before any result is used, or any is destroyed
+      ProgressDialog dialog(XO("Importing"),
+         XO("Importing %d files").Format( static_cast<int>(nBackground) ),
+         pdlgHideStopButton);
+      for (auto &import : imports) {
+         if (!import.handle)
+            continue;
+         while (import.result.wait_for(std::chrono::milliseconds(50)) !=
+                std::future_status::ready) {
+            const wxLongLong_t done = progress.done.load();
+            const wxLongLong_t total = progress.total.load();
+            if (dialog.Update(done, total) != ProgressResult::Success)
+               progress.cancelled = true;
+         }
+      }
+   }
+
+   // Add the tracks of each file in order, in this thread, where they
+   // are also destroyed if not added
+   for (size_t ii = 0; ii < fileNames.size(); ++ii) {
+      const auto &fileName = fileNames[ii];
+      auto &import = imports[ii];
+      if (!import.handle) {
+         Import(fileName, addToHistory);
+         continue;
+      }
+
+      const auto res = import.result.get();
+      if (res == ProgressResult::Cancelled)
+         break;
+      if (res == ProgressResult::Failed)
+         continue;
+
+      auto &tracks = import.tracks;
+      tracks.erase(std::remove_if(tracks.begin(), tracks.end(),
+         std::mem_fn( &TrackHolders::value_type::empty )), tracks.end());
+      if (tracks.empty()) {
+         // Let another plugin try, and report any error as usual
+         Import(fileName, addToHistory);
+         continue;
+      }
+
+      auto newTags = Tags::Get( project ).Duplicate();
+      newTags->Merge(*import.tags);
+      Tags::Set( project, newTags );
+
+      if (addToHistory) {
+         FileHistory::Global().Append(fileName);
+      }
+
+      // PRL: Undo history is incremented inside this:
+      AddImportedTracks(fileName,
+         std::move(import.tracks), std::move(import.labels));
+   }
+}
+
 #include "Clipboard.h"
 #include "shuttle/ShuttleGui.h"
 #include "widgets/HelpSystem.h"
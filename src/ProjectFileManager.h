@@ -102,6 +102,15 @@ public:
    bool Import(const FilePath &fileName,
                bool addToHistory = true);
 
+   //! Import several files, decoding those that allow it concurrently
+   /*!
+    Tracks are added, and the undo history pushed, for each file in order
+    as if by the other overload.  Files that can't be imported in the
+    background are imported by the other overload, in their turn.
+    */
+   void Import(const wxArrayString &fileNames,
+               bool addToHistory = true);
+
    void Compact();
 
    void AddImportedTracks(const FilePath &fileName,
@@ -17,6 +17,8 @@ Paul Licameli split from ProjectManager.cpp
 #include "UndoManager.h"
 #include "ViewInfo.h"
 
+#include <vector>
+
 static TenacityProject::AttachedObjects::RegisteredFactory sProjectHistoryKey {
    []( TenacityProject &project ) {
       return std::make_shared< ProjectHistory >( project );
@@ -158,12 +160,25 @@ void ProjectHistory::PopState(const UndoState &state, bool doAutosave)
 
    TrackList *const tracks = state.tracks.get();
 
+   // Clips of the state that the project still has unchanged are not copied
+   // again; the project's own clip objects move to the restored tracks.  The
+   // project never shares its clips with undo states, and the tracks that
+   // shared them are discarded below, before anything can modify them.
+   // Tracks pair by position, as in UndoManager, because ids differ.
+   std::vector<const Track *> oldTracks;
+   for (auto t : dstTracks.Any())
+      oldTracks.push_back(t);
+   std::vector<Track::Holder> restored;
+   for (auto t : tracks->Any()) {
+      const auto ii = restored.size();
+      restored.push_back(t->DuplicateForUndo(
+         ii < oldTracks.size() ? oldTracks[ii] : nullptr));
+   }
+
    dstTracks.Clear();
 
-   for (auto t : tracks->Any())
-   {
-      dstTracks.Add(t->Duplicate());
-   }
+   for (auto &t : restored)
+      dstTracks.Add(t);
 
 }
 
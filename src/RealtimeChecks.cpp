@@ -0,0 +1,248 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file RealtimeChecks.cpp
+
+*******************************************************************//*!
+
+\namespace RealtimeChecks
+\brief Reports allocations and locks by threads that must not wait
+
+  The hooks run inside the allocator, so they only touch thread-local
+  counters and a fixed array of records, and allocate nothing themselves.
+
+*//*******************************************************************/
+
+#include "RealtimeChecks.h"
+
+#ifdef USE_REALTIME_CHECKS
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#define REALTIME_CHECKS_GLIBC
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define REALTIME_CHECKS_BACKTRACE
+#include <execinfo.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__)
+// No lazy allocation of thread-local storage inside the allocator
+#define REALTIME_CHECKS_TLS \
+   thread_local __attribute__((tls_model("initial-exec")))
+#else
+#define REALTIME_CHECKS_TLS thread_local
+#endif
+
+namespace {
+
+REALTIME_CHECKS_TLS int tChecking = 0;
+REALTIME_CHECKS_TLS int tAllowed = 0;
+//! Prevents recursion when recording itself allocates or locks
+REALTIME_CHECKS_TLS bool tRecording = false;
+
+constexpr size_t MaxFrames = 32;
+constexpr size_t MaxViolations = 256;
+
+struct Violation {
+   const char *what;
+   int nFrames;
+   void *frames[MaxFrames];
+};
+
+Violation gViolations[MaxViolations];
+std::atomic<size_t> gnViolations{ 0 };
+
+void Record(const char *what)
+{
+   if (tChecking == 0 || tAllowed > 0 || tRecording)
+      return;
+   tRecording = true;
+   const auto index = gnViolations.fetch_add(1, std::memory_order_relaxed);
+   if (index < MaxViolations) {
+      auto &violation = gViolations[index];
+      violation.what = what;
+#ifdef REALTIME_CHECKS_BACKTRACE
+      violation.nFrames = backtrace(violation.frames, MaxFrames);
+#else
+      violation.nFrames = 0;
+#endif
+   }
+   tRecording = false;
+}
+
+#ifdef REALTIME_CHECKS_BACKTRACE
+//! The first backtrace() may load a library and allocate, so do it early
+struct BacktracePrimer {
+   BacktracePrimer()
+   {
+      void *frame;
+      backtrace(&frame, 1);
+   }
+} sBacktracePrimer;
+#endif
+
+}
+
+namespace RealtimeChecks {
+
+Scope::Scope()
+{
+   ++tChecking;
+}
+
+Scope::~Scope()
+{
+   --tChecking;
+}
+
+Allowance::Allowance()
+{
+   ++tAllowed;
+}
+
+Allowance::~Allowance()
+{
+   --tAllowed;
+}
+
+size_t Report()
+{
+   const auto count = gnViolations.exchange(0);
+   const auto kept = std::min(count, MaxViolations);
+   for (size_t ii = 0; ii < kept; ++ii) {
+      const auto &violation = gViolations[ii];
+      fprintf(stderr, "Realtime check %zu of %zu: %s\n",
+         ii + 1, count, violation.what);
+#ifdef REALTIME_CHECKS_BACKTRACE
+      backtrace_symbols_fd(violation.frames, violation.nFrames, STDERR_FILENO);
+#endif
+   }
+   return count;
+}
+
+}
+
+#ifdef REALTIME_CHECKS_GLIBC
+
+// Interpose the C library's allocator, which operator new also uses, and
+// the lock underlying std::mutex
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+   Record("malloc");
+   return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+   Record("calloc");
+   return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+   Record("realloc");
+   return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+   if (ptr)
+      Record("free");
+   __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+   using Function = int (*)(pthread_mutex_t *);
+   // Not a function-local static, whose guard would take a lock
+   static std::atomic<Function> next{ nullptr };
+   auto function = next.load(std::memory_order_acquire);
+   if (!function) {
+      function = reinterpret_cast<Function>(
+         dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+      next.store(function, std::memory_order_release);
+   }
+   Record("pthread_mutex_lock");
+   return function(mutex);
+}
+
+}
+
+#else
+
+// Only C++ allocations can be caught portably
+
+void *operator new(std::size_t size)
+{
+   Record("operator new");
+   if (auto ptr = std::malloc(size ? size : 1))
+      return ptr;
+   throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size)
+{
+   Record("operator new[]");
+   if (auto ptr = std::malloc(size ? size : 1))
+      return ptr;
+   throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+   Record("operator new");
+   return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+   Record("operator new[]");
+   return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept
+{
+   if (ptr)
+      Record("operator delete");
+   std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+   if (ptr)
+      Record("operator delete[]");
+   std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+   operator delete(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+   operator delete[](ptr);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file RealtimeChecks.h
+@brief Reports allocations and locks by threads that must not wait
+
+**********************************************************************/
+
+#ifndef __AUDACITY_REALTIME_CHECKS__
+#define __AUDACITY_REALTIME_CHECKS__
+
+#include <cstddef>
+
+//! A debugging aid for the audio callback, enabled by the REALTIME_CHECKS
+//! build option
+/*!
+ In such a build, while a Scope exists in a thread, each memory allocation
+ or release, and each lock of a mutex, is recorded with its stack.  Report()
+ writes the records to standard error.
+
+ Allocations are caught in operator new and delete everywhere, and in
+ malloc and free with the GNU C library.  Locks are caught only with the
+ GNU C library, by interposing pthread_mutex_lock.
+
+ In other builds, these classes are empty and Report() does nothing.
+ */
+namespace RealtimeChecks {
+
+#ifdef USE_REALTIME_CHECKS
+
+//! Check the current thread while this exists; may nest
+class TENACITY_DLL_API Scope final
+{
+public:
+   Scope();
+   ~Scope();
+   Scope(const Scope &) = delete;
+   Scope &operator=(const Scope &) = delete;
+};
+
+//! Suspend the checks of the current thread, where waiting is intended
+class TENACITY_DLL_API Allowance final
+{
+public:
+   Allowance();
+   ~Allowance();
+   Allowance(const Allowance &) = delete;
+   Allowance &operator=(const Allowance &) = delete;
+};
+
+//! Write and forget the violations recorded so far; call only where
+//! allocation is allowed
+/*! @return how many were recorded, including any not kept for lack of room */
+TENACITY_DLL_API size_t Report();
+
+#else
+
+class Scope final
+{
+public:
+   Scope() {}
+   Scope(const Scope &) = delete;
+   Scope &operator=(const Scope &) = delete;
+};
+
+class Allowance final
+{
+public:
+   Allowance() {}
+   Allowance(const Allowance &) = delete;
+   Allowance &operator=(const Allowance &) = delete;
+};
+
+inline size_t Report() { return 0; }
+
+#endif
+
+}
+
+#endif
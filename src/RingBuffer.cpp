@@ -15,7 +15,12 @@
   Assuming that there is only one thread writing, and one thread reading,
   this class implements a lock-free thread-safe bounded queue of samples
   with atomic variables that contain the first filled and free positions.
-                                                                     
+
+  There may be several channels, which are all written, and all read, together
+  under the one pair of atomic variables.  Rather than copy samples in and out,
+  the writer and the reader may be given Regions of the storage, at most two
+  contiguous Spans for each channel, and work in place, before they commit.
+
   If two threads both need to read, or both need to write, they need to lock
   this class from outside using their own mutex.
 
@@ -30,10 +35,19 @@
 // Tenacity libraries
 #include <lib-math/Dither.h>
 
-RingBuffer::RingBuffer(sampleFormat format, size_t size)
-   : mFormat{ format }
-   , mBufferSize{ std::max<size_t>(size, 64) }
-   , mBuffer{ mBufferSize, mFormat }
+auto RingBuffer::Region::After(size_t n) const -> Region
+{
+   if (n < first.length)
+      return { { first.start + n, first.length - n }, second };
+   n = std::min(n - first.length, second.length);
+   return { { second.start + n, second.length - n }, {} };
+}
+
+RingBuffer::RingBuffer(sampleFormat format, size_t size, size_t nChannels)
+   : mBufferSize{ std::max<size_t>(size, 64) }
+   , mChannels{ std::max<size_t>(nChannels, 1) }
+   , mFormat{ format }
+   , mBuffer{ mBufferSize * mChannels, mFormat }
 {
 }
 
@@ -54,11 +68,46 @@ size_t RingBuffer::Free( size_t start, size_t end )
    return std::max<size_t>(mBufferSize - Filled( start, end ), 4) - 4;
 }
 
+auto RingBuffer::MakeRegion( size_t start, size_t length ) -> Region
+{
+   const auto first = std::min( length, mBufferSize - start );
+   return { { start, first }, { 0, length - first } };
+}
+
+void RingBuffer::Write(size_t channel, const Region &region,
+   constSamplePtr buffer, sampleFormat format, unsigned stride)
+{
+   for (auto &span : { region.first, region.second }) {
+      CopySamples(buffer, format,
+                  GetPtr(channel, span.start), mFormat,
+                  span.length, DitherType::none, stride);
+      buffer += span.length * stride * SAMPLE_SIZE(format);
+   }
+}
+
+void RingBuffer::Clear(size_t channel, const Region &region)
+{
+   for (auto &span : { region.first, region.second })
+      ClearSamples(GetPtr(channel, 0), mFormat, span.start, span.length);
+}
+
+void RingBuffer::Read(size_t channel, const Region &region,
+   samplePtr buffer, sampleFormat format)
+{
+   for (auto &span : { region.first, region.second }) {
+      CopySamples(GetPtr(channel, span.start), mFormat,
+                  buffer, format,
+                  span.length, DitherType::none);
+      buffer += span.length * SAMPLE_SIZE(format);
+   }
+}
+
 //
 // For the writer only:
 // Only writer writes the end, so it can read it again relaxed
 // And it reads the start written by reader, with acquire order,
-// so that any reading done in Get() happens-before any reuse of the space.
+// so that any reading done before CommitGet() happens-before any reuse of
+// the space.
 //
 
 size_t RingBuffer::AvailForPut()
@@ -71,69 +120,20 @@ size_t RingBuffer::AvailForPut()
    // never decrease it, so writer can safely assume this much at least
 }
 
-size_t RingBuffer::Put(constSamplePtr buffer, sampleFormat format,
-                    size_t samplesToCopy, size_t padding)
+auto RingBuffer::GetWritable(size_t samples) -> Region
 {
    auto start = mStart.load( std::memory_order_acquire );
    auto end = mEnd.load( std::memory_order_relaxed );
-   const auto free = Free( start, end );
-   samplesToCopy = std::min( samplesToCopy, free );
-   padding = std::min( padding, free - samplesToCopy );
-   auto src = buffer;
-   size_t copied = 0;
-   auto pos = end;
-
-   while ( samplesToCopy ) {
-      auto block = std::min( samplesToCopy, mBufferSize - pos );
-
-      CopySamples(src, format,
-                  mBuffer.ptr() + pos * SAMPLE_SIZE(mFormat), mFormat,
-                  block, DitherType::none);
-
-      src += block * SAMPLE_SIZE(format);
-      pos = (pos + block) % mBufferSize;
-      samplesToCopy -= block;
-      copied += block;
-   }
-
-   while ( padding ) {
-      const auto block = std::min( padding, mBufferSize - pos );
-      ClearSamples( mBuffer.ptr(), mFormat, pos, block );
-      pos = (pos + block) % mBufferSize;
-      padding -= block;
-      copied += block;
-   }
-
-   // Atomically update the end pointer with release, so the nonatomic writes
-   // just done to the buffer don't get reordered after
-   mEnd.store(pos, std::memory_order_release);
-
-   return copied;
+   return MakeRegion( end, std::min( samples, Free( start, end ) ) );
 }
 
-size_t RingBuffer::Clear(sampleFormat format, size_t samplesToClear)
+void RingBuffer::CommitPut(size_t samples)
 {
-   auto start = mStart.load( std::memory_order_acquire );
    auto end = mEnd.load( std::memory_order_relaxed );
-   samplesToClear = std::min( samplesToClear, Free( start, end ) );
-   size_t cleared = 0;
-   auto pos = end;
-
-   while(samplesToClear) {
-      auto block = std::min( samplesToClear, mBufferSize - pos );
-
-      ClearSamples(mBuffer.ptr(), format, pos, block);
-
-      pos = (pos + block) % mBufferSize;
-      samplesToClear -= block;
-      cleared += block;
-   }
 
    // Atomically update the end pointer with release, so the nonatomic writes
    // just done to the buffer don't get reordered after
-   mEnd.store(pos, std::memory_order_release);
-
-   return cleared;
+   mEnd.store( (end + samples) % mBufferSize, std::memory_order_release );
 }
 
 //
@@ -154,35 +154,22 @@ size_t RingBuffer::AvailForGet()
    // never decrease them, so reader can safely assume this much at least
 }
 
-size_t RingBuffer::Get(samplePtr buffer, sampleFormat format,
-                       size_t samplesToCopy)
+auto RingBuffer::GetReadable(size_t samples) -> Region
 {
    // Must match the writer's release with acquire for well defined reads of
    // the buffer
    auto end = mEnd.load( std::memory_order_acquire );
    auto start = mStart.load( std::memory_order_relaxed );
-   samplesToCopy = std::min( samplesToCopy, Filled( start, end ) );
-   auto dest = buffer;
-   size_t copied = 0;
-
-   while(samplesToCopy) {
-      auto block = std::min( samplesToCopy, mBufferSize - start );
-
-      CopySamples(mBuffer.ptr() + start * SAMPLE_SIZE(mFormat), mFormat,
-                  dest, format,
-                  block, DitherType::none);
+   return MakeRegion( start, std::min( samples, Filled( start, end ) ) );
+}
 
-      dest += block * SAMPLE_SIZE(format);
-      start = (start + block) % mBufferSize;
-      samplesToCopy -= block;
-      copied += block;
-   }
+void RingBuffer::CommitGet(size_t samples)
+{
+   auto start = mStart.load( std::memory_order_relaxed );
 
    // Communicate to writer that we have consumed some data,
    // with nonrelaxed ordering
-   mStart.store( start, std::memory_order_release );
-
-   return copied;
+   mStart.store( (start + samples) % mBufferSize, std::memory_order_release );
 }
 
 size_t RingBuffer::Discard(size_t samplesToDiscard)
@@ -18,39 +18,84 @@
 
 class RingBuffer final : public NonInterferingBase {
  public:
-   RingBuffer(sampleFormat format, size_t size);
+   //! A run of positions in the storage, the same for every channel
+   struct Span {
+      size_t start{ 0 };
+      size_t length{ 0 };
+   };
+
+   //! Positions of queued or free samples, which may wrap around the end
+   //! of the storage; then the second span begins at position 0
+   struct Region {
+      Span first, second;
+
+      size_t Length() const { return first.length + second.length; }
+      bool Contiguous() const { return second.length == 0; }
+      //! The part of the region after its first n positions
+      Region After(size_t n) const;
+   };
+
+   RingBuffer(sampleFormat format, size_t size, size_t nChannels = 1);
    ~RingBuffer();
 
+   size_t Channels() const { return mChannels; }
+   sampleFormat Format() const { return mFormat; }
+
+   //! Address of one position in the storage of one channel
+   samplePtr GetPtr(size_t channel, size_t pos)
+   {
+      return mBuffer.ptr() + (channel * mBufferSize + pos) * SAMPLE_SIZE(mFormat);
+   }
+
+   //! Copy into one channel at the positions of a region, without dithering
+   /*! @param stride for reading from interleaved buffers */
+   void Write(size_t channel, const Region &region,
+      constSamplePtr buffer, sampleFormat format, unsigned stride = 1);
+   //! Fill one channel with zeroes at the positions of a region
+   void Clear(size_t channel, const Region &region);
+   //! Copy from one channel at the positions of a region, without dithering
+   void Read(size_t channel, const Region &region,
+      samplePtr buffer, sampleFormat format);
+
    //
    // For the writer only:
    //
 
    size_t AvailForPut();
-   //! Does not apply dithering
-   size_t Put(constSamplePtr buffer, sampleFormat format, size_t samples,
-              // optional number of trailing zeroes
-              size_t padding = 0);
-   size_t Clear(sampleFormat format, size_t samples);
+   //! Free positions at the end of the queue, for writing of all channels
+   //! in place, or with Write() and Clear()
+   Region GetWritable(size_t samples);
+   //! Enqueue the first samples of the region last gotten, in all channels
+   void CommitPut(size_t samples);
 
    //
    // For the reader only:
    //
 
    size_t AvailForGet();
-   //! Does not apply dithering
-   size_t Get(samplePtr buffer, sampleFormat format, size_t samples);
+   //! Queued positions at the start of the queue, for reading of all
+   //! channels in place, or with Read()
+   /*!
+    The reader may also modify the samples in place until it commits.
+    */
+   Region GetReadable(size_t samples);
+   //! Dequeue the first samples of the queue, in all channels
+   void CommitGet(size_t samples);
    size_t Discard(size_t samples);
 
  private:
    size_t Filled( size_t start, size_t end );
    size_t Free( size_t start, size_t end );
+   Region MakeRegion( size_t start, size_t length );
 
    // Align the two atomics to avoid false sharing
    NonInterfering< std::atomic<size_t> > mStart { 0 }, mEnd{ 0 };
 
    const size_t  mBufferSize;
+   const size_t  mChannels;
 
    sampleFormat  mFormat;
+   //! Channels are not interleaved, but stored one after another
    SampleBuffer  mBuffer;
 };
 
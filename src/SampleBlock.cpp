@@ -44,6 +44,18 @@ SampleBlockPtr SampleBlockFactory::CreateSilent(
    return result;
 }
 
+SampleBlockPtr SampleBlockFactory::CreateExtended(
+   const SampleBlockPtr &pPrefix,
+   constSamplePtr src,
+   size_t numsamples,
+   sampleFormat srcformat)
+{
+   auto result = DoCreateExtended(pPrefix, src, numsamples, srcformat);
+   if (!result)
+      THROW_INCONSISTENCY_EXCEPTION;
+   return result;
+}
+
 SampleBlockPtr SampleBlockFactory::CreateFromXML(
    sampleFormat srcformat,
    const AttributesList &attrs)
@@ -54,6 +66,58 @@ SampleBlockPtr SampleBlockFactory::CreateFromXML(
    return result;
 }
 
+bool SampleBlockFactory::GetSamples(const SampleBlockReads &reads,
+   sampleFormat destformat, bool mayThrow)
+{
+   try{ DoGetSamples(reads, destformat); return true; }
+   catch( ... ) {
+      if( mayThrow )
+         throw;
+   }
+
+   // Salvage what can be read, one block at a time
+   bool result = true;
+   for (auto &read : reads)
+      if (read.block->GetSamples(read.dest, destformat,
+            read.offset, read.count, false) != read.count)
+         result = false;
+   return result;
+}
+
+void SampleBlockFactory::DoGetSamples(const SampleBlockReads &reads,
+   sampleFormat destformat)
+{
+   for (auto &read : reads)
+      read.block->GetSamples(read.dest, destformat, read.offset, read.count);
+}
+
+SampleBlockPtr SampleBlockFactory::DoCreateExtended(const SampleBlockPtr &,
+   constSamplePtr src, size_t numsamples, sampleFormat srcformat)
+{
+   return DoCreate(src, numsamples, srcformat);
+}
+
+void SampleBlockFactory::Prefetch(const std::vector<SampleBlockPtr> &)
+{
+}
+
+bool SampleBlockFactory::EnableDerivedData()
+{
+   return false;
+}
+
+bool SampleBlockFactory::LoadDerivedData(
+   const SampleBlock &, const std::string &, std::vector<char> &)
+{
+   return false;
+}
+
+bool SampleBlockFactory::StoreDerivedData(
+   const SampleBlock &, const std::string &, const void *, size_t)
+{
+   return false;
+}
+
 SampleBlock::~SampleBlock() = default;
 
 size_t SampleBlock::GetSamples(samplePtr dest,
@@ -15,7 +15,9 @@ SampleBlock.h
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "XMLTagHandler.h"
 
@@ -59,6 +61,10 @@ public:
 
    virtual size_t GetSampleCount() const = 0;
 
+   //! Whether reading the samples needs no lazy loading of the block, which
+   //! may only be done in the main thread
+   virtual bool IsLoaded() const = 0;
+
    //! Non-throwing, should fill with zeroes on failure
    virtual bool
       GetSummary256(float *dest, size_t frameoffset, size_t numframes) = 0;
@@ -92,6 +98,16 @@ protected:
    virtual MinMaxRMS DoGetMinMaxRMS() const = 0;
 };
 
+//! Describes a range of samples of one block, to be read into a buffer
+struct SampleBlockRead
+{
+   SampleBlock *block;
+   size_t offset; //!< first sample of the block to read
+   size_t count; //!< number of samples to read
+   samplePtr dest;
+};
+using SampleBlockReads = std::vector<SampleBlockRead>;
+
 // Makes a useful function object
 inline std::function< void(const SampleBlock&) >
 BlockSpaceUsageAccumulator (unsigned long long &total)
@@ -125,11 +141,60 @@ public:
       size_t numsamples,
       sampleFormat srcformat);
 
+   //! Like Create(), when the samples begin with all those of another block
+   /*!
+    The factory may reuse summary information of the prefix, making appends
+    to a short last block cheaper.
+    Returns a non-null pointer or else throws an exception
+    */
+   SampleBlockPtr CreateExtended(const SampleBlockPtr &pPrefix,
+      constSamplePtr src,
+      size_t numsamples,
+      sampleFormat srcformat);
+
    // Returns a non-null pointer or else throws an exception
    SampleBlockPtr CreateFromXML(
       sampleFormat srcformat,
       const AttributesList &attrs);
 
+   //! Read samples from several blocks, possibly with fewer queries than
+   //! reading them one at a time
+   /*!
+    If !mayThrow and there is an error, ignores it and fills with zeroes the
+    reads that failed.
+    @return whether all reads succeeded
+    */
+   bool GetSamples(const SampleBlockReads &reads,
+      sampleFormat destformat, bool mayThrow = true);
+
+   //! Hint that the blocks will be read soon
+   /*!
+    The factory may read them now into a cache, or do nothing, as this
+    default implementation does.  May be called from a worker thread.
+    */
+   virtual void Prefetch(const std::vector<SampleBlockPtr> &blocks);
+
+   /*! @name Derived data
+    Data computed from the samples of a block, such as spectra for display,
+    may be kept beside the samples, under a key that names the computation
+    and its parameters, and deleted with the block.  It is only a cache:
+    these functions report failure and do not throw.  The default
+    implementations store nothing.
+    */
+   //! @{
+
+   //! Prepare the storage of derived data; main thread only
+   /*! @return whether the other functions may succeed */
+   virtual bool EnableDerivedData();
+   //! May be called from a worker thread, after EnableDerivedData()
+   virtual bool LoadDerivedData(const SampleBlock &block,
+      const std::string &key, std::vector<char> &data);
+   //! Main thread only
+   virtual bool StoreDerivedData(const SampleBlock &block,
+      const std::string &key, const void *data, size_t size);
+
+   //! @}
+
    using SampleBlockIDs = std::unordered_set<SampleBlockID>;
    /*! @return ids of all sample blocks created by this factory and still extant */
    virtual SampleBlockIDs GetActiveBlockIDs() = 0;
@@ -154,11 +219,21 @@ protected:
       size_t numsamples,
       sampleFormat srcformat) = 0;
 
+   //! The default implementation ignores the prefix and calls DoCreate()
+   virtual SampleBlockPtr DoCreateExtended(const SampleBlockPtr &pPrefix,
+      constSamplePtr src,
+      size_t numsamples,
+      sampleFormat srcformat);
+
    // The override should throw more informative exceptions on error than the
    // default InconsistencyException thrown by CreateFromXML
    virtual SampleBlockPtr DoCreateFromXML(
       sampleFormat srcformat,
       const AttributesList &attrs) = 0;
+
+   //! The default implementation reads the blocks one at a time
+   virtual void DoGetSamples(const SampleBlockReads &reads,
+      sampleFormat destformat);
 };
 
 #endif
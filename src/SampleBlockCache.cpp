@@ -0,0 +1,175 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file SampleBlockCache.cpp
+@brief Implements SampleBlockCache
+
+**********************************************************************//*!
+
+\class SampleBlockCache
+\brief Byte-budgeted LRU cache of the BLOBs of sample blocks.
+
+  A hash map indexes a list ordered by recency of use, so that lookup,
+  insertion, and eviction of the least recently used entry are all
+  constant time.
+
+*//*******************************************************************/
+
+#include "SampleBlockCache.h"
+
+#include <functional>
+
+// Tenacity libraries
+#include <lib-preferences/Prefs.h>
+
+IntSetting SampleBlockCacheSize{ L"/Performance/SampleBlockCacheMB", 64 };
+
+SampleBlockCache &SampleBlockCache::Get()
+{
+   static SampleBlockCache instance;
+   return instance;
+}
+
+SampleBlockCache::SampleBlockCache() = default;
+
+SampleBlockCache::~SampleBlockCache() = default;
+
+size_t SampleBlockCache::KeyHash::operator () (const Key &key) const
+{
+   auto result = std::hash<const void*>{}(key.owner);
+   result ^= std::hash<SampleBlockID>{}(key.id) + 0x9e3779b9 +
+      (result << 6) + (result >> 2);
+   result ^= static_cast<size_t>(key.payload) + 0x9e3779b9 +
+      (result << 6) + (result >> 2);
+   return result;
+}
+
+void SampleBlockCache::SetBudget(size_t bytes)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   mBudget = bytes;
+   Shrink(mBudget);
+}
+
+size_t SampleBlockCache::GetBudget() const
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   return mBudget;
+}
+
+bool SampleBlockCache::IsEnabled() const
+{
+   return GetBudget() > 0;
+}
+
+auto SampleBlockCache::Find(
+   const void *owner, SampleBlockID id, Payload payload) -> Blob
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   auto iter = mIndex.find({ owner, id, payload });
+   if (iter == mIndex.end()) {
+      ++mMisses;
+      return {};
+   }
+
+   ++mHits;
+   // Move to the front without invalidating iterators
+   mList.splice(mList.begin(), mList, iter->second);
+   return iter->second->blob;
+}
+
+bool SampleBlockCache::Contains(
+   const void *owner, SampleBlockID id, Payload payload) const
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   return mIndex.find({ owner, id, payload }) != mIndex.end();
+}
+
+void SampleBlockCache::Insert(
+   const void *owner, SampleBlockID id, Payload payload, Blob blob)
+{
+   if (!blob)
+      return;
+
+   const auto size = blob->size();
+
+   std::lock_guard<std::mutex> guard(mMutex);
+   if (size > mBudget)
+      return;
+
+   const Key key{ owner, id, payload };
+   auto iter = mIndex.find(key);
+   if (iter != mIndex.end())
+      // Another thread read the same payload meanwhile; keep the newer copy
+      Erase(iter->second);
+
+   Shrink(mBudget - size);
+   mList.push_front({ key, std::move(blob) });
+   mIndex.emplace(key, mList.begin());
+   mBytes += size;
+}
+
+void SampleBlockCache::Invalidate(const void *owner, SampleBlockID id)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   for (auto payload :
+      { Payload::Samples, Payload::Summary256, Payload::Summary64k }) {
+      auto iter = mIndex.find({ owner, id, payload });
+      if (iter != mIndex.end())
+         Erase(iter->second);
+   }
+}
+
+void SampleBlockCache::Invalidate(const void *owner)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   for (auto iter = mList.begin(), end = mList.end(); iter != end;) {
+      auto next = std::next(iter);
+      if (iter->key.owner == owner)
+         Erase(iter);
+      iter = next;
+   }
+}
+
+void SampleBlockCache::Clear()
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   mIndex.clear();
+   mList.clear();
+   mBytes = 0;
+}
+
+auto SampleBlockCache::GetStats() const -> Stats
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   Stats result;
+   result.hits = mHits;
+   result.misses = mMisses;
+   result.evictions = mEvictions;
+   result.entries = mIndex.size();
+   result.bytes = mBytes;
+   result.budget = mBudget;
+   return result;
+}
+
+void SampleBlockCache::ResetStats()
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   mHits = mMisses = mEvictions = 0;
+}
+
+void SampleBlockCache::Erase(List::iterator iter)
+{
+   mBytes -= iter->blob->size();
+   mIndex.erase(iter->key);
+   mList.erase(iter);
+}
+
+void SampleBlockCache::Shrink(size_t budget)
+{
+   while (mBytes > budget && !mList.empty()) {
+      Erase(std::prev(mList.end()));
+      ++mEvictions;
+   }
+}
@@ -0,0 +1,129 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file SampleBlockCache.h
+@brief Process-wide least-recently-used cache of sample block payloads
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SAMPLE_BLOCK_CACHE__
+#define __AUDACITY_SAMPLE_BLOCK_CACHE__
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SampleBlock.h"
+
+class IntSetting;
+
+//! Size in megabytes of the SampleBlockCache budget; zero disables the cache
+extern TENACITY_DLL_API IntSetting SampleBlockCacheSize;
+
+///\brief Holds recently read sample and summary BLOBs of sample blocks, so
+/// that repeated reads (repainting, scrubbing, zooming) avoid the database
+/*!
+ Entries are keyed by an opaque owner (the database handle from which the
+ payload was read), the block id, and which payload of the block it is.
+ Block contents never change while the block id exists, so the only
+ invalidation needed is when rows are deleted or the owner goes away.
+
+ All member functions may be called from any thread.
+ */
+class TENACITY_DLL_API SampleBlockCache final
+{
+public:
+   //! Which column of a sample block is cached
+   enum class Payload : unsigned char {
+      Samples,
+      Summary256,
+      Summary64k,
+   };
+
+   //! An immutable copy of one BLOB, which remains valid after eviction
+   using Blob = std::shared_ptr<const std::vector<char>>;
+
+   struct Stats {
+      unsigned long long hits{ 0 };
+      unsigned long long misses{ 0 };
+      unsigned long long evictions{ 0 };
+      size_t entries{ 0 };
+      size_t bytes{ 0 };
+      size_t budget{ 0 };
+   };
+
+   static SampleBlockCache &Get();
+
+   SampleBlockCache();
+   ~SampleBlockCache();
+   SampleBlockCache(const SampleBlockCache&) = delete;
+   SampleBlockCache &operator=(const SampleBlockCache&) = delete;
+
+   //! Change the maximum number of payload bytes held, evicting as needed
+   void SetBudget(size_t bytes);
+   size_t GetBudget() const;
+   bool IsEnabled() const;
+
+   //! @return null on a miss; counts the hit or miss
+   Blob Find(const void *owner, SampleBlockID id, Payload payload);
+
+   //! Test for presence without counting a hit or miss or changing recency
+   bool Contains(const void *owner, SampleBlockID id, Payload payload) const;
+
+   //! Does nothing if the blob alone exceeds the budget
+   void Insert(
+      const void *owner, SampleBlockID id, Payload payload, Blob blob);
+
+   //! Forget all payloads of one block
+   void Invalidate(const void *owner, SampleBlockID id);
+   //! Forget all payloads read from one owner
+   void Invalidate(const void *owner);
+   void Clear();
+
+   Stats GetStats() const;
+   void ResetStats();
+
+private:
+   struct Key {
+      const void *owner;
+      SampleBlockID id;
+      Payload payload;
+
+      bool operator == (const Key &other) const
+      {
+         return owner == other.owner && id == other.id &&
+            payload == other.payload;
+      }
+   };
+
+   struct KeyHash {
+      size_t operator () (const Key &key) const;
+   };
+
+   struct Entry {
+      Key key;
+      Blob blob;
+   };
+
+   // Most recently used entries are at the front
+   using List = std::list<Entry>;
+
+   void Erase(List::iterator iter);
+   void Shrink(size_t budget);
+
+   mutable std::mutex mMutex;
+   List mList;
+   std::unordered_map<Key, List::iterator, KeyHash> mIndex;
+   size_t mBytes{ 0 };
+   size_t mBudget{ 0 };
+
+   unsigned long long mHits{ 0 };
+   unsigned long long mMisses{ 0 };
+   unsigned long long mEvictions{ 0 };
+};
+
+#endif
@@ -221,6 +221,33 @@ bool Sequence::ConvertToSampleFormat(sampleFormat format,
    return true;
 }
 
+namespace {
+//! Accumulate extremes and the sum of squares of float samples
+void Accumulate(const float *samples, size_t len,
+   float &min, float &max, double &sumsq)
+{
+   for (size_t i = 0; i < len; ++i) {
+      const float sample = samples[i];
+      if (sample < min)
+         min = sample;
+      if (sample > max)
+         max = sample;
+      sumsq += static_cast<double>(sample) * sample;
+   }
+}
+
+//! Assign consecutive parts of buffer to the reads, and do them in one batch
+void ReadPartialBlocks(SampleBlockFactory &factory,
+   SampleBlockReads &reads, float *buffer, bool mayThrow)
+{
+   for (auto &read : reads) {
+      read.dest = reinterpret_cast<samplePtr>(buffer);
+      buffer += read.count;
+   }
+   factory.GetSamples(reads, floatSample, mayThrow);
+}
+}
+
 std::pair<float, float> Sequence::GetMinMax(
    sampleCount start, sampleCount len, bool mayThrow) const
 {
@@ -256,7 +283,9 @@ std::pair<float, float> Sequence::GetMinMax(
    // Now we take the first and last blocks into account, noting that the
    // selection may only partly overlap these blocks.  If the overall min/max
    // of either of these blocks is within min...max, then we can ignore them.
-   // If not, we need read some samples and summaries from disk.
+   // If not, we need read some samples from disk, both in one batch.
+   SampleBlockReads reads;
+   size_t total = 0;
    {
       const SeqBlock &theBlock = mBlock[block0];
       const auto &theFile = theBlock.sb;
@@ -272,11 +301,8 @@ std::pair<float, float> Sequence::GetMinMax(
          wxASSERT(maxl0 <= mMaxSamples); // Vaughan, 2011-10-19
          const auto l0 = limitSampleBufferSize ( maxl0, len );
 
-         results = theFile->GetMinMaxRMS(s0, l0, mayThrow);
-         if (results.min < min)
-            min = results.min;
-         if (results.max > max)
-            max = results.max;
+         reads.push_back({ theFile.get(), s0, l0, nullptr });
+         total += l0;
       }
    }
 
@@ -292,14 +318,18 @@ std::pair<float, float> Sequence::GetMinMax(
          const auto l0 = ( start + len - theBlock.start ).as_size_t();
          wxASSERT(l0 <= mMaxSamples); // Vaughan, 2011-10-19
 
-         results = theFile->GetMinMaxRMS(0, l0, mayThrow);
-         if (results.min < min)
-            min = results.min;
-         if (results.max > max)
-            max = results.max;
+         reads.push_back({ theFile.get(), 0, l0, nullptr });
+         total += l0;
       }
    }
 
+   if (!reads.empty()) {
+      Floats buffer{ total };
+      double sumsq = 0;
+      ReadPartialBlocks(*mpFactory, reads, buffer.get(), mayThrow);
+      Accumulate(buffer.get(), total, min, max, sumsq);
+   }
+
    return { min, max };
 }
 
@@ -332,7 +362,9 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
 
    // Now we take the first and last blocks into account, noting that the
    // selection may only partly overlap these blocks.
-   // If not, we need read some samples and summaries from disk.
+   // We need read some samples from disk, both in one batch.
+   SampleBlockReads reads;
+   size_t total = 0;
    {
       const SeqBlock &theBlock = mBlock[block0];
       const auto &sb = theBlock.sb;
@@ -344,10 +376,8 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
       wxASSERT(maxl0 <= mMaxSamples); // Vaughan, 2011-10-19
       const auto l0 = limitSampleBufferSize( maxl0, len );
 
-      auto results = sb->GetMinMaxRMS(s0, l0, mayThrow);
-      const auto partialRMS = results.RMS;
-      sumsq += static_cast<double>(partialRMS) * partialRMS * l0;
-      length += l0;
+      reads.push_back({ sb.get(), s0, l0, nullptr });
+      total += l0;
    }
 
    if (block1 > block0) {
@@ -358,10 +388,16 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
       const auto l0 = ( start + len - theBlock.start ).as_size_t();
       wxASSERT(l0 <= mMaxSamples); // PRL: I think Vaughan missed this
 
-      auto results = sb->GetMinMaxRMS(0, l0, mayThrow);
-      const auto partialRMS = results.RMS;
-      sumsq += static_cast<double>(partialRMS) * partialRMS * l0;
-      length += l0;
+      reads.push_back({ sb.get(), 0, l0, nullptr });
+      total += l0;
+   }
+
+   {
+      Floats buffer{ total };
+      float min = FLT_MAX, max = -FLT_MAX;
+      ReadPartialBlocks(*mpFactory, reads, buffer.get(), mayThrow);
+      Accumulate(buffer.get(), total, min, max, sumsq);
+      length += total;
    }
 
    // PRL: catch bugs like 1320:
@@ -581,6 +617,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
          mBlock[i].start += addedLen;
 
       mNumSamples += addedLen;
+      mSummaries.Truncate(b);
 
       // This consistency check won't throw, it asserts.
       // Proof that we kept consistency is not hard.
@@ -1080,7 +1117,9 @@ bool Sequence::Get(samplePtr buffer, sampleFormat format,
 bool Sequence::Get(int b, samplePtr buffer, sampleFormat format,
    sampleCount start, size_t len, bool mayThrow) const
 {
-   bool result = true;
+   // Describe the parts of all blocks in the range, so that the factory
+   // can fetch them together
+   SampleBlockReads reads;
    while (len) {
       const SeqBlock &block = mBlock[b];
       // start is in block
@@ -1088,15 +1127,20 @@ bool Sequence::Get(int b, samplePtr buffer, sampleFormat format,
       // bstart is not more than block length
       const auto blen = std::min(len, block.sb->GetSampleCount() - bstart);
 
-      if (! Read(buffer, format, block, bstart, blen, mayThrow) )
-         result = false;
+      reads.push_back({ block.sb.get(), bstart, blen, buffer });
 
       len -= blen;
       buffer += (blen * SAMPLE_SIZE(format));
       b++;
       start += blen;
    }
-   return result;
+
+   if (!mpFactory->GetSamples(reads, format, mayThrow)) {
+      wxLogWarning(wxT("Failed to read samples of %ld blocks."),
+                   (long) reads.size());
+      return false;
+   }
+   return true;
 }
 
 // Pass NULL to set silence
@@ -1305,7 +1349,8 @@ SeqBlock::SampleBlockPtr Sequence::DoAppend(
                   addLen);
 
       const auto newLastBlockLen = length + addLen;
-      SampleBlockPtr pBlock = factory.Create(
+      SampleBlockPtr pBlock = factory.CreateExtended(
+         lastBlock.sb,
          buffer2.ptr(),
          newLastBlockLen,
          mSampleFormat);
@@ -1444,6 +1489,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
          mBlock[j].start -= len;
 
       mNumSamples -= len;
+      mSummaries.Truncate(b0);
 
       // This consistency check won't throw, it asserts.
       // Proof that we kept consistency is not hard.
@@ -1622,6 +1668,13 @@ void Sequence::CommitChangesIfConsistent
 
    mBlock.swap(newBlock);
    mNumSamples = numSamples;
+
+   // Keep summaries of the blocks that are unchanged at the front
+   const auto nn = std::min(mBlock.size(), newBlock.size());
+   size_t b = 0;
+   while (b < nn && mBlock[b].sb == newBlock[b].sb)
+      ++b;
+   mSummaries.Truncate(b);
 }
 
 void Sequence::AppendBlocksIfConsistent
@@ -1665,6 +1718,7 @@ void Sequence::AppendBlocksIfConsistent
 
    mNumSamples = numSamples;
    consistent = true;
+   mSummaries.Truncate(prevSize);
 }
 
 void Sequence::DebugPrintf
@@ -20,6 +20,8 @@
 #include <lib-math/SampleFormat.h>
 #include <lib-xml/XMLTagHandler.h>
 
+#include "SummaryPyramid.h"
+
 class SampleBlock;
 class SampleBlockFactory;
 using SampleBlockFactoryPtr = std::shared_ptr<SampleBlockFactory>;
@@ -156,6 +158,11 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
       sampleCount start, sampleCount len, bool mayThrow) const;
    float GetRMS(sampleCount start, sampleCount len, bool mayThrow) const;
 
+   //! Combined summaries of blocks [b0, b1), in time logarithmic in their number
+   /*! No-throw, for display operations */
+   SummaryPyramid::Node SummarizeBlocks(size_t b0, size_t b1) const
+   { return mSummaries.Summarize(mBlock, b0, b1); }
+
    //
    // Getting block size and alignment information
    //
@@ -170,7 +177,7 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
 
    //
    // This should only be used if you really, really know what
-   // you're doing!
+   // you're doing!  (Don't replace blocks through the non-const overload)
    //
 
    BlockArray &GetBlockArray() { return mBlock; }
@@ -201,6 +208,9 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
 
    bool          mErrorOpening{ false };
 
+   //! Summaries of runs of blocks, made as needed
+   mutable SummaryPyramid mSummaries;
+
    //
    // Private methods
    //
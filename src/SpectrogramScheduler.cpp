@@ -0,0 +1,99 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file SpectrogramScheduler.cpp
+@brief Runs spectrogram computations for display on the ThreadPool
+
+**********************************************************************/
+
+#include "SpectrogramScheduler.h"
+
+// Tenacity libraries
+#include <lib-basic-ui/BasicUI.h>
+#include <lib-utility/ThreadPool.h>
+
+#include "DBConnection.h"
+#include "WaveTrack.h"
+
+SpectrogramScheduler &SpectrogramScheduler::Get()
+{
+   static SpectrogramScheduler instance;
+   return instance;
+}
+
+SpectrogramScheduler::SpectrogramScheduler() = default;
+
+SpectrogramScheduler::~SpectrogramScheduler() = default;
+
+SpectrogramScheduler::Job::~Job() = default;
+
+void SpectrogramScheduler::Schedule(const std::shared_ptr<Job> &pJob,
+   size_t nTasks, const SampleBlockFactory *pFactory)
+{
+   if (!pJob)
+      return;
+
+   {
+      std::lock_guard<std::mutex> guard(mMutex);
+      pJob->mpFactory = pFactory;
+      pJob->mGeneration = mGeneration;
+      pJob->mFactoryGeneration = mFactoryGenerations[pFactory];
+   }
+
+   auto &pool = ThreadPool::Get();
+   for (size_t iTask = 0; iTask < nTasks; ++iTask)
+      pool.Submit([this, pJob, iTask]() mutable {
+         if (BeginTask(*pJob)) {
+            pJob->Compute(iTask);
+            EndTask(*pJob);
+         }
+         // Report, and release the job, in the main thread
+         GenericUI::CallAfter([pJob = std::move(pJob), iTask]{
+            if (!pJob->IsCancelled())
+               pJob->OnReady(iTask);
+         });
+      });
+}
+
+void SpectrogramScheduler::Cancel(const SampleBlockFactory *pFactory)
+{
+   std::unique_lock<std::mutex> lock(mMutex);
+   if (!pFactory) {
+      ++mGeneration;
+      mIdle.wait(lock, [this]{ return mBusy.empty(); });
+      return;
+   }
+
+   ++mFactoryGenerations[pFactory];
+   mIdle.wait(lock, [this, pFactory]{ return mBusy.count(pFactory) == 0; });
+}
+
+bool SpectrogramScheduler::BeginTask(Job &job)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   if (job.mGeneration != mGeneration ||
+       job.mFactoryGeneration != mFactoryGenerations[job.mpFactory])
+      job.Cancel();
+   if (job.IsCancelled())
+      return false;
+   mBusy.insert(job.mpFactory);
+   return true;
+}
+
+void SpectrogramScheduler::EndTask(const Job &job)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   mBusy.erase(mBusy.find(job.mpFactory));
+   mIdle.notify_all();
+}
+
+// Stop computing with a connection about to close
+static Observer::Subscription sClosing =
+   DBConnectionClosing::Get().Subscribe(
+      [](const DBConnectionClosingMessage &message)
+{
+   SpectrogramScheduler::Get().Cancel(message.pProject
+      ? WaveTrackFactory::Get(*message.pProject).GetSampleBlockFactory().get()
+      : nullptr);
+} );
@@ -0,0 +1,95 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file SpectrogramScheduler.h
+@brief Runs spectrogram computations for display on the ThreadPool
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SPECTROGRAM_SCHEDULER__
+#define __AUDACITY_SPECTROGRAM_SCHEDULER__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+class SampleBlockFactory;
+
+///\brief Schedules the columns of spectrograms to be computed in the background
+/*!
+ A job is divided into tasks, which are queued in order on the ThreadPool.
+ As each task finishes, the job is told so in the main thread, where it may
+ ask for a repaint.  Jobs that become stale, because the view scrolled or
+ zoomed or the clip changed, are cancelled, and their remaining tasks are
+ skipped.
+
+ Tasks may read sample blocks, so the jobs of a project are cancelled
+ before a database connection of the project closes.
+ */
+class TENACITY_DLL_API SpectrogramScheduler final
+{
+public:
+   static SpectrogramScheduler &Get();
+
+   SpectrogramScheduler();
+   ~SpectrogramScheduler();
+   SpectrogramScheduler(const SpectrogramScheduler&) = delete;
+   SpectrogramScheduler &operator=(const SpectrogramScheduler&) = delete;
+
+   class TENACITY_DLL_API Job
+   {
+   public:
+      virtual ~Job();
+
+      //! Skip the tasks not yet started, and don't report the others; any thread
+      void Cancel() { mCancelled = true; }
+      bool IsCancelled() const { return mCancelled; }
+
+   protected:
+      //! Do one task, in a worker thread; it must not throw
+      virtual void Compute(size_t iTask) = 0;
+      //! Called in the main thread after Compute(iTask), unless cancelled
+      virtual void OnReady(size_t iTask) = 0;
+
+   private:
+      friend SpectrogramScheduler;
+      std::atomic<bool> mCancelled{ false };
+      const SampleBlockFactory *mpFactory{};
+      unsigned mGeneration{ 0 };
+      unsigned mFactoryGeneration{ 0 };
+   };
+
+   //! Queue tasks [0, nTasks) of the job; main thread
+   /*!
+    The last reference to the job is always released in the main thread, so
+    that it may own tracks and sample blocks.
+    @param pFactory of the blocks that the tasks read
+    */
+   void Schedule(const std::shared_ptr<Job> &pJob, size_t nTasks,
+      const SampleBlockFactory *pFactory);
+
+   //! Cancel the scheduled jobs reading blocks of one factory, or all jobs
+   //! if it is null, and wait for their tasks in progress
+   /*! Called before a connection of the factory's project closes */
+   void Cancel(const SampleBlockFactory *pFactory);
+
+private:
+   bool BeginTask(Job &job);
+   void EndTask(const Job &job);
+
+   std::mutex mMutex;
+   std::condition_variable mIdle;
+   //! Factories of the tasks in progress, once for each
+   std::multiset<const SampleBlockFactory*> mBusy;
+   //! Increased to cancel all jobs
+   unsigned mGeneration{ 0 };
+   //! Increased to cancel the jobs of one factory
+   std::unordered_map<const SampleBlockFactory*, unsigned> mFactoryGenerations;
+};
+
+#endif
@@ -8,14 +8,21 @@ Paul Licameli -- split from SampleBlock.cpp and SampleBlock.h
 
 **********************************************************************/
 
+#include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <mutex>
 #include <sqlite3.h>
+#include <string>
+#include <unordered_map>
 
 #include "DBConnection.h"
 #include "ProjectFileIO.h"
+#include "SampleBlockCache.h"
 
 // Tenacity libraries
 #include <lib-math/SampleFormat.h>
+#include <lib-math/SampleSummary.h>
 #include <lib-xml/XMLTagHandler.h>
 
 #include "SampleBlock.h" // to inherit
@@ -35,8 +42,15 @@ public:
 
    void CloseLock() override;
 
-   void SetSamples(
-      constSamplePtr src, size_t numsamples, sampleFormat srcformat);
+   //! Compute summaries and store everything, unless the samples are silent
+   /*!
+    @param prefix256 if not null, the 256 summaries of the first prefixFrames
+    complete frames of the samples, which need not be computed again
+    @return false, storing nothing, if all samples are zero
+    */
+   bool SetSamples(
+      constSamplePtr src, size_t numsamples, sampleFormat srcformat,
+      const float *prefix256 = nullptr, size_t prefixFrames = 0);
 
    //! Numbers of bytes needed for 256 and for 64k summaries
    using Sizes = std::pair< size_t, size_t >;
@@ -52,6 +66,7 @@ public:
                        size_t numsamples) override;
    sampleFormat GetSampleFormat() const;
    size_t GetSampleCount() const override;
+   bool IsLoaded() const override { return IsSilent() || mValid; }
 
    bool GetSummary256(float *dest, size_t frameoffset, size_t numframes) override;
    bool GetSummary64k(float *dest, size_t frameoffset, size_t numframes) override;
@@ -74,11 +89,21 @@ private:
    bool GetSummary(float *dest,
                    size_t frameoffset,
                    size_t numframes,
+                   SampleBlockCache::Payload payload,
                    DBConnection::StatementID id,
                    const char *sql);
+   static void CopyBlob(void *dest,
+                        sampleFormat destformat,
+                        constSamplePtr src,
+                        size_t blobbytes,
+                        sampleFormat srcformat,
+                        size_t srcoffset,
+                        size_t srcbytes);
    size_t GetBlob(void *dest,
                   sampleFormat destformat,
-                  sqlite3_stmt *stmt,
+                  SampleBlockCache::Payload payload,
+                  DBConnection::StatementID id,
+                  const char *sql,
                   sampleFormat srcformat,
                   size_t srcoffset,
                   size_t srcbytes);
@@ -88,7 +113,7 @@ private:
       bytesPerFrame = fields * sizeof(float),
    };
    Sizes SetSizes( size_t numsamples, sampleFormat srcformat );
-   void CalcSummary(Sizes sizes);
+   void CalcSummary(Sizes sizes, const float *prefix256, size_t prefixFrames);
 
 private:
    //! This must never be called for silent blocks
@@ -128,6 +153,7 @@ private:
 // used length values
 static std::map< SampleBlockID, std::shared_ptr<SqliteSampleBlock> >
    sSilentBlocks;
+static std::mutex sSilentBlocksMutex;
 
 ///\brief Implementation of @ref SampleBlockFactory using Sqlite database
 class SqliteSampleBlockFactory final
@@ -149,6 +175,11 @@ public:
       size_t numsamples,
       sampleFormat srcformat) override;
 
+   SampleBlockPtr DoCreateExtended(const SampleBlockPtr &pPrefix,
+      constSamplePtr src,
+      size_t numsamples,
+      sampleFormat srcformat) override;
+
    SampleBlockPtr DoCreateFromXML(
       sampleFormat srcformat,
       const AttributesList &attrs) override;
@@ -156,9 +187,45 @@ public:
    BlockDeletionCallback SetBlockDeletionCallback(
       BlockDeletionCallback callback ) override;
 
+   void DoGetSamples(const SampleBlockReads &reads,
+      sampleFormat destformat) override;
+
+   void Prefetch(const std::vector<SampleBlockPtr> &blocks) override;
+
+   bool EnableDerivedData() override;
+   bool LoadDerivedData(const SampleBlock &block,
+      const std::string &key, std::vector<char> &data) override;
+   bool StoreDerivedData(const SampleBlock &block,
+      const std::string &key, const void *data, size_t size) override;
+
 private:
    friend SqliteSampleBlock;
 
+   //! The block's connection, if it can hold the derived data of the block
+   DBConnection *DerivedDataConnection(const SampleBlock &block) const;
+
+   //! Most bytes of derived data to keep in a project file
+   static constexpr int64_t MaxDerivedDataBytes = 256 * 1024 * 1024;
+
+   //! Set mDerivedDataBytes to the size of all derived data
+   bool CountDerivedData(DBConnection &conn);
+   //! Delete the derived data of other keys than this one, to make room
+   //! for size more bytes
+   /*! @return whether there is room then */
+   bool MakeRoomForDerivedData(
+      DBConnection &conn, const std::string &key, size_t size);
+
+   //! Number of block ids bound to one execution of the batched query
+   static constexpr size_t BatchSize = 16;
+   static const char *BatchSQL();
+
+   using BlobVisitor =
+      std::function<void(SampleBlockID, constSamplePtr, size_t)>;
+   //! Fetch the samples of distinct blocks, a batch of ids per query;
+   //! throws if any block is missing
+   static void FetchSamples(DBConnection &conn,
+      const std::vector<SampleBlockID> &ids, const BlobVisitor &visitor);
+
    const std::shared_ptr<ConnectionPtr> mppConnection;
 
    // Track all blocks that this factory has created, but don't control
@@ -168,14 +235,26 @@ private:
    using AllBlocksMap =
       std::map< SampleBlockID, std::weak_ptr< SqliteSampleBlock > >;
    AllBlocksMap mAllBlocks;
+   //! Blocks may be created by importers on worker threads
+   std::mutex mAllBlocksMutex;
 
    BlockDeletionCallback mCallback;
+
+   //! DBConnection::GetGeneration() of the connection in which the table of
+   //! derived data was last ensured, or 0
+   /*! Not a pointer, which a later connection might reuse */
+   std::atomic<unsigned long long> mDerivedDataGeneration{ 0 };
+   //! Bytes of derived data in that connection, counting replaced rows
+   //! again until the next count
+   std::atomic<int64_t> mDerivedDataBytes{ 0 };
 };
 
 SqliteSampleBlockFactory::SqliteSampleBlockFactory( TenacityProject &project )
    : mppConnection{ ConnectionPtr::Get(project).shared_from_this() }
 {
-   
+   // Pick up any change of the preference when a project is opened
+   SampleBlockCache::Get().SetBudget(
+      std::max(0, SampleBlockCacheSize.Read()) * size_t(1024 * 1024));
 }
 
 SqliteSampleBlockFactory::~SqliteSampleBlockFactory() = default;
@@ -184,8 +263,38 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreate(
    constSamplePtr src, size_t numsamples, sampleFormat srcformat )
 {
    auto sb = std::make_shared<SqliteSampleBlock>(shared_from_this());
-   sb->SetSamples(src, numsamples, srcformat);
+   if (!sb->SetSamples(src, numsamples, srcformat))
+      // Needs no row in the database
+      return DoCreateSilent(numsamples, srcformat);
    // block id has now been assigned
+   std::lock_guard<std::mutex> guard(mAllBlocksMutex);
+   mAllBlocks[ sb->GetBlockID() ] = sb;
+   return sb;
+}
+
+SampleBlockPtr SqliteSampleBlockFactory::DoCreateExtended(
+   const SampleBlockPtr &pPrefix,
+   constSamplePtr src, size_t numsamples, sampleFormat srcformat )
+{
+   auto &prefix = static_cast<SqliteSampleBlock&>(*pPrefix);
+   // Only complete frames of the 256 summary can be reused
+   const auto prefixFrames = prefix.GetSampleCount() / 256;
+   Floats prefix256;
+   if (!prefix.IsSilent() && prefix.mpFactory.get() == this &&
+       prefix.GetSampleFormat() == srcformat &&
+       prefix.GetSampleCount() <= numsamples && prefixFrames > 0) {
+      prefix256.reinit(prefixFrames * SqliteSampleBlock::fields);
+      if (!prefix.GetSummary256(prefix256.get(), 0, prefixFrames))
+         prefix256.reset();
+   }
+   if (!prefix256)
+      return DoCreate(src, numsamples, srcformat);
+
+   auto sb = std::make_shared<SqliteSampleBlock>(shared_from_this());
+   if (!sb->SetSamples(src, numsamples, srcformat,
+         prefix256.get(), prefixFrames))
+      return DoCreateSilent(numsamples, srcformat);
+   std::lock_guard<std::mutex> guard(mAllBlocksMutex);
    mAllBlocks[ sb->GetBlockID() ] = sb;
    return sb;
 }
@@ -193,6 +302,7 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreate(
 auto SqliteSampleBlockFactory::GetActiveBlockIDs() -> SampleBlockIDs
 {
    SampleBlockIDs result;
+   std::lock_guard<std::mutex> guard(mAllBlocksMutex);
    for (auto end = mAllBlocks.end(), it = mAllBlocks.begin(); it != end;) {
       if (it->second.expired())
          // Tighten up the map
@@ -205,10 +315,168 @@ auto SqliteSampleBlockFactory::GetActiveBlockIDs() -> SampleBlockIDs
    return result;
 }
 
+bool SqliteSampleBlockFactory::EnableDerivedData()
+{
+   auto &pConnection = mppConnection->mpConnection;
+   if (!pConnection)
+      return false;
+   const auto generation = pConnection->GetGeneration();
+   if (mDerivedDataGeneration == generation)
+      return true;
+
+   auto db = pConnection->DB();
+   if (!ProjectFileIO::InstallDerivedDataSchema(db))
+   {
+      wxLogDebug(wxT("SqliteSampleBlockFactory::EnableDerivedData - SQLITE error %s"), sqlite3_errmsg(db));
+      return false;
+   }
+
+   // A copied or reopened file may have data already
+   if (!CountDerivedData(*pConnection))
+      return false;
+
+   mDerivedDataGeneration = generation;
+   return true;
+}
+
+bool SqliteSampleBlockFactory::CountDerivedData(DBConnection &conn)
+{
+   // Prepare and cache statement...automatically finalized at DB close
+   sqlite3_stmt *stmt = conn.Prepare(DBConnection::CountDerivedData,
+      "SELECT total(length(data)) FROM derivedblockdata;");
+   if (!stmt)
+      return false;
+
+   const bool result = (sqlite3_step(stmt) == SQLITE_ROW);
+   if (result)
+      mDerivedDataBytes = sqlite3_column_int64(stmt, 0);
+   sqlite3_reset(stmt);
+   return result;
+}
+
+bool SqliteSampleBlockFactory::MakeRoomForDerivedData(
+   DBConnection &conn, const std::string &key, size_t size)
+{
+   if (mDerivedDataBytes + int64_t(size) <= MaxDerivedDataBytes)
+      return true;
+
+   // The data of other keys are those of settings not shown now, or the
+   // count is stale after deleted blocks took their data with them
+   sqlite3_stmt *stmt = conn.Prepare(DBConnection::DeleteOtherDerivedData,
+      "DELETE FROM derivedblockdata WHERE key <> ?1;");
+   if (!stmt)
+      return false;
+   if (sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_STATIC))
+   {
+      wxASSERT_MSG(false, wxT("Binding failed...bug!!!"));
+   }
+   const bool deleted = (sqlite3_step(stmt) == SQLITE_DONE);
+   sqlite3_clear_bindings(stmt);
+   sqlite3_reset(stmt);
+
+   return deleted && CountDerivedData(conn) &&
+      mDerivedDataBytes + int64_t(size) <= MaxDerivedDataBytes;
+}
+
+DBConnection *SqliteSampleBlockFactory::DerivedDataConnection(
+   const SampleBlock &block) const
+{
+   auto &sb = static_cast<const SqliteSampleBlock&>(block);
+   if (sb.IsSilent() || sb.mpFactory.get() != this)
+      return nullptr;
+   auto pConn = sb.Conn();
+   return pConn->GetGeneration() == mDerivedDataGeneration ? pConn : nullptr;
+}
+
+bool SqliteSampleBlockFactory::LoadDerivedData(const SampleBlock &block,
+   const std::string &key, std::vector<char> &data)
+{
+   bool result = false;
+   try {
+      auto pConn = DerivedDataConnection(block);
+      if (!pConn)
+         return false;
+
+      // Prepare and cache statement...automatically finalized at DB close
+      sqlite3_stmt *stmt = pConn->Prepare(DBConnection::LoadDerivedData,
+         "SELECT data FROM derivedblockdata WHERE blockid = ?1 AND key = ?2;");
+
+      // Bind statement parameters
+      // Might return SQLITE_MISUSE which means it's our mistake that we violated
+      // preconditions; should return SQL_OK which is 0
+      if (sqlite3_bind_int64(stmt, 1, block.GetBlockID()) ||
+          sqlite3_bind_text(stmt, 2, key.c_str(), -1, SQLITE_STATIC))
+      {
+         wxASSERT_MSG(false, wxT("Binding failed...bug!!!"));
+      }
+
+      if (sqlite3_step(stmt) == SQLITE_ROW) {
+         auto src = static_cast<const char*>(sqlite3_column_blob(stmt, 0));
+         auto size = (size_t) sqlite3_column_bytes(stmt, 0);
+         data.assign(src, src + size);
+         result = true;
+      }
+
+      // Clear statement bindings and rewind statement
+      sqlite3_clear_bindings(stmt);
+      sqlite3_reset(stmt);
+   }
+   catch ( ... ) {
+      // Only a cache; the caller computes the data instead
+      return false;
+   }
+   return result;
+}
+
+bool SqliteSampleBlockFactory::StoreDerivedData(const SampleBlock &block,
+   const std::string &key, const void *data, size_t size)
+{
+   bool result = false;
+   try {
+      auto pConn = DerivedDataConnection(block);
+      if (!pConn)
+         return false;
+
+      // Not stored is only not cached
+      if (!MakeRoomForDerivedData(*pConn, key, size))
+         return false;
+
+      // Prepare and cache statement...automatically finalized at DB close
+      sqlite3_stmt *stmt = pConn->Prepare(DBConnection::InsertDerivedData,
+         "INSERT OR REPLACE INTO derivedblockdata (blockid, key, data)"
+         " VALUES(?1, ?2, ?3);");
+
+      // Bind statement parameters
+      // Might return SQLITE_MISUSE which means it's our mistake that we violated
+      // preconditions; should return SQL_OK which is 0
+      if (sqlite3_bind_int64(stmt, 1, block.GetBlockID()) ||
+          sqlite3_bind_text(stmt, 2, key.c_str(), -1, SQLITE_STATIC) ||
+          sqlite3_bind_blob(stmt, 3, data, size, SQLITE_STATIC))
+      {
+         wxASSERT_MSG(false, wxT("Binding failed...bug!!!"));
+      }
+
+      result = (sqlite3_step(stmt) == SQLITE_DONE);
+      if (result)
+         mDerivedDataBytes += size;
+      else
+         wxLogDebug(wxT("SqliteSampleBlockFactory::StoreDerivedData - SQLITE error %s"), sqlite3_errmsg(pConn->DB()));
+
+      // Clear statement bindings and rewind statement
+      sqlite3_clear_bindings(stmt);
+      sqlite3_reset(stmt);
+   }
+   catch ( ... ) {
+      return false;
+   }
+   return result;
+}
+
 SampleBlockPtr SqliteSampleBlockFactory::DoCreateSilent(
    size_t numsamples, sampleFormat )
 {
    auto id = -static_cast< SampleBlockID >(numsamples);
+   std::lock_guard<std::mutex> guard(sSilentBlocksMutex);
    auto &result = sSilentBlocks[ id ];
    if ( !result ) {
       result = std::make_shared<SqliteSampleBlock>(nullptr);
@@ -245,17 +513,22 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreateFromXML(
          }
          else {
             // First see if this block id was previously loaded
-            auto &wb = mAllBlocks[ nValue ];
-            auto pb = wb.lock();
-            if (pb)
-               // Reuse the block
-               sb = pb;
-            else {
-               // First sight of this id
-               auto ssb =
-                  std::make_shared<SqliteSampleBlock>(shared_from_this());
-               wb = ssb;
-               sb = ssb;
+            std::shared_ptr<SqliteSampleBlock> ssb;
+            {
+               std::lock_guard<std::mutex> guard(mAllBlocksMutex);
+               auto &wb = mAllBlocks[ nValue ];
+               auto pb = wb.lock();
+               if (pb)
+                  // Reuse the block
+                  sb = pb;
+               else {
+                  // First sight of this id
+                  ssb = std::make_shared<SqliteSampleBlock>(shared_from_this());
+                  wb = ssb;
+                  sb = ssb;
+               }
+            }
+            if (ssb) {
                ssb->mSampleFormat = srcformat;
                // This may throw database errors
                // It initializes the rest of the fields
@@ -283,6 +556,158 @@ auto SqliteSampleBlockFactory::SetBlockDeletionCallback(
    return result;
 }
 
+const char *SqliteSampleBlockFactory::BatchSQL()
+{
+   static const std::string sql = []{
+      std::string result =
+         "SELECT blockid, samples FROM sampleblocks WHERE blockid IN (";
+      for (size_t ii = 1; ii <= BatchSize; ++ii)
+         result += (ii > 1 ? ",?" : "?") + std::to_string(ii);
+      return result + ");";
+   }();
+   return sql.c_str();
+}
+
+void SqliteSampleBlockFactory::FetchSamples(DBConnection &conn,
+   const std::vector<SampleBlockID> &ids, const BlobVisitor &visitor)
+{
+   auto db = conn.DB();
+
+   // Prepare and cache statement...automatically finalized at DB close
+   sqlite3_stmt *stmt =
+      conn.Prepare(DBConnection::GetSamplesBatch, BatchSQL());
+
+   for (size_t first = 0; first < ids.size(); first += BatchSize) {
+      const auto last = std::min(ids.size(), first + BatchSize);
+
+      // Bind statement parameters; unused places repeat the last id, which
+      // does not change the result set
+      // Might return SQLITE_MISUSE which means it's our mistake that we violated
+      // preconditions; should return SQL_OK which is 0
+      for (size_t ii = 0; ii < BatchSize; ++ii) {
+         if (sqlite3_bind_int64(stmt, ii + 1, ids[std::min(first + ii, last - 1)]))
+         {
+            wxASSERT_MSG(false, wxT("Binding failed...bug!!!"));
+         }
+      }
+
+      // Rows come back in order of id, not necessarily in the given order
+      size_t found = 0;
+      int rc;
+      while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+      {
+         const SampleBlockID id = sqlite3_column_int64(stmt, 0);
+         auto src = (constSamplePtr) sqlite3_column_blob(stmt, 1);
+         size_t blobbytes = (size_t) sqlite3_column_bytes(stmt, 1);
+         ++found;
+         visitor(id, src, blobbytes);
+      }
+
+      // Clear statement bindings and rewind statement
+      sqlite3_clear_bindings(stmt);
+      sqlite3_reset(stmt);
+
+      if (rc != SQLITE_DONE || found != last - first)
+      {
+         wxLogDebug(wxT("SqliteSampleBlockFactory::FetchSamples - SQLITE error %s"), sqlite3_errmsg(db));
+
+         // Just showing the user a simple message, not the library error too
+         // which isn't internationalized
+         conn.ThrowException( false );
+      }
+   }
+}
+
+void SqliteSampleBlockFactory::DoGetSamples(
+   const SampleBlockReads &reads, sampleFormat destformat)
+{
+   auto &cache = SampleBlockCache::Get();
+
+   // Serve whatever needs no query, and collect the rest by id; a block
+   // might be read in more than one place
+   std::unordered_multimap<SampleBlockID, const SampleBlockRead*> pending;
+   std::vector<SampleBlockID> ids;
+   DBConnection *pConn = nullptr;
+   for (auto &read : reads) {
+      auto &block = static_cast<SqliteSampleBlock&>(*read.block);
+      if (block.IsSilent() || block.mpFactory.get() != this) {
+         block.DoGetSamples(read.dest, destformat, read.offset, read.count);
+         continue;
+      }
+
+      if (!block.mValid)
+         block.Load(block.mBlockID);
+
+      const auto size = SAMPLE_SIZE(block.mSampleFormat);
+      if (auto blob = cache.Find(block.DB(), block.mBlockID,
+            SampleBlockCache::Payload::Samples))
+         SqliteSampleBlock::CopyBlob(read.dest, destformat,
+            blob->data(), blob->size(),
+            block.mSampleFormat, read.offset * size, read.count * size);
+      else {
+         if (pending.count(block.mBlockID) == 0)
+            ids.push_back(block.mBlockID);
+         pending.emplace(block.mBlockID, &read);
+         pConn = block.Conn();
+      }
+   }
+
+   if (ids.empty())
+      return;
+
+   FetchSamples(*pConn, ids,
+      [&](SampleBlockID id, constSamplePtr src, size_t blobbytes)
+   {
+      if (cache.IsEnabled())
+         cache.Insert(pConn->DB(), id, SampleBlockCache::Payload::Samples,
+            std::make_shared<std::vector<char>>(src, src + blobbytes));
+
+      auto range = pending.equal_range(id);
+      for (auto iter = range.first; iter != range.second; ++iter) {
+         auto &read = *iter->second;
+         const auto &block =
+            static_cast<const SqliteSampleBlock&>(*read.block);
+         const auto size = SAMPLE_SIZE(block.mSampleFormat);
+         SqliteSampleBlock::CopyBlob(read.dest, destformat,
+            src, blobbytes,
+            block.mSampleFormat, read.offset * size, read.count * size);
+      }
+   });
+}
+
+void SqliteSampleBlockFactory::Prefetch(
+   const std::vector<SampleBlockPtr> &blocks)
+{
+   auto &cache = SampleBlockCache::Get();
+   if (!cache.IsEnabled())
+      return;
+
+   std::vector<SampleBlockID> ids;
+   DBConnection *pConn = nullptr;
+   for (auto &pBlock : blocks) {
+      auto &block = static_cast<SqliteSampleBlock&>(*pBlock);
+      // Blocks not yet loaded are left for the reading thread to load
+      if (block.IsSilent() || block.mpFactory.get() != this || !block.mValid)
+         continue;
+      pConn = block.Conn();
+      if (!cache.Contains(pConn->DB(), block.mBlockID,
+            SampleBlockCache::Payload::Samples))
+         ids.push_back(block.mBlockID);
+   }
+
+   std::sort(ids.begin(), ids.end());
+   ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+   if (ids.empty())
+      return;
+
+   FetchSamples(*pConn, ids,
+      [&](SampleBlockID id, constSamplePtr src, size_t blobbytes)
+   {
+      cache.Insert(pConn->DB(), id, SampleBlockCache::Payload::Samples,
+         std::make_shared<std::vector<char>>(src, src + blobbytes));
+   });
+}
+
 SqliteSampleBlock::SqliteSampleBlock(
    const std::shared_ptr<SqliteSampleBlockFactory> &pFactory)
 :  mpFactory(pFactory)
@@ -377,36 +802,47 @@ size_t SqliteSampleBlock::DoGetSamples(samplePtr dest,
       return numsamples;
    }
 
-   // Prepare and cache statement...automatically finalized at DB close
-   sqlite3_stmt *stmt = Conn()->Prepare(DBConnection::GetSamples,
-      "SELECT samples FROM sampleblocks WHERE blockid = ?1;");
-
    return GetBlob(dest,
                   destformat,
-                  stmt,
+                  SampleBlockCache::Payload::Samples,
+                  DBConnection::GetSamples,
+                  "SELECT samples FROM sampleblocks WHERE blockid = ?1;",
                   mSampleFormat,
                   sampleoffset * SAMPLE_SIZE(mSampleFormat),
                   numsamples * SAMPLE_SIZE(mSampleFormat)) / SAMPLE_SIZE(mSampleFormat);
 }
 
-void SqliteSampleBlock::SetSamples(constSamplePtr src,
+bool SqliteSampleBlock::SetSamples(constSamplePtr src,
                                    size_t numsamples,
-                                   sampleFormat srcformat)
+                                   sampleFormat srcformat,
+                                   const float *prefix256,
+                                   size_t prefixFrames)
 {
    auto sizes = SetSizes(numsamples, srcformat);
    mSamples.reinit(mSampleBytes);
    memcpy(mSamples.get(), src, mSampleBytes);
 
-   CalcSummary( sizes );
+   CalcSummary( sizes, prefix256, prefixFrames );
+
+   // All zeroes, if the sum of squares was 0 and no tiny values underflowed
+   // when squared
+   if (mSumRms == 0 && mSumMin == 0 && mSumMax == 0) {
+      mSamples.reset();
+      mSummary256.reset();
+      mSummary64k.reset();
+      return false;
+   }
 
    Commit( sizes );
+   return true;
 }
 
 bool SqliteSampleBlock::GetSummary256(float *dest,
                                       size_t frameoffset,
                                       size_t numframes)
 {
-   return GetSummary(dest, frameoffset, numframes, DBConnection::GetSummary256,
+   return GetSummary(dest, frameoffset, numframes,
+      SampleBlockCache::Payload::Summary256, DBConnection::GetSummary256,
       "SELECT summary256 FROM sampleblocks WHERE blockid = ?1;");
 }
 
@@ -414,13 +850,15 @@ bool SqliteSampleBlock::GetSummary64k(float *dest,
                                       size_t frameoffset,
                                       size_t numframes)
 {
-   return GetSummary(dest, frameoffset, numframes, DBConnection::GetSummary64k,
+   return GetSummary(dest, frameoffset, numframes,
+      SampleBlockCache::Payload::Summary64k, DBConnection::GetSummary64k,
       "SELECT summary64k FROM sampleblocks WHERE blockid = ?1;");
 }
 
 bool SqliteSampleBlock::GetSummary(float *dest,
                                    size_t frameoffset,
                                    size_t numframes,
+                                   SampleBlockCache::Payload payload,
                                    DBConnection::StatementID id,
                                    const char *sql)
 {
@@ -429,13 +867,13 @@ bool SqliteSampleBlock::GetSummary(float *dest,
    if (!silent) {
       // Not a silent block
       try {
-         // Prepare and cache statement...automatically finalized at DB close
-         auto stmt = Conn()->Prepare(id, sql);
          // Note GetBlob returns a size_t, not a bool
          // REVIEW: An error in GetBlob() will throw an exception.
          GetBlob(dest,
                      floatSample,
-                     stmt,
+                     payload,
+                     id,
+                     sql,
                      floatSample,
                      frameoffset * fields * SAMPLE_SIZE(floatSample),
                      numframes * fields * SAMPLE_SIZE(floatSample));
@@ -492,21 +930,11 @@ MinMaxRMS SqliteSampleBlock::DoGetMinMaxRMS(size_t start, size_t len)
       float *samples = (float *) blockData.ptr();
 
       size_t copied = DoGetSamples((samplePtr) samples, floatSample, start, len);
-      for (size_t i = 0; i < copied; ++i, ++samples)
-      {
-         float sample = *samples;
-
-         if (sample > max)
-         {
-            max = sample;
-         }
-
-         if (sample < min)
-         {
-            min = sample;
-         }
-
-         sumsq += (sample * sample);
+      if (copied > 0) {
+         const auto summary = SummarizeSamples(samples, copied);
+         min = summary.min;
+         max = summary.max;
+         sumsq = summary.sumsq;
       }
    }
 
@@ -529,9 +957,76 @@ size_t SqliteSampleBlock::GetSpaceUsage() const
       return ProjectFileIO::GetDiskUsage(*Conn(), mBlockID);
 }
 
+// Copy from the BLOB, whether cached or just fetched, and zero-fill the
+// rest of the destination
+void SqliteSampleBlock::CopyBlob(void *dest,
+                                 sampleFormat destformat,
+                                 constSamplePtr src,
+                                 size_t blobbytes,
+                                 sampleFormat srcformat,
+                                 size_t srcoffset,
+                                 size_t srcbytes)
+{
+   srcoffset = std::min(srcoffset, blobbytes);
+   size_t minbytes = std::min(srcbytes, blobbytes - srcoffset);
+
+   /*
+    Will dithering happen in CopySamples?  Answering this as of 3.0.3 by
+    examining all uses.
+    
+    As this function is called from GetSummary, no, because destination format
+    is float.
+
+    There is only one other call to this function, in DoGetSamples.  At one
+    call to that function, in DoGetMinMaxRMS, again format is float always.
+    (SqliteSampleBlockFactory::DoGetSamples() also calls this, on behalf of
+    Sequence::Get() and with the same formats, so the argument below holds.)
+    
+    There is only one other call to DoGetSamples, in SampleBlock::GetSamples().
+    In one call to that function, in WaveformView.cpp, again format is float.
+
+    That leaves two calls in Sequence.cpp.  One of those can be proved to be
+    used only in copy and paste operations, always supplying the same sample
+    format as the samples were stored in, therefore no dither.
+
+    That leaves uses of Sequence::Read().  There are uses of Read() in internal
+    operations also easily shown to use only the saved format, and
+    GetWaveDisplay() always reads as float.
+
+    The remaining use of Sequence::Read() is in Sequence::Get().  That is used
+    by WaveClip::Resample(), always fetching float.  It is also used in
+    WaveClip::GetSamples().
+
+    There is only one use of that function not always fetching float, in
+    WaveTrack::Get().
+
+    It can be shown that the only paths to WaveTrack::Get() not specifying
+    floatSample are in Benchmark, which is only a diagnostic test, and there
+    the sample format is the same as what the track was constructed with.
+
+    Therefore, no dithering even there!
+    */
+   wxASSERT(destformat == floatSample || destformat == srcformat);
+
+   CopySamples(src + srcoffset,
+               srcformat,
+               (samplePtr) dest,
+               destformat,
+               minbytes / SAMPLE_SIZE(srcformat));
+
+   auto rest = ((samplePtr) dest) + minbytes;
+
+   if (srcbytes - minbytes)
+   {
+      memset(rest, 0, srcbytes - minbytes);
+   }
+}
+
 size_t SqliteSampleBlock::GetBlob(void *dest,
                                   sampleFormat destformat,
-                                  sqlite3_stmt *stmt,
+                                  SampleBlockCache::Payload payload,
+                                  DBConnection::StatementID id,
+                                  const char *sql,
                                   sampleFormat srcformat,
                                   size_t srcoffset,
                                   size_t srcbytes)
@@ -545,8 +1040,18 @@ size_t SqliteSampleBlock::GetBlob(void *dest,
       Load(mBlockID);
    }
 
+   auto &cache = SampleBlockCache::Get();
+   if (auto blob = cache.Find(db, mBlockID, payload))
+   {
+      CopyBlob(dest, destformat, blob->data(), blob->size(),
+               srcformat, srcoffset, srcbytes);
+      return srcbytes;
+   }
+
    int rc;
-   size_t minbytes = 0;
+
+   // Prepare and cache statement...automatically finalized at DB close
+   sqlite3_stmt *stmt = Conn()->Prepare(id, sql);
 
    // Bind statement parameters
    // Might return SQLITE_MISUSE which means it's our mistake that we violated
@@ -579,65 +1084,19 @@ size_t SqliteSampleBlock::GetBlob(void *dest,
    }
 
    // Retrieve returned data
-   samplePtr src = (samplePtr) sqlite3_column_blob(stmt, 0);
+   constSamplePtr src = (constSamplePtr) sqlite3_column_blob(stmt, 0);
    size_t blobbytes = (size_t) sqlite3_column_bytes(stmt, 0);
 
-   srcoffset = std::min(srcoffset, blobbytes);
-   minbytes = std::min(srcbytes, blobbytes - srcoffset);
-
-   if (srcoffset != 0)
+   if (cache.IsEnabled())
    {
-      srcoffset += 0;
+      // Keep the whole BLOB, not just the requested range, for the next
+      // reader of this block
+      cache.Insert(db, mBlockID, payload,
+         std::make_shared<std::vector<char>>(src, src + blobbytes));
    }
 
-   /*
-    Will dithering happen in CopySamples?  Answering this as of 3.0.3 by
-    examining all uses.
-    
-    As this function is called from GetSummary, no, because destination format
-    is float.
-
-    There is only one other call to this function, in DoGetSamples.  At one
-    call to that function, in DoGetMinMaxRMS, again format is float always.
-    
-    There is only one other call to DoGetSamples, in SampleBlock::GetSamples().
-    In one call to that function, in WaveformView.cpp, again format is float.
-
-    That leaves two calls in Sequence.cpp.  One of those can be proved to be
-    used only in copy and paste operations, always supplying the same sample
-    format as the samples were stored in, therefore no dither.
-
-    That leaves uses of Sequence::Read().  There are uses of Read() in internal
-    operations also easily shown to use only the saved format, and
-    GetWaveDisplay() always reads as float.
-
-    The remaining use of Sequence::Read() is in Sequence::Get().  That is used
-    by WaveClip::Resample(), always fetching float.  It is also used in
-    WaveClip::GetSamples().
-
-    There is only one use of that function not always fetching float, in
-    WaveTrack::Get().
-
-    It can be shown that the only paths to WaveTrack::Get() not specifying
-    floatSample are in Benchmark, which is only a diagnostic test, and there
-    the sample format is the same as what the track was constructed with.
-
-    Therefore, no dithering even there!
-    */
-   wxASSERT(destformat == floatSample || destformat == srcformat);
-
-   CopySamples(src + srcoffset,
-               srcformat,
-               (samplePtr) dest,
-               destformat,
-               minbytes / SAMPLE_SIZE(srcformat));
-
-   dest = ((samplePtr) dest) + minbytes;
-
-   if (srcbytes - minbytes)
-   {
-      memset(dest, 0, srcbytes - minbytes);
-   }
+   CopyBlob(dest, destformat, src, blobbytes,
+            srcformat, srcoffset, srcbytes);
 
    // Clear statement bindings and rewind statement
    sqlite3_clear_bindings(stmt);
@@ -733,23 +1192,49 @@ void SqliteSampleBlock::Commit(Sizes sizes)
       wxASSERT_MSG(false, wxT("Binding failed...bug!!!"));
    }
  
-   // Execute the statement
-   rc = sqlite3_step(stmt);
-   if (rc != SQLITE_DONE)
    {
-      wxLogDebug(wxT("SqliteSampleBlock::Commit - SQLITE error %s"), sqlite3_errmsg(db));
+      // Blocks may be committed from several threads at once; hold the
+      // connection's mutex so that the row id is the one just inserted
+      const auto mutex = sqlite3_db_mutex(db);
+      sqlite3_mutex_enter(mutex);
+      auto unlock = finally([&]{ sqlite3_mutex_leave(mutex); });
+
+      // Execute the statement
+      rc = sqlite3_step(stmt);
+      if (rc != SQLITE_DONE)
+      {
+         wxLogDebug(wxT("SqliteSampleBlock::Commit - SQLITE error %s"), sqlite3_errmsg(db));
 
-      // Clear statement bindings and rewind statement
-      sqlite3_clear_bindings(stmt);
-      sqlite3_reset(stmt);
+         // Clear statement bindings and rewind statement
+         sqlite3_clear_bindings(stmt);
+         sqlite3_reset(stmt);
 
-      // Just showing the user a simple message, not the library error too
-      // which isn't internationalized
-      Conn()->ThrowException( true );
+         // Just showing the user a simple message, not the library error too
+         // which isn't internationalized
+         Conn()->ThrowException( true );
+      }
+
+      // Retrieve returned data
+      mBlockID = sqlite3_last_insert_rowid(db);
    }
 
-   // Retrieve returned data
-   mBlockID = sqlite3_last_insert_rowid(db);
+   // The summaries are small and likely to be drawn soon, so let the cache
+   // have them now; the samples are left to be cached when first read
+   auto &cache = SampleBlockCache::Get();
+   // A rolled back insertion may have left payloads of another block cached
+   // under the same, reused, rowid
+   cache.Invalidate(db, mBlockID);
+   if (cache.IsEnabled())
+   {
+      const auto summary256 = mSummary256.get();
+      const auto summary64k = mSummary64k.get();
+      cache.Insert(db, mBlockID, SampleBlockCache::Payload::Summary256,
+         std::make_shared<std::vector<char>>(
+            summary256, summary256 + mSummary256Bytes));
+      cache.Insert(db, mBlockID, SampleBlockCache::Payload::Summary64k,
+         std::make_shared<std::vector<char>>(
+            summary64k, summary64k + mSummary64kBytes));
+   }
 
    // Reset local arrays
    mSamples.reset();
@@ -770,6 +1255,9 @@ void SqliteSampleBlock::Delete()
 
    wxASSERT(!IsSilent());
 
+   // The row id may be reused by a later insertion
+   SampleBlockCache::Get().Invalidate(db, mBlockID);
+
    // Prepare and cache statement...automatically finalized at DB close
    sqlite3_stmt *stmt = Conn()->Prepare(DBConnection::DeleteSampleBlock,
       "DELETE FROM sampleblocks WHERE blockid = ?1;");
@@ -824,23 +1312,29 @@ auto SqliteSampleBlock::SetSizes(
 /// This method also has the side effect of setting the mSumMin,
 /// mSumMax, and mSumRms members of this class.
 ///
-void SqliteSampleBlock::CalcSummary(Sizes sizes)
+/// The sums of squares of reused frames are recovered from their rms, with
+/// some loss of precision in mSumRms.
+///
+void SqliteSampleBlock::CalcSummary(Sizes sizes,
+   const float *prefix256, size_t prefixFrames)
 {
    const auto mSummary256Bytes = sizes.first;
    const auto mSummary64kBytes = sizes.second;
 
+   // Only the samples after the reused frames are needed
+   const size_t first = prefixFrames * 256;
    Floats samplebuffer;
-   float *samples;
+   const float *samples;
 
    if (mSampleFormat == floatSample)
    {
-      samples = (float *) mSamples.get();
+      samples = (const float *) mSamples.get() + first;
    }
    else
    {
-      samplebuffer.reinit((unsigned) mSampleCount);
-      SamplesToFloats(mSamples.get(), mSampleFormat,
-         samplebuffer.get(), mSampleCount);
+      samplebuffer.reinit((unsigned) (mSampleCount - first));
+      SamplesToFloats(mSamples.get() + first * SAMPLE_SIZE(mSampleFormat),
+         mSampleFormat, samplebuffer.get(), mSampleCount - first);
       samples = samplebuffer.get();
    }
    
@@ -860,12 +1354,18 @@ void SqliteSampleBlock::CalcSummary(Sizes sizes)
    int sumLen = (mSampleCount + 255) / 256;
    int summaries = 256;
 
-   for (int i = 0; i < sumLen; ++i)
+   if (prefixFrames > 0)
    {
-      min = samples[i * 256];
-      max = samples[i * 256];
-      sumsq = min * min;
+      std::copy(prefix256, prefix256 + prefixFrames * fields, summary256);
+      for (size_t i = 0; i < prefixFrames; ++i)
+      {
+         const double rms = prefix256[i * fields + 2];
+         totalSquares += rms * rms * 256;
+      }
+   }
 
+   for (int i = prefixFrames; i < sumLen; ++i)
+   {
       int jcount = 256;
       if (jcount > mSampleCount - i * 256)
       {
@@ -873,27 +1373,14 @@ void SqliteSampleBlock::CalcSummary(Sizes sizes)
          fraction = 1.0 - (jcount / 256.0);
       }
 
-      for (int j = 1; j < jcount; ++j)
-      {
-         float f1 = samples[i * 256 + j];
-         sumsq += f1 * f1;
-
-         if (f1 < min)
-         {
-            min = f1;
-         }
-         else if (f1 > max)
-         {
-            max = f1;
-         }
-      }
+      const auto summary = SummarizeSamples(samples + (i * 256 - first), jcount);
 
-      totalSquares += sumsq;
+      totalSquares += summary.sumsq;
 
-      summary256[i * fields] = min;
-      summary256[i * fields + 1] = max;
+      summary256[i * fields] = summary.min;
+      summary256[i * fields + 1] = summary.max;
       // The rms is correct, but this may be for less than 256 samples in last loop.
-      summary256[i * fields + 2] = (float) sqrt(sumsq / jcount);
+      summary256[i * fields + 2] = (float) sqrt(summary.sumsq / jcount);
    }
 
    for (int i = sumLen, frames256 = mSummary256Bytes / bytesPerFrame;
@@ -0,0 +1,94 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SummaryPyramid.cpp
+  @brief Summaries of runs of whole sample blocks, in power-of-4 levels
+
+**********************************************************************/
+
+#include "SummaryPyramid.h"
+
+#include <algorithm>
+
+#include "SampleBlock.h"
+#include "Sequence.h"
+
+namespace {
+constexpr size_t Fanout = 4;
+}
+
+void SummaryPyramid::Node::Add(const Node &other)
+{
+   min = std::min(min, other.min);
+   max = std::max(max, other.max);
+   sumsq += other.sumsq;
+   samples += other.samples;
+}
+
+SummaryPyramid::SummaryPyramid() = default;
+
+SummaryPyramid::~SummaryPyramid() = default;
+
+void SummaryPyramid::Truncate(size_t nBlocks)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+   for (auto &level : mLevels) {
+      if (level.size() > nBlocks)
+         level.resize(nBlocks);
+      nBlocks /= Fanout;
+   }
+}
+
+void SummaryPyramid::Extend(const BlockArray &blocks)
+{
+   if (mLevels.empty())
+      mLevels.emplace_back();
+
+   auto &level0 = mLevels[0];
+   level0.reserve(blocks.size());
+   for (auto b = level0.size(), nn = blocks.size(); b < nn; ++b) {
+      const auto &sb = *blocks[b].sb;
+      // No-throw for display operations!
+      const auto results = sb.GetMinMaxRMS(false);
+      const double samples = sb.GetSampleCount();
+      level0.push_back({ results.min, results.max,
+         double(results.RMS) * results.RMS * samples, samples });
+   }
+
+   // Make the complete nodes of higher levels
+   for (size_t k = 0; mLevels[k].size() >= Fanout; ++k) {
+      if (k + 1 == mLevels.size())
+         mLevels.emplace_back();
+      const auto &lower = mLevels[k];
+      auto &upper = mLevels[k + 1];
+      for (auto i = upper.size(), nn = lower.size() / Fanout; i < nn; ++i) {
+         Node node;
+         for (size_t j = 0; j < Fanout; ++j)
+            node.Add(lower[i * Fanout + j]);
+         upper.push_back(node);
+      }
+   }
+}
+
+auto SummaryPyramid::Summarize(const BlockArray &blocks, size_t b0, size_t b1)
+   -> Node
+{
+   Node result;
+   std::lock_guard<std::mutex> guard(mMutex);
+   if (mLevels.empty() || mLevels[0].size() < blocks.size())
+      Extend(blocks);
+
+   // Take unaligned nodes from the ends of the range, then rise a level
+   b1 = std::min(b1, blocks.size());
+   for (size_t k = 0; b0 < b1; ++k) {
+      const auto &level = mLevels[k];
+      while (b0 < b1 && b0 % Fanout)
+         result.Add(level[b0++]);
+      while (b0 < b1 && b1 % Fanout)
+         result.Add(level[--b1]);
+      b0 /= Fanout;
+      b1 /= Fanout;
+   }
+   return result;
+}
@@ -0,0 +1,65 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SummaryPyramid.h
+  @brief Summaries of runs of whole sample blocks, in power-of-4 levels
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SUMMARY_PYRAMID__
+#define __AUDACITY_SUMMARY_PYRAMID__
+
+#include <cfloat>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+class BlockArray;
+
+///\brief Summaries of the blocks of a Sequence, and of runs of 4, 16, 64...
+/*!
+ Level 0 has one node for each block, made from the summary each block keeps
+ in memory and stores in the project.  Each node of level k + 1 combines four
+ consecutive nodes of level k, so that any run of whole blocks is summarized
+ from at most six nodes per level, and the display of a long sequence far
+ zoomed out costs time in proportion to its width, not to its length.
+
+ Only the nodes for a prefix of the block array are kept.  They are made as
+ needed, and forgotten by the Sequence when blocks in the prefix change.
+ */
+class TENACITY_DLL_API SummaryPyramid final
+{
+public:
+   struct Node {
+      //! The summary of no samples, which any other one replaces when added
+      float min{ FLT_MAX };
+      float max{ -FLT_MAX };
+      double sumsq{ 0 };
+      double samples{ 0 };
+
+      void Add(const Node &other);
+   };
+
+   SummaryPyramid();
+   ~SummaryPyramid();
+
+   //! Forget the nodes that summarize blocks at nBlocks and later
+   void Truncate(size_t nBlocks);
+
+   //! Summarize blocks [b0, b1) of the array; any thread
+   /*!
+    The array must be the one whose prefix was summarized, apart from changes
+    reported with Truncate()
+    */
+   Node Summarize(const BlockArray &blocks, size_t b0, size_t b1);
+
+private:
+   void Extend(const BlockArray &blocks);
+
+   std::mutex mMutex;
+   //! mLevels[k][i] summarizes blocks [i * 4^k, (i + 1) * 4^k)
+   std::vector<std::vector<Node>> mLevels;
+};
+
+#endif
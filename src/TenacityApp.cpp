@@ -464,33 +464,11 @@ public:
    };
 };
 
-#ifdef NDEBUG
-
+// The entry point is in TenacityMain.cpp, which the headless programs
+// do not link
 IMPLEMENT_APP_NO_MAIN(TenacityApp)
 IMPLEMENT_WX_THEME_SUPPORT
 
-#ifdef __WXMSW__
-extern "C" int WINAPI WinMain(HINSTANCE hInstance,
-                              HINSTANCE hPrevInstance,
-                              wxCmdLineArgType lpCmdLine,
-                              int nCmdShow)
-{
-   wxDISABLE_DEBUG_SUPPORT();
-
-   return wxEntry(hInstance, hPrevInstance, lpCmdLine, nCmdShow);
-}
-#else
-int main(int argc, char *argv[])
-{
-   wxDISABLE_DEBUG_SUPPORT();
-
-   return wxEntry(argc, argv);
-}
-#endif
-#else
-IMPLEMENT_APP(TenacityApp)
-#endif
-
 #ifdef __WXMAC__
 
 // in response of an open-document apple event
@@ -0,0 +1,43 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  TenacityMain.cpp
+
+******************************************************************//**
+
+\file TenacityMain.cpp
+\brief The entry point of the application
+
+  It is apart from TenacityApp.cpp, so that the headless programs in
+  tests/ can link everything else.
+
+*//*******************************************************************/
+
+#include <wx/app.h>
+#include <wx/init.h>
+
+#ifdef NDEBUG
+
+#ifdef __WXMSW__
+extern "C" int WINAPI WinMain(HINSTANCE hInstance,
+                              HINSTANCE hPrevInstance,
+                              wxCmdLineArgType lpCmdLine,
+                              int nCmdShow)
+{
+   wxDISABLE_DEBUG_SUPPORT();
+
+   return wxEntry(hInstance, hPrevInstance, lpCmdLine, nCmdShow);
+}
+#else
+int main(int argc, char *argv[])
+{
+   wxDISABLE_DEBUG_SUPPORT();
+
+   return wxEntry(argc, argv);
+}
+#endif
+
+#else
+IMPLEMENT_WXWIN_MAIN
+#endif
@@ -120,6 +120,9 @@ public:
    bool bigPoints{ false };
    bool drawSliders{ false };
    bool hasSolo{ false };
+   //! Whether displays computed in the background, such as spectrograms,
+   //! may be drawn incomplete, with the parent refreshed as they progress
+   bool progressive{ false };
 };
 
 #endif                          // define __AUDACITY_TRACKARTIST__
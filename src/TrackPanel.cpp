@@ -286,6 +286,7 @@ TrackPanel::TrackPanel(wxWindow * parent, wxWindowID id,
    }
 
    mTrackArtist = std::make_unique<TrackArtist>( this );
+   mTrackArtist->progressive = true;
 
    mTimeCount = 0;
    mTimer.parent = this;
@@ -771,6 +772,12 @@ void TrackPanel::RefreshTrack(Track *trk, bool refreshbacking)
    Refresh( false, &rect );
 }
 
+void TrackPanel::RefreshArea(const wxRect &rect)
+{
+   mRefreshBacking = true;
+   Refresh( false, &rect );
+}
+
 /// This method overrides Refresh() of wxWindow so that the
 /// boolean play indicator can be set to false, so that an old play indicator that is
 /// no longer there won't get  XORed (to erase it), thus redrawing it on the
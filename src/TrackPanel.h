@@ -109,6 +109,8 @@ class TENACITY_DLL_API TrackPanel final
       override;
 
    void RefreshTrack(Track *trk, bool refreshbacking = true);
+   //! Redraw the backing bitmap, but repaint only the given part of the screen
+   void RefreshArea(const wxRect &rect);
 
    void HandlePageUpKey();
    void HandlePageDownKey();
@@ -30,14 +30,17 @@ UndoManager
 #include "Project.h"
 #include "SampleBlock.h"
 #include "Sequence.h"
+#include "WaveClip.h"
 #include "WaveTrack.h"          // temp
 #include "Diags.h"
 #include "Tags.h"
 #include "TransactionScope.h"
 #include "widgets/ProgressDialog.h"
 
+#include <algorithm>
 #include <unordered_set>
 #include <optional>
+#include <vector>
 
 wxDEFINE_EVENT(EVT_UNDO_PUSHED, wxCommandEvent);
 wxDEFINE_EVENT(EVT_UNDO_MODIFIED, wxCommandEvent);
@@ -88,43 +91,249 @@ namespace {
       );
       return result;
    }
+
+   //! Copy the tracks of l for a new undo state, except pending added tracks
+   /*!
+    Each track may share unchanged contents with the track at the same
+    position in previous, which is an undo state and so never modified.
+    Tracks are paired by position because each list numbers its tracks
+    afresh; a wrong pairing, as after a track is removed, only shares less.
+    */
+   std::shared_ptr<TrackList>
+   CopyForUndo(const TrackList &l, TrackList *previous)
+   {
+      std::vector<const Track *> previousTracks;
+      if (previous)
+         for (auto t : previous->Any())
+            previousTracks.push_back(t);
+
+      auto tracksCopy = TrackList::Create( nullptr );
+      size_t ii = 0;
+      for (auto t : l) {
+         if ( t->GetId() == TrackId{} )
+            // Don't copy a pending added track
+            continue;
+         const auto pPrevious =
+            ii < previousTracks.size() ? previousTracks[ii] : nullptr;
+         ++ii;
+         tracksCopy->Add(t->DuplicateForUndo(pPrevious));
+      }
+      return tracksCopy;
+   }
 }
 
 void UndoManager::CalculateSpaceUsage()
 {
-   space.clear();
-   space.resize(stack.size(), 0);
-
+   // Count the usage of the clipboard separately.  Do not
+   // multiple-count any block occurring multiple times within the clipboard.
    SampleBlockIDSet seen;
+   mClipboardSpaceUsage = CalculateUsage(
+      Clipboard::Get().GetTracks(), seen);
+}
 
-   // After copies and pastes, a block file may be used in more than
-   // one place in one undo history state, and it may be used in more than
-   // one undo history state.  It might even be used in two states, but not
-   // in another state that is between them -- as when you have state A,
-   // then make a cut to get state B, but then paste it back into state C.
-
-   // So be sure to count each block file once only, in the last undo item that
-   // contains it.
+// After copies and pastes, a block file may be used in more than
+// one place in one undo history state, and it may be used in more than
+// one undo history state.  It might even be used in two states, but not
+// in another state that is between them -- as when you have state A,
+// then make a cut to get state B, but then paste it back into state C.
+
+// So be sure to count each block file once only, in the last undo item that
+// contains it.
+
+// Why the last and not the first? Because the user of the History dialog
+// may DELETE undo states, oldest first.  To reclaim disk space you must
+// DELETE all states containing the block file.  So the block file's
+// contribution to space usage should be counted only in that latest state.
+
+// The counts are updated as each state is added or removed, so that the
+// History window need not visit every block of every state.  States share
+// the clips that did not change, so usage is kept for each clip object, and
+// each block is owned by one of its clips, which is in the latest state.  A
+// clip carried into a new state moves its whole charge at once, and only the
+// blocks of new clips are visited.  When the latest holder of a block goes
+// away, the next latest is found by visiting only the clips that contain
+// blocks they do not own.
 
-   // Why the last and not the first? Because the user of the History dialog
-   // may DELETE undo states, oldest first.  To reclaim disk space you must
-   // DELETE all states containing the block file.  So the block file's
-   // contribution to space usage should be counted only in that latest state.
+namespace {
+   //! Visit each clip of the tracks once, with the cutlines
+   template<typename Function>
+   void ForEachClip(const TrackList &tracks, const Function &function)
+   {
+      std::unordered_set<const WaveClip *> seen;
+      for (auto wt : tracks.Any<const WaveTrack>())
+         for (const auto pClip : wt->GetAllClips())
+            if (seen.insert(pClip).second)
+               function(pClip);
+   }
 
-   for (size_t nn = stack.size(); nn--;)
+   //! Visit each block of the clip once
+   template<typename Function>
+   void ForEachBlock(const WaveClip &clip, const Function &function)
    {
-      // Scan all tracks at current level
-      auto &tracks = *stack[nn]->state.tracks;
-      space[nn] = CalculateUsage(tracks, seen);
+      SampleBlockIDSet seen;
+      for (const auto &block : clip.GetSequence()->GetBlockArray()) {
+         const auto &pBlock = block.sb;
+         if (pBlock && seen.insert(pBlock->GetBlockID()).second)
+            function(*pBlock);
+      }
    }
+}
 
-   // Count the usage of the clipboard separately, using another set.  Do not
-   // multiple-count any block occurring multiple times within the clipboard.
-   seen.clear();
-   mClipboardSpaceUsage = CalculateUsage(
-      Clipboard::Get().GetTracks(), seen);
+size_t UndoManager::FindSerial(unsigned long long serial) const
+{
+   auto iter = std::lower_bound(mSerials.begin(), mSerials.end(), serial);
+   wxASSERT(iter != mSerials.end() && *iter == serial);
+   return iter - mSerials.begin();
+}
 
-   //TIMER_STOP( space_calc );
+void UndoManager::TakeBlock(
+   BlockUsage &usage, const WaveClip *pClip, ClipUsage &clipUsage)
+{
+   if (usage.owner) {
+      auto &ownerUsage = mClipUsage[usage.owner];
+      ownerUsage.space -= usage.space;
+      space[FindSerial(ownerUsage.latest)] -= usage.space;
+      ++ownerUsage.unowned;
+   }
+   usage.owner = pClip;
+   clipUsage.space += usage.space;
+   space[FindSerial(clipUsage.latest)] += usage.space;
+}
+
+void UndoManager::AddSpaceUsage(size_t n)
+{
+   const auto serial = mSerials[n];
+   ForEachClip(*stack[n]->state.tracks, [&](const WaveClip *pClip){
+      auto [iter, inserted] = mClipUsage.try_emplace(pClip);
+      auto &clipUsage = iter->second;
+      ++clipUsage.count;
+      if (!inserted) {
+         // Shared with another state, as when unchanged since the previous
+         if (clipUsage.latest >= serial)
+            return;
+         space[FindSerial(clipUsage.latest)] -= clipUsage.space;
+         clipUsage.latest = serial;
+         space[n] += clipUsage.space;
+         if (clipUsage.unowned == 0)
+            return;
+         // Some of its blocks may now have no holder as late as this one
+         ForEachBlock(*pClip, [&](const SampleBlock &block){
+            auto &usage = mBlockUsage[block.GetBlockID()];
+            if (usage.owner != pClip &&
+                mClipUsage[usage.owner].latest < serial) {
+               TakeBlock(usage, pClip, clipUsage);
+               --clipUsage.unowned;
+            }
+         });
+         return;
+      }
+
+      clipUsage.latest = serial;
+      ForEachBlock(*pClip, [&](const SampleBlock &block){
+         auto &usage = mBlockUsage[block.GetBlockID()];
+         if (usage.count++ == 0) {
+            usage.space = block.GetSpaceUsage();
+            mTotalSpaceUsage += usage.space;
+            TakeBlock(usage, pClip, clipUsage);
+         }
+         else if (mClipUsage[usage.owner].latest < serial)
+            TakeBlock(usage, pClip, clipUsage);
+         else
+            ++clipUsage.unowned;
+      });
+   });
+}
+
+void UndoManager::RemoveSpaceUsage(size_t n, const TrackList &tracks)
+{
+   const auto serial = mSerials[n];
+
+   // Clips whose latest state this was, but which other states still have
+   std::unordered_set<const WaveClip *> demoted;
+   // Blocks whose owner went away or was demoted, that other clips contain
+   SampleBlockIDSet orphans;
+
+   ForEachClip(tracks, [&](const WaveClip *pClip){
+      auto iter = mClipUsage.find(pClip);
+      if (iter == mClipUsage.end())
+         return;
+      auto &clipUsage = iter->second;
+      if (--clipUsage.count > 0) {
+         if (clipUsage.latest == serial)
+            demoted.insert(pClip);
+         return;
+      }
+      ForEachBlock(*pClip, [&](const SampleBlock &block){
+         const auto id = block.GetBlockID();
+         auto blockIter = mBlockUsage.find(id);
+         if (blockIter == mBlockUsage.end())
+            return;
+         auto &usage = blockIter->second;
+         if (usage.owner == pClip) {
+            space[n] -= usage.space;
+            usage.owner = nullptr;
+            orphans.insert(id);
+         }
+         if (--usage.count == 0) {
+            // Its owner, if not this clip, went away before
+            mTotalSpaceUsage -= usage.space;
+            mBlockUsage.erase(blockIter);
+            orphans.erase(id);
+         }
+      });
+      mClipUsage.erase(iter);
+   });
+
+   // Find the next latest state of each demoted clip, looking down from
+   // this one, which may already hold replacement tracks
+   for (size_t ii = n + 1; ii-- > 0 && !demoted.empty();) {
+      if (!stack[ii])
+         continue;
+      ForEachClip(*stack[ii]->state.tracks, [&](const WaveClip *pClip){
+         if (!demoted.erase(pClip))
+            return;
+         auto &clipUsage = mClipUsage[pClip];
+         if (mSerials[ii] == serial)
+            return;
+         space[n] -= clipUsage.space;
+         clipUsage.latest = mSerials[ii];
+         // Clips in states between may share its blocks
+         ForEachBlock(*pClip, [&](const SampleBlock &block){
+            const auto id = block.GetBlockID();
+            auto &usage = mBlockUsage[id];
+            if (usage.owner == pClip && usage.count > 1) {
+               usage.owner = nullptr;
+               clipUsage.space -= usage.space;
+               ++clipUsage.unowned;
+               orphans.insert(id);
+            }
+         });
+         space[ii] += clipUsage.space;
+      });
+   }
+   wxASSERT(demoted.empty());
+
+   // Give each orphan to the first clip containing it, looking down from the
+   // latest state.  Only clips containing blocks they do not own can.
+   std::unordered_set<const WaveClip *> visited;
+   for (size_t ii = stack.size(); ii-- > 0 && !orphans.empty();) {
+      if (!stack[ii])
+         continue;
+      ForEachClip(*stack[ii]->state.tracks, [&](const WaveClip *pClip){
+         auto &clipUsage = mClipUsage[pClip];
+         if (clipUsage.unowned == 0 || !visited.insert(pClip).second)
+            return;
+         ForEachBlock(*pClip, [&](const SampleBlock &block){
+            auto iter = orphans.find(block.GetBlockID());
+            if (iter == orphans.end())
+               return;
+            orphans.erase(iter);
+            TakeBlock(mBlockUsage[block.GetBlockID()], pClip, clipUsage);
+            --clipUsage.unowned;
+         });
+      });
+   }
+   wxASSERT(orphans.empty());
 }
 
 wxLongLong_t UndoManager::GetLongDescription(
@@ -166,7 +375,10 @@ void UndoManager::RemoveStateAt(int n)
    // state.
    auto iter = stack.begin() + n;
    auto state = std::move(*iter);
+   RemoveSpaceUsage(n, *state->state.tracks);
    stack.erase(iter);
+   mSerials.erase(mSerials.begin() + n);
+   space.erase(space.begin() + n);
 }
 
 
@@ -281,20 +493,15 @@ void UndoManager::ModifyState(const TrackList * l,
    }
 
 //   SonifyBeginModifyState();
-   // Delete current -- not necessary, but let's reclaim space early
-   stack[current]->state.tracks.reset();
-
-   // Duplicate
-   auto tracksCopy = TrackList::Create( nullptr );
-   for (auto t : *l) {
-      if ( t->GetId() == TrackId{} )
-         // Don't copy a pending added track
-         continue;
-      tracksCopy->Add(t->Duplicate());
-   }
+   // Duplicate, sharing what is unchanged with the state being replaced
+   auto tracksCopy = CopyForUndo(*l, stack[current]->state.tracks.get());
 
-   // Replace
+   // Replace, counting the copy before discounting the replaced tracks, so
+   // that the clips they share need not move
+   auto replaced = std::move(stack[current]->state.tracks);
    stack[current]->state.tracks = std::move(tracksCopy);
+   AddSpaceUsage(current);
+   RemoveSpaceUsage(current, *replaced);
    stack[current]->state.tags = tags;
 
    stack[current]->state.selectedRegion = selectedRegion;
@@ -338,13 +545,8 @@ void UndoManager::PushState(const TrackList * l,
       return;
    }
 
-   auto tracksCopy = TrackList::Create( nullptr );
-   for (auto t : *l) {
-      if ( t->GetId() == TrackId{} )
-         // Don't copy a pending added track
-         continue;
-      tracksCopy->Add(t->Duplicate());
-   }
+   auto tracksCopy = CopyForUndo(*l,
+      current == wxNOT_FOUND ? nullptr : stack[current]->state.tracks.get());
 
    mayConsolidate = true;
 
@@ -357,6 +559,9 @@ void UndoManager::PushState(const TrackList * l,
          (std::move(tracksCopy),
             longDescription, shortDescription, selectedRegion, tags)
    );
+   mSerials.push_back(mNextSerial++);
+   space.push_back(0);
+   AddSpaceUsage(stack.size() - 1);
 
    current++;
 
@@ -49,6 +49,7 @@
 #ifndef __AUDACITY_UNDOMANAGER__
 #define __AUDACITY_UNDOMANAGER__
 
+#include <unordered_map>
 #include <vector>
 #include <wx/event.h> // to declare custom event types
 #include "ClientData.h"
@@ -81,6 +82,9 @@ class TenacityProject;
 class Tags;
 class Track;
 class TrackList;
+class WaveClip;
+
+using SampleBlockID = long long;
 
 struct UndoState {
    UndoState(std::shared_ptr<TrackList> &&tracks_,
@@ -169,7 +173,7 @@ class TENACITY_DLL_API UndoManager final
    void StopConsolidating() { mayConsolidate = false; }
 
    void GetShortDescription(unsigned int n, TranslatableString *desc);
-   // Return value must first be calculated by CalculateSpaceUsage():
+   //! Also returns the space usage of state n, which is always up to date
    wxLongLong_t GetLongDescription(
       unsigned int n, TranslatableString *desc, TranslatableString *size);
    void SetLongDescription(unsigned int n, const TranslatableString &desc);
@@ -196,12 +200,17 @@ class TENACITY_DLL_API UndoManager final
    int GetSavedState() const;
    void StateSaved();
 
+   //! Space used by the blocks of all states, each counted once
+   wxLongLong_t GetTotalSpaceUsage() const
+   { return mTotalSpaceUsage; }
+
    // Return value must first be calculated by CalculateSpaceUsage():
    // The clipboard is global, not specific to this project, but it is
    // convenient to combine the space usage calculations in one class:
    wxLongLong_t GetClipboardSpaceUsage() const
    { return mClipboardSpaceUsage; }
 
+   //! Calculate the usage of the clipboard; usage of states is kept current
    void CalculateSpaceUsage();
 
    // void Debug(); // currently unused
@@ -211,6 +220,20 @@ class TENACITY_DLL_API UndoManager final
 
    void RemoveStateAt(int n);
 
+   struct ClipUsage;
+   struct BlockUsage;
+
+   //! Count the clips of state n into the space usage
+   void AddSpaceUsage(size_t n);
+   //! Discount tracks, the clips that state n had, from the space usage
+   /*! The stack entry for n may be null, or hold tracks already added */
+   void RemoveSpaceUsage(size_t n, const TrackList &tracks);
+   //! Make the block owned by the clip, charging it to the clip's state
+   void TakeBlock(
+      BlockUsage &usage, const WaveClip *pClip, ClipUsage &clipUsage);
+   //! Index in the stack of the state with the given serial number
+   size_t FindSerial(unsigned long long serial) const;
+
    TenacityProject &mProject;
  
    int current;
@@ -220,8 +243,34 @@ class TENACITY_DLL_API UndoManager final
    TranslatableString lastAction;
    bool mayConsolidate { false };
 
+   //! Space usage of each state, parallel to stack
+   /*! A block used in several states is counted only in the last of them */
    SpaceArray space;
+   unsigned long long mTotalSpaceUsage {};
    unsigned long long mClipboardSpaceUsage {};
+
+   //! Increasing numbers identifying states, parallel to stack
+   std::vector<unsigned long long> mSerials;
+   unsigned long long mNextSerial {};
+
+   //! Usage of a clip object, which states share when it is unchanged
+   struct ClipUsage {
+      size_t count {}; //!< how many states contain the clip
+      unsigned long long latest {}; //!< serial of the latest of them
+      unsigned long long space {}; //!< of the blocks the clip owns
+      size_t unowned {}; //!< how many of its blocks other clips own
+   };
+   std::unordered_map<const WaveClip *, ClipUsage> mClipUsage;
+
+   //! Usage of a block, which clips share after copies and edits
+   /*! The block is owned by one of the clips containing it, in the latest
+    state that contains any of them, and its space is charged there */
+   struct BlockUsage {
+      unsigned long long space {};
+      size_t count {}; //!< how many clips contain the block
+      const WaveClip *owner {};
+   };
+   std::unordered_map<SampleBlockID, BlockUsage> mBlockUsage;
 };
 
 #endif
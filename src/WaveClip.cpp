@@ -18,6 +18,7 @@
 
 
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <wx/log.h>
@@ -117,6 +118,31 @@ WaveClip::WaveClip(const WaveClip& orig,
 }
 
 
+bool WaveClip::HasSameContents(const WaveClip &other) const
+{
+   if (mSequenceOffset != other.mSequenceOffset ||
+       mTrimLeft != other.mTrimLeft || mTrimRight != other.mTrimRight ||
+       mRate != other.mRate || mColourIndex != other.mColourIndex ||
+       mIsPlaceholder != other.mIsPlaceholder || mName != other.mName ||
+       *mEnvelope != *other.mEnvelope)
+      return false;
+
+   if (mSequence->GetSampleFormat() != other.mSequence->GetSampleFormat())
+      return false;
+   const auto &blocks = mSequence->GetBlockArray();
+   const auto &otherBlocks = other.mSequence->GetBlockArray();
+   if (!std::equal(blocks.begin(), blocks.end(),
+         otherBlocks.begin(), otherBlocks.end(),
+         [](const SeqBlock &a, const SeqBlock &b){
+            return a.sb == b.sb && a.start == b.start; }))
+      return false;
+
+   return std::equal(mCutLines.begin(), mCutLines.end(),
+      other.mCutLines.begin(), other.mCutLines.end(),
+      [](const WaveClipHolder &a, const WaveClipHolder &b){
+         return a->HasSameContents(*b); });
+}
+
 WaveClip::~WaveClip()
 {
 }
@@ -771,26 +797,50 @@ void WaveClip::SetRate(int rate)
 
 /*! @excsafety{Strong} */
 void WaveClip::Resample(int rate, GenericUI::ProgressDialog *progress)
+{
+   Resample(std::vector<WaveClip*>{ this }, rate, progress);
+}
+
+void WaveClip::Resample(const std::vector<WaveClip*> &clips, int rate,
+   GenericUI::ProgressDialog *progress)
 {
    // Note:  it is not necessary to do this recursively to cutlines.
    // They get resampled as needed when they are expanded.
 
-   if (rate == mRate)
+   if (clips.empty())
+      return;
+
+   const auto &first = *clips.front();
+   if (rate == first.mRate)
       return; // Nothing to do
 
-   double factor = (double)rate / (double)mRate;
-   ::Resample resample(true, factor, factor); // constant rate resampling
+   auto numSamples = first.mSequence->GetNumSamples();
+   wxASSERT(std::all_of(clips.begin(), clips.end(), [&](const WaveClip *clip){
+      return clip->mRate == first.mRate &&
+         clip->mSequence->GetNumSamples() == numSamples; }));
+
+   const auto nChannels = clips.size();
+   double factor = (double)rate / (double)first.mRate;
+   // constant rate resampling of all channels in step, letting the library
+   // convert them in parallel
+   ::Resample resample(true, factor, factor, nChannels, true, 0);
 
    const size_t bufsize = 65536;
-   Floats inBuffer{ bufsize };
-   Floats outBuffer{ bufsize };
+   std::vector<Floats> inBuffers, outBuffers;
+   std::vector<const float*> inPointers;
+   std::vector<float*> outPointers;
+   std::vector<std::unique_ptr<Sequence>> newSequences;
+   for (auto clip : clips) {
+      inBuffers.emplace_back(bufsize);
+      outBuffers.emplace_back(bufsize);
+      inPointers.push_back(inBuffers.back().get());
+      outPointers.push_back(outBuffers.back().get());
+      newSequences.push_back(std::make_unique<Sequence>(
+         clip->mSequence->GetFactory(), clip->mSequence->GetSampleFormat()));
+   }
    sampleCount pos = 0;
    bool error = false;
    int outGenerated = 0;
-   auto numSamples = mSequence->GetNumSamples();
-
-   auto newSequence =
-      std::make_unique<Sequence>(mSequence->GetFactory(), mSequence->GetSampleFormat());
 
    /**
     * We want to keep going as long as we have something to feed the resampler
@@ -803,14 +853,18 @@ void WaveClip::Resample(int rate, GenericUI::ProgressDialog *progress)
 
       bool isLast = ((pos + inLen) == numSamples);
 
-      if (!mSequence->Get((samplePtr)inBuffer.get(), floatSample, pos, inLen, true))
-      {
-         error = true;
+      for (size_t ii = 0; ii < nChannels; ++ii)
+         if (!clips[ii]->mSequence->Get(
+               (samplePtr)inBuffers[ii].get(), floatSample, pos, inLen, true))
+         {
+            error = true;
+            break;
+         }
+      if (error)
          break;
-      }
 
-      const auto results = resample.Process(factor, inBuffer.get(), inLen, isLast,
-                                            outBuffer.get(), bufsize);
+      const auto results = resample.Process(factor, inPointers.data(), inLen,
+         isLast, outPointers.data(), bufsize);
       outGenerated = results.second;
 
       pos += results.first;
@@ -821,8 +875,9 @@ void WaveClip::Resample(int rate, GenericUI::ProgressDialog *progress)
          break;
       }
 
-      newSequence->Append((samplePtr)outBuffer.get(), floatSample,
-                          outGenerated);
+      for (size_t ii = 0; ii < nChannels; ++ii)
+         newSequences[ii]->Append((samplePtr)outBuffers[ii].get(), floatSample,
+                                  outGenerated);
 
       if (progress)
       {
@@ -846,9 +901,12 @@ void WaveClip::Resample(int rate, GenericUI::ProgressDialog *progress)
    else
    {
       // Use No-fail-guarantee in these steps
-      mSequence = std::move(newSequence);
-      mRate = rate;
-      Caches::ForEach( std::mem_fn( &WaveClipListener::Invalidate ) );
+      for (size_t ii = 0; ii < nChannels; ++ii) {
+         auto &clip = *clips[ii];
+         clip.mSequence = std::move(newSequences[ii]);
+         clip.mRate = rate;
+         clip.Caches::ForEach( std::mem_fn( &WaveClipListener::Invalidate ) );
+      }
    }
 }
 
@@ -122,6 +122,12 @@ public:
 
    virtual ~WaveClip();
 
+   //! Whether a copy of this clip would be the same as a copy of the other
+   /*! Sample blocks must be shared, not only equal.  The append buffer is
+    ignored, as copying does.  No samples are read, but the time is in
+    proportion to the numbers of blocks and envelope points. */
+   bool HasSameContents(const WaveClip &other) const;
+
    void ConvertToSampleFormat(sampleFormat format,
       const std::function<void(size_t)> & progressReport = {});
 
@@ -139,6 +145,12 @@ public:
    // the length of the clip
    void Resample(int rate, GenericUI::ProgressDialog *progress = NULL);
 
+   //! Resample clips of equal rates and lengths, such as the channels of a
+   //! stereo clip, together, in one pass over their samples
+   /*! @excsafety{Strong} */
+   static void Resample(const std::vector<WaveClip*> &clips, int rate,
+      GenericUI::ProgressDialog *progress = NULL);
+
    void SetColourIndex( int index ){ mColourIndex = index;};
    int GetColourIndex( ) const { return mColourIndex;};
    
@@ -165,6 +165,11 @@ WaveTrack::WaveTrack( const SampleBlockFactoryPtr &pFactory,
 }
 
 WaveTrack::WaveTrack(const WaveTrack &orig)
+   : WaveTrack(orig, nullptr)
+{
+}
+
+WaveTrack::WaveTrack(const WaveTrack &orig, const WaveTrack *pPrevious)
    : WritableSampleTrack(orig)
    , mpFactory( orig.mpFactory )
    , mpSpectrumSettings(orig.mpSpectrumSettings
@@ -183,9 +188,20 @@ WaveTrack::WaveTrack(const WaveTrack &orig)
 
    Init(orig);
 
-   for (const auto &clip : orig.mClips)
-      mClips.push_back
-         ( std::make_unique<WaveClip>( *clip, mpFactory, true ) );
+   const auto nPrevious = pPrevious ? pPrevious->mClips.size() : 0;
+   for (size_t ii = 0; ii < orig.mClips.size(); ++ii) {
+      const auto &clip = orig.mClips[ii];
+      // Usually the clip is at the same index, if it is there at all
+      WaveClipHolder pShared;
+      for (size_t jj = 0; jj < nPrevious && !pShared; ++jj) {
+         const auto &previousClip = pPrevious->mClips[(ii + jj) % nPrevious];
+         if (clip->HasSameContents(*previousClip))
+            pShared = previousClip;
+      }
+      mClips.push_back(pShared
+         ? pShared
+         : std::make_shared<WaveClip>( *clip, mpFactory, true ));
+   }
 }
 
 // Copy the track metadata but not the contents.
@@ -465,6 +481,12 @@ Track::Holder WaveTrack::Clone() const
    return std::make_shared<WaveTrack>( *this );
 }
 
+Track::Holder WaveTrack::CloneForUndo(const Track &previous) const
+{
+   return std::make_shared<WaveTrack>(
+      *this, dynamic_cast<const WaveTrack*>(&previous));
+}
+
 wxString WaveTrack::MakeClipCopyName(const wxString& originalName) const
 {
    auto name = originalName;
@@ -2707,10 +2729,49 @@ void WaveTrack::MergeClips(int clipidx1, int clipidx2)
 */
 void WaveTrack::Resample(int rate, GenericUI::ProgressDialog *progress)
 {
-   for (const auto &clip : mClips)
-      clip->Resample(rate, progress);
+   Resample(std::vector<WaveTrack*>{ this }, rate, progress);
+}
+
+/*! @excsafety{Weak} -- Partial completion may leave clips at differing sample rates!
+*/
+void WaveTrack::Resample(const std::vector<WaveTrack*> &channels, int rate,
+   GenericUI::ProgressDialog *progress)
+{
+   if (channels.empty())
+      return;
+
+   // Clips of the other channels, not yet resampled
+   std::vector<std::vector<WaveClip*>> others;
+   for (size_t ii = 1; ii < channels.size(); ++ii) {
+      auto &clips = others.emplace_back();
+      for (const auto &clip : channels[ii]->mClips)
+         clips.push_back(clip.get());
+   }
+
+   for (const auto &clip : channels[0]->mClips) {
+      std::vector<WaveClip*> group{ clip.get() };
+      for (auto &clips : others) {
+         auto iter = std::find_if(clips.begin(), clips.end(),
+            [&](const WaveClip *other){
+               return other->GetRate() == clip->GetRate() &&
+                  other->GetSequenceStartTime() == clip->GetSequenceStartTime() &&
+                  other->GetSequenceSamplesCount() ==
+                     clip->GetSequenceSamplesCount();
+            });
+         if (iter != clips.end()) {
+            group.push_back(*iter);
+            clips.erase(iter);
+         }
+      }
+      WaveClip::Resample(group, rate, progress);
+   }
+
+   for (auto &clips : others)
+      for (auto clip : clips)
+         clip->Resample(rate, progress);
 
-   mRate = rate;
+   for (auto channel : channels)
+      channel->mRate = rate;
 }
 
 namespace {
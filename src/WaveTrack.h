@@ -90,6 +90,9 @@ public:
    WaveTrack(
       const SampleBlockFactoryPtr &pFactory, sampleFormat format, double rate);
    WaveTrack(const WaveTrack &orig);
+   //! Copy, but share those clips of previous that are the same as clips of
+   //! orig, instead of copying them; see Track::DuplicateForUndo()
+   WaveTrack(const WaveTrack &orig, const WaveTrack *pPrevious);
 
    // overwrite data excluding the sample sequence but including display
    // settings
@@ -98,6 +101,7 @@ private:
    void Init(const WaveTrack &orig);
 
    Track::Holder Clone() const override;
+   Track::Holder CloneForUndo(const Track &previous) const override;
 
    friend class WaveTrackFactory;
 
@@ -321,6 +325,9 @@ private:
    bool CloseLock(); //should be called when the project closes.
    // not balanced by unlocking calls.
 
+   const SampleBlockFactoryPtr &GetSampleBlockFactory() const
+   { return mpFactory; }
+
    // Get access to the (visible) clips in the tracks, in unspecified order
    // (not necessarily sequenced in time).
    WaveClipHolders &GetClips() { return mClips; }
@@ -498,6 +505,11 @@ private:
    // Resample track (i.e. all clips in the track)
    void Resample(int rate, GenericUI::ProgressDialog *progress = NULL);
 
+   //! Resample the channels of a track, each clip together with the clips
+   //! of the other channels that have the same place and length
+   static void Resample(const std::vector<WaveTrack*> &channels, int rate,
+      GenericUI::ProgressDialog *progress = NULL);
+
    const TypeInfo &GetTypeInfo() const override;
    static const TypeInfo &ClassTypeInfo();
 
@@ -123,6 +123,11 @@ unsigned EffectAmplify::GetAudioOutCount()
    return 1;
 }
 
+bool EffectAmplify::SupportsParallelProcessing()
+{
+   return true;
+}
+
 size_t EffectAmplify::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
    for (decltype(blockLen) i = 0; i < blockLen; i++)
@@ -179,7 +184,11 @@ bool EffectAmplify::LoadFactoryDefaults()
    }
    mCanClip = false;
 
-   return TransferDataToWindow();
+   // The ratio for the peak is wanted also without the dialog
+   if (mUIDialog)
+      return TransferDataToWindow();
+
+   return true;
 }
 
 // Effect implementation
@@ -203,6 +212,24 @@ bool EffectAmplify::Init()
    return true;
 }
 
+bool EffectAmplify::CopySettingsTo(Effect &processor)
+{
+   auto pOther = dynamic_cast<EffectAmplify*>(&processor);
+   if (!pOther)
+      return false;
+
+   // The ratio is often 1 / peak, which the automation parameters would
+   // round to a float
+   pOther->mPeak = mPeak;
+   pOther->mRatio = mRatio;
+   pOther->mRatioClip = mRatioClip;
+   pOther->mAmp = mAmp;
+   pOther->mNewPeak = mNewPeak;
+   pOther->mCanClip = mCanClip;
+
+   return true;
+}
+
 void EffectAmplify::Preview(bool dryOnly)
 {
    auto cleanup1 = valueRestorer( mRatio );
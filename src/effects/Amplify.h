@@ -48,12 +48,14 @@ public:
 
    unsigned GetAudioInCount() override;
    unsigned GetAudioOutCount() override;
+   bool SupportsParallelProcessing() override;
    size_t ProcessBlock(float **inBlock, float **outBlock, size_t blockLen) override;
    bool DefineParams( ShuttleParams & S ) override;
 
    // Effect implementation
 
    bool Init() override;
+   bool CopySettingsTo(Effect &processor) override;
    void Preview(bool dryOnly) override;
    void PopulateOrExchange(ShuttleGui & S) override;
    bool TransferDataToWindow() override;
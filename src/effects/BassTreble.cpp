@@ -130,6 +130,11 @@ unsigned EffectBassTreble::GetAudioOutCount()
    return 1;
 }
 
+bool EffectBassTreble::SupportsParallelProcessing()
+{
+   return true;
+}
+
 bool EffectBassTreble::ProcessInitialize(sampleCount /* totalLen */, ChannelNames /* chanMap */)
 {
    InstanceInit(mMaster, mSampleRate);
@@ -217,6 +222,20 @@ bool EffectBassTreble::CheckWhetherSkipEffect()
 
 // Effect implementation
 
+bool EffectBassTreble::CopySettingsTo(Effect &processor)
+{
+   auto pOther = dynamic_cast<EffectBassTreble*>(&processor);
+   if (!pOther)
+      return false;
+
+   pOther->mBass = mBass;
+   pOther->mTreble = mTreble;
+   pOther->mGain = mGain;
+   pOther->mLink = mLink;
+
+   return true;
+}
+
 void EffectBassTreble::PopulateOrExchange(ShuttleGui & S)
 {
    S.SetBorder(5);
@@ -229,6 +229,11 @@ unsigned EffectDistortion::GetAudioOutCount()
    return 1;
 }
 
+bool EffectDistortion::SupportsParallelProcessing()
+{
+   return true;
+}
+
 bool EffectDistortion::ProcessInitialize(sampleCount /* totalLen */, ChannelNames /* chanMap */)
 {
    InstanceInit(mMaster, mSampleRate);
@@ -355,6 +360,19 @@ bool EffectDistortion::LoadFactoryPreset(int id)
 
 // Effect implementation
 
+bool EffectDistortion::CopySettingsTo(Effect &processor)
+{
+   auto pOther = dynamic_cast<EffectDistortion*>(&processor);
+   if (!pOther)
+      return false;
+
+   pOther->mParams = mParams;
+   pOther->mThreshold = mThreshold;
+   pOther->mbSavedFilterState = mbSavedFilterState;
+
+   return true;
+}
+
 void EffectDistortion::PopulateOrExchange(ShuttleGui & S)
 {
    S.AddSpace(0, 5);
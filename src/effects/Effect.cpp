@@ -20,6 +20,8 @@
 #include "TimeWarper.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 
 #include <wx/defs.h>
 #include <wx/sizer.h>
@@ -28,10 +30,12 @@
 #include <lib-files/wxFileNameWrapper.h>
 #include <lib-screen-geometry/ViewInfo.h>
 #include <lib-transactions/TransactionScope.h>
+#include <lib-utility/ThreadPool.h>
 
 #include "../AudioIO.h"
 #include "widgets/wxWidgetsBasicUI.h"
 #include "../LabelTrack.h"
+#include "LoadEffects.h"
 #include "../MixAndRender.h"
 #include "../PluginManager.h"
 #include "../ProjectAudioManager.h"
@@ -352,6 +356,16 @@ size_t Effect::GetTailSize()
    return 0;
 }
 
+bool Effect::SupportsParallelProcessing()
+{
+   if (mClient)
+   {
+      return mClient->SupportsParallelProcessing();
+   }
+
+   return false;
+}
+
 bool Effect::ProcessInitialize(sampleCount totalLen, ChannelNames chanMap)
 {
    if (mClient)
@@ -1187,16 +1201,16 @@ bool Effect::ProcessPass()
    bool bGoodResult = true;
    bool isGenerator = GetType() == EffectTypeGenerate;
 
-   FloatBuffers inBuffer, outBuffer;
-   ArrayOf<float *> inBufPos, outBufPos;
-
-   ChannelName map[3];
-
    mBufferSize = 0;
    mBlockSize = 0;
 
+   // Tracks are gathered, to be processed in other threads, if the effect
+   // allows it
+   const bool parallel = GetType() == EffectTypeProcess &&
+      SupportsParallelProcessing() && ThreadPool::Get().GetNumThreads() > 0;
+   std::vector<PassTrack> tracks;
+
    int count = 0;
-   bool clear = false;
 
    const bool multichannel = mNumAudioIn > 1;
    auto range = multichannel
@@ -1207,11 +1221,9 @@ bool Effect::ProcessPass()
          if (!left->GetSelected())
             return fallthrough();
 
-         sampleCount len = 0;
-         sampleCount start = 0;
-
-         mNumChannels = 0;
-         WaveTrack *right{};
+         PassTrack track;
+         track.left = left;
+         unsigned numChannels = 0;
 
          // Iterate either over one track which could be any channel,
          // or if multichannel, then over all channels of left,
@@ -1219,98 +1231,36 @@ bool Effect::ProcessPass()
          for (auto channel :
               TrackList::Channels(left).StartingWith(left)) {
             if (channel->GetChannel() == Track::LeftChannel)
-               map[mNumChannels] = ChannelNameFrontLeft;
+               track.map[numChannels] = ChannelNameFrontLeft;
             else if (channel->GetChannel() == Track::RightChannel)
-               map[mNumChannels] = ChannelNameFrontRight;
+               track.map[numChannels] = ChannelNameFrontRight;
             else
-               map[mNumChannels] = ChannelNameMono;
+               track.map[numChannels] = ChannelNameMono;
 
-            ++ mNumChannels;
-            map[mNumChannels] = ChannelNameEOL;
+            ++ numChannels;
+            track.map[numChannels] = ChannelNameEOL;
 
             if (! multichannel)
                break;
 
-            if (mNumChannels == 2) {
+            if (numChannels == 2) {
                // TODO: more-than-two-channels
-               right = channel;
-               clear = false;
+               track.right = channel;
                // Ignore other channels
                break;
             }
          }
 
          if (!isGenerator)
-         {
-            GetBounds(*left, right, &start, &len);
-            mSampleCnt = len;
-         }
-         else
-            mSampleCnt = left->TimeToLongSamples(mDuration);
-
-         // Let the client know the sample rate
-         SetSampleRate(left->GetRate());
-
-         // Get the block size the client wants to use
-         auto max = left->GetMaxBlockSize() * 2;
-         mBlockSize = SetBlockSize(max);
-
-         // Calculate the buffer size to be at least the max rounded up to the clients
-         // selected block size.
-         const auto prevBufferSize = mBufferSize;
-         mBufferSize = ((max + (mBlockSize - 1)) / mBlockSize) * mBlockSize;
-
-         // If the buffer size has changed, then (re)allocate the buffers
-         if (prevBufferSize != mBufferSize)
-         {
-            // Always create the number of input buffers the client expects even if we don't have
-            // the same number of channels.
-            inBufPos.reinit( mNumAudioIn );
-            inBuffer.reinit( mNumAudioIn, mBufferSize );
-
-            // We won't be using more than the first 2 buffers, so clear the rest (if any)
-            for (size_t i = 2; i < mNumAudioIn; i++)
-            {
-               for (size_t j = 0; j < mBufferSize; j++)
-               {
-                  inBuffer[i][j] = 0.0;
-               }
-            }
-
-            // Always create the number of output buffers the client expects even if we don't have
-            // the same number of channels.
-            outBufPos.reinit( mNumAudioOut );
-            // Output buffers get an extra mBlockSize worth to give extra room if
-            // the plugin adds latency
-            outBuffer.reinit( mNumAudioOut, mBufferSize + mBlockSize );
-         }
-
-         // (Re)Set the input buffer positions
-         for (size_t i = 0; i < mNumAudioIn; i++)
-         {
-            inBufPos[i] = inBuffer[i].get();
-         }
-
-         // (Re)Set the output buffer positions
-         for (size_t i = 0; i < mNumAudioOut; i++)
-         {
-            outBufPos[i] = outBuffer[i].get();
-         }
+            GetBounds(*left, track.right, &track.start, &track.len);
 
-         // Clear unused input buffers
-         if (!right && !clear && mNumAudioIn > 1)
-         {
-            for (size_t j = 0; j < mBufferSize; j++)
-            {
-               inBuffer[1][j] = 0.0;
-            }
-            clear = true;
+         if (parallel) {
+            tracks.push_back(track);
+            return;
          }
 
          // Go process the track(s)
-         bGoodResult = ProcessTrack(
-            count, map, left, right, start, len,
-            inBuffer, outBuffer, inBufPos, outBufPos);
+         bGoodResult = ProcessPassTrack(count, track);
          if (!bGoodResult)
             return;
 
@@ -1322,6 +1272,9 @@ bool Effect::ProcessPass()
       }
    );
 
+   if (bGoodResult && parallel)
+      bGoodResult = ProcessParallelPass(tracks);
+
    if (bGoodResult && GetType() == EffectTypeGenerate)
    {
       mT1 = mT0 + mDuration;
@@ -1330,6 +1283,141 @@ bool Effect::ProcessPass()
    return bGoodResult;
 }
 
+bool Effect::ProcessPassTrack(int count, const PassTrack &track)
+{
+   const auto left = track.left;
+   const auto right = track.right;
+   ChannelName map[3];
+   std::copy(std::begin(track.map), std::end(track.map), map);
+
+   mNumChannels = right ? 2 : 1;
+   if (GetType() != EffectTypeGenerate)
+      mSampleCnt = track.len;
+   else
+      mSampleCnt = left->TimeToLongSamples(mDuration);
+
+   // Let the client know the sample rate
+   SetSampleRate(left->GetRate());
+
+   // Get the block size the client wants to use
+   auto max = left->GetMaxBlockSize() * 2;
+   mBlockSize = SetBlockSize(max);
+
+   // Calculate the buffer size to be at least the max rounded up to the clients
+   // selected block size.
+   mBufferSize = ((max + (mBlockSize - 1)) / mBlockSize) * mBlockSize;
+
+   // Always create the number of input buffers the client expects even if we don't have
+   // the same number of channels.  Those we won't be using are left cleared.
+   ArrayOf<float *> inBufPos{ mNumAudioIn };
+   FloatBuffers inBuffer{ mNumAudioIn, mBufferSize, true };
+
+   // Always create the number of output buffers the client expects even if we don't have
+   // the same number of channels.
+   ArrayOf<float *> outBufPos{ mNumAudioOut };
+   // Output buffers get an extra mBlockSize worth to give extra room if
+   // the plugin adds latency
+   FloatBuffers outBuffer{ mNumAudioOut, mBufferSize + mBlockSize };
+
+   // Set the input buffer positions
+   for (size_t i = 0; i < mNumAudioIn; i++)
+   {
+      inBufPos[i] = inBuffer[i].get();
+   }
+
+   // Set the output buffer positions
+   for (size_t i = 0; i < mNumAudioOut; i++)
+   {
+      outBufPos[i] = outBuffer[i].get();
+   }
+
+   // Go process the track(s)
+   return ProcessTrack(
+      count, map, left, right, track.start, track.len,
+      inBuffer, outBuffer, inBufPos, outBufPos);
+}
+
+struct Effect::ParallelPass {
+   explicit ParallelPass(size_t nTracks) : progress(nTracks) {}
+
+   //! @return whether to stop
+   bool Report(int whichTrack, double frac)
+   {
+      if (whichTrack >= 0 && size_t(whichTrack) < progress.size())
+         progress[whichTrack] = frac;
+      return cancelled;
+   }
+
+   //! Fraction done of each track
+   std::vector<std::atomic<double>> progress;
+   //! Index of the next track for any processor
+   std::atomic<size_t> next{ 0 };
+   std::atomic<bool> cancelled{ false };
+};
+
+bool Effect::ProcessParallelPass(const std::vector<PassTrack> &tracks)
+{
+   auto &pool = ThreadPool::Get();
+   ParallelPass pass{ tracks.size() };
+
+   // Make the processors in this thread, each to do one track at a time
+   std::vector<std::unique_ptr<Effect>> processors;
+   const auto nProcessors = std::min(tracks.size(), pool.GetNumThreads());
+   while (processors.size() < nProcessors) {
+      auto pProcessor = MakeProcessor();
+      if (!pProcessor)
+         break;
+      pProcessor->mpParallelPass = &pass;
+      processors.push_back(std::move(pProcessor));
+   }
+
+   // One processor gains nothing from another thread
+   if (processors.size() < 2) {
+      for (size_t ii = 0; ii < tracks.size(); ++ii)
+         if (!ProcessPassTrack(ii, tracks[ii]))
+            return false;
+      return true;
+   }
+
+   std::vector<std::future<bool>> results;
+   // Workers refer to the pass and the processors until they finish
+   auto waitAll = finally([&]{
+      pass.cancelled = true;
+      for (auto &result : results)
+         result.wait();
+   });
+
+   for (auto &pProcessor : processors)
+      results.push_back(pool.Async(
+      [&pass, &tracks, &processor = *pProcessor]{
+         size_t ii;
+         while (!pass.cancelled && (ii = pass.next++) < tracks.size())
+            if (!processor.ProcessPassTrack(ii, tracks[ii])) {
+               pass.cancelled = true;
+               return false;
+            }
+         return true;
+      }));
+
+   for (auto &result : results)
+      while (result.wait_for(std::chrono::milliseconds(50)) !=
+             std::future_status::ready) {
+         double done = 0;
+         for (auto &frac : pass.progress)
+            done += frac;
+         if (mProgress &&
+             mProgress->Poll(done * 1000, tracks.size() * 1000) !=
+               ProgressResult::Success)
+            pass.cancelled = true;
+      }
+
+   // Rethrow any exception from a worker
+   bool bGoodResult = true;
+   for (auto &result : results)
+      bGoodResult = result.get() && bGoodResult;
+   return bGoodResult && !pass.cancelled;
+}
+
 bool Effect::ProcessTrack(int count,
                           ChannelNames map,
                           WaveTrack *left,
@@ -1691,6 +1779,34 @@ bool Effect::ProcessTrack(int count,
    return rc;
 }
 
+std::unique_ptr<Effect> Effect::MakeProcessor()
+{
+   // Only built-in effects can be instantiated again
+   if (mClient)
+      return nullptr;
+
+   auto pEffect = BuiltinEffectsModule::Create(GetPath());
+   if (!pEffect || !pEffect->Startup(nullptr))
+      return nullptr;
+
+   pEffect->mIsBatch = mIsBatch;
+   pEffect->mPass = mPass;
+   pEffect->mNumAudioIn = mNumAudioIn;
+   pEffect->mNumAudioOut = mNumAudioOut;
+
+   if (!CopySettingsTo(*pEffect))
+      return nullptr;
+
+   return pEffect;
+}
+
+bool Effect::CopySettingsTo(Effect &processor)
+{
+   wxString parms;
+   return GetAutomationParametersAsString(parms) &&
+      processor.SetAutomationParametersFromString(parms);
+}
+
 void Effect::End()
 {
 }
@@ -1798,6 +1914,8 @@ void Effect::IncludeNotSelectedPreviewTracks(bool includeNotSelected)
 
 bool Effect::TotalProgress(double frac, const TranslatableString &msg)
 {
+   if (mpParallelPass)
+      return mpParallelPass->cancelled;
    auto updateResult = (mProgress ?
       mProgress->Poll(frac * 1000, 1000, msg) :
       ProgressResult::Success);
@@ -1806,6 +1924,8 @@ bool Effect::TotalProgress(double frac, const TranslatableString &msg)
 
 bool Effect::TrackProgress(int whichTrack, double frac, const TranslatableString &msg)
 {
+   if (mpParallelPass)
+      return mpParallelPass->Report(whichTrack, frac);
    auto updateResult = (mProgress ?
       mProgress->Poll(whichTrack + frac, (double) mNumTracks, msg) :
       ProgressResult::Success);
@@ -1814,6 +1934,8 @@ bool Effect::TrackProgress(int whichTrack, double frac, const TranslatableString
 
 bool Effect::TrackGroupProgress(int whichGroup, double frac, const TranslatableString &msg)
 {
+   if (mpParallelPass)
+      return mpParallelPass->Report(whichGroup, frac);
    auto updateResult = (mProgress ?
       mProgress->Poll(whichGroup + frac, (double) mNumGroups, msg) :
       ProgressResult::Success);
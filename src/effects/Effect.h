@@ -135,6 +135,7 @@ class TENACITY_DLL_API Effect /* not final */ : public wxEvtHandler,
 
    sampleCount GetLatency() override;
    size_t GetTailSize() override;
+   bool SupportsParallelProcessing() override;
 
    void SetSampleRate(double rate) override;
    size_t SetBlockSize(size_t maxBlockSize) override;
@@ -273,6 +274,25 @@ protected:
    virtual bool InitPass1();
    virtual bool InitPass2();
 
+   //! Make another instance with the same settings, for ProcessPass() to
+   //! give tracks of its own in another thread
+   /*!
+    Called only if SupportsParallelProcessing().  The default makes a NEW
+    built-in effect and calls CopySettingsTo() for it, or else returns null,
+    and then tracks are processed one by one.
+    */
+   virtual std::unique_ptr<Effect> MakeProcessor();
+
+   //! Give a processor from MakeProcessor() the settings of this effect
+   /*!
+    The default copies the automation parameters, which are text of limited
+    precision, verified against their ranges again.  Effects with settings
+    that don't survive that override this to copy them exactly, so that
+    each track is processed as it would be by this effect.
+    @param processor an effect of the same type as this
+    */
+   virtual bool CopySettingsTo(Effect &processor);
+
    // clean up any temporary memory, needed only per invocation of the
    // effect, after either successful or failed or exception-aborted processing.
    // Invoked inside a "finally" block so it must be no-throw.
@@ -453,6 +473,20 @@ protected:
 
    void CountWaveTracks();
 
+   //! A selected track, or a pair of channels, for ProcessPass()
+   struct PassTrack {
+      WaveTrack *left{};
+      WaveTrack *right{};
+      sampleCount start{ 0 };
+      sampleCount len{ 0 };
+      ChannelName map[3]{};
+   };
+   //! Shared by the processors of a pass over tracks in several threads
+   struct ParallelPass;
+
+   bool ProcessPassTrack(int count, const PassTrack &track);
+   bool ProcessParallelPass(const std::vector<PassTrack> &tracks);
+
    // Driver for client effects
    bool ProcessTrack(int count,
                      ChannelNames map,
@@ -498,6 +532,9 @@ private:
    size_t mBlockSize;
    unsigned mNumChannels;
 
+   //! Non-null only in the processors made by MakeProcessor()
+   ParallelPass *mpParallelPass{};
+
 public:
    const static wxString kUserPresetIdent;
    const static wxString kFactoryPresetIdent;
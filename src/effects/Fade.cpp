@@ -79,6 +79,11 @@ unsigned EffectFade::GetAudioOutCount()
    return 1;
 }
 
+bool EffectFade::SupportsParallelProcessing()
+{
+   return true;
+}
+
 bool EffectFade::ProcessInitialize(sampleCount /* totalLen */, ChannelNames /* chanMap */)
 {
    mSample = 0;
@@ -70,6 +70,11 @@ unsigned EffectInvert::GetAudioOutCount()
    return 1;
 }
 
+bool EffectInvert::SupportsParallelProcessing()
+{
+   return true;
+}
+
 size_t EffectInvert::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
    float *ibuf = inBlock[0];
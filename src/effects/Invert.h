@@ -37,6 +37,7 @@ public:
 
    unsigned GetAudioInCount() override;
    unsigned GetAudioOutCount() override;
+   bool SupportsParallelProcessing() override;
    size_t ProcessBlock(float **inBlock, float **outBlock, size_t blockLen) override;
 };
 
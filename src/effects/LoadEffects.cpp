@@ -199,6 +199,14 @@ BuiltinEffectsModule::CreateInstance(const PluginPath & path)
    return Instantiate(path);
 }
 
+std::unique_ptr<Effect> BuiltinEffectsModule::Create(const PluginPath & path)
+{
+   for ( const auto &entry : Entry::Registry() )
+      if ( path == wxString(BUILTIN_EFFECT_PREFIX) + entry.name.Internal() )
+         return entry.factory();
+   return nullptr;
+}
+
 // ============================================================================
 // BuiltinEffectsModule implementation
 // ============================================================================
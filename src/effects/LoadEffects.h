@@ -72,6 +72,10 @@ public:
    std::unique_ptr<ComponentInterface>
       CreateInstance(const PluginPath & path) override;
 
+   //! Make another instance of a built-in effect, owned by the caller
+   /*! @return null if there is no such effect */
+   static std::unique_ptr<Effect> Create(const PluginPath & path);
+
 private:
    // BuiltinEffectModule implementation
 
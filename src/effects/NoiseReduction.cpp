@@ -46,15 +46,22 @@
 // Tenacity libraries
 #include <lib-math/RealFFTf.h>
 #include <lib-preferences/Prefs.h>
+#include <lib-utility/ThreadPool.h>
 
 #include "../shuttle/ShuttleGui.h"
 #include "../widgets/HelpSystem.h"
 
+#include "../Sequence.h"
+#include "../WaveClip.h"
 #include "../WaveTrack.h"
 #include "../widgets/AudacityMessageBox.h"
 #include "../widgets/valnum.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <limits>
 #include <vector>
 #include <cmath>
 
@@ -277,6 +284,19 @@ private:
                    WaveTrackFactory &factory,
                    int count, WaveTrack *track,
                    sampleCount start, sampleCount len);
+   bool ProcessSegments(EffectNoiseReduction &effect,
+                   Statistics &statistics,
+                   int count, const WaveTrack &track,
+                   sampleCount start, sampleCount len,
+                   sampleCount segmentSteps, size_t nSegments,
+                   WaveTrack &outputTrack);
+   bool ProcessSegment(Statistics &statistics,
+                   const WaveTrack &track,
+                   sampleCount start, sampleCount len,
+                   sampleCount firstStep, sampleCount endStep,
+                   WaveTrack &outputTrack,
+                   std::atomic<long long> &done,
+                   const std::atomic<bool> &cancelled);
 
    void StartNewTrack();
    void ProcessSamples(Statistics &statistics,
@@ -292,6 +312,12 @@ private:
 
 private:
 
+   // For making more workers
+   const Settings &mSettings;
+#ifdef EXPERIMENTAL_SPECTRAL_EDITING
+   const double mF0, mF1;
+#endif
+
    const bool mDoProfile;
 
    const double mSampleRate;
@@ -323,6 +349,9 @@ private:
    sampleCount       mInSampleCount;
    sampleCount       mOutStepCount;
    int                   mInWavePos;
+   // Output steps in [mFirstOutStep, mEndOutStep) are written
+   sampleCount       mFirstOutStep;
+   sampleCount       mEndOutStep;
 
    float     mOneBlockAttack;
    float     mOneBlockRelease;
@@ -332,6 +361,8 @@ private:
    unsigned  mNWindowsToExamine;
    unsigned  mCenter;
    unsigned  mHistoryLen;
+   // Steps after which the gains no longer depend on earlier windows
+   unsigned  mWarmupSteps;
 
    struct Record
    {
@@ -758,7 +789,12 @@ EffectNoiseReduction::Worker::Worker
 , double f0, double f1
 #endif
 )
-: mDoProfile(settings.mDoProfile)
+: mSettings(settings)
+#ifdef EXPERIMENTAL_SPECTRAL_EDITING
+, mF0(f0), mF1(f1)
+#endif
+
+, mDoProfile(settings.mDoProfile)
 
 , mSampleRate(sampleRate)
 
@@ -829,6 +865,12 @@ EffectNoiseReduction::Worker::Worker
       mHistoryLen = std::max(mNWindowsToExamine, mCenter + nAttackBlocks);
    }
 
+   // Attack and release decay to the floor within their numbers of blocks,
+   // so that a window further than these from another can't affect it;
+   // allow twice as many, for rounding in the decay
+   mWarmupSteps = 2 *
+      (mHistoryLen + mStepsPerWindow + nAttackBlocks + nReleaseBlocks) + 4;
+
    mQueue.resize(mHistoryLen);
    for (unsigned ii = 0; ii < mHistoryLen; ++ii)
       mQueue[ii] = std::make_unique<Record>(mSpectrumSize);
@@ -943,6 +985,8 @@ void EffectNoiseReduction::Worker::StartNewTrack()
    }
 
    mInSampleCount = 0;
+   mFirstOutStep = 0;
+   mEndOutStep = std::numeric_limits<sampleCount::type>::max();
 }
 
 void EffectNoiseReduction::Worker::ProcessSamples
@@ -1303,7 +1347,7 @@ void EffectNoiseReduction::Worker::ReduceNoise
       }
 
       float *buffer = &mOutOverlapBuffer[0];
-      if (mOutStepCount >= 0) {
+      if (mOutStepCount >= mFirstOutStep && mOutStepCount < mEndOutStep) {
          // Output the first portion of the overlap buffer, they're done
          outputTrack->Append((samplePtr)buffer, floatSample, mStepSize);
       }
@@ -1327,40 +1371,58 @@ bool EffectNoiseReduction::Worker::ProcessOne
    if(!mDoProfile)
       outputTrack = track->EmptyCopy();
 
-   auto bufferSize = track->GetMaxBlockSize();
-   FloatVector buffer(bufferSize);
+   // Long tracks are divided into segments for other threads.  Segments are
+   // long compared with the warm-up of each, and several for each thread,
+   // to balance the load.
+   // Profiling sums statistics in order, so it is done in this thread.
+   const auto nThreads = ThreadPool::Get().GetNumThreads();
+   const auto nSteps = (len + mStepSize - 1) / mStepSize;
+   const auto segmentSteps = std::max<sampleCount>(8 * mWarmupSteps,
+      nSteps / (4 * (nThreads + 1)) + 1);
+   const auto nSegments =
+      ((nSteps + segmentSteps - 1) / segmentSteps).as_size_t();
+   if (!mDoProfile && nThreads > 0 && nSegments > 1) {
+      if (!ProcessSegments(effect, statistics, count, *track, start, len,
+            segmentSteps, nSegments, *outputTrack))
+         return false;
+   }
+   else {
+      auto bufferSize = track->GetMaxBlockSize();
+      FloatVector buffer(bufferSize);
+
+      bool bLoopSuccess = true;
+      auto samplePos = start;
+      while (bLoopSuccess && samplePos < start + len) {
+         //Get a blockSize of samples (smaller than the size of the buffer)
+         const auto blockSize = limitSampleBufferSize(
+            track->GetBestBlockSize(samplePos),
+            start + len - samplePos
+         );
 
-   bool bLoopSuccess = true;
-   auto samplePos = start;
-   while (bLoopSuccess && samplePos < start + len) {
-      //Get a blockSize of samples (smaller than the size of the buffer)
-      const auto blockSize = limitSampleBufferSize(
-         track->GetBestBlockSize(samplePos),
-         start + len - samplePos
-      );
+         //Get the samples from the track and put them in the buffer
+         track->GetFloats(&buffer[0], samplePos, blockSize);
+         samplePos += blockSize;
 
-      //Get the samples from the track and put them in the buffer
-      track->GetFloats(&buffer[0], samplePos, blockSize);
-      samplePos += blockSize;
+         mInSampleCount += blockSize;
+         ProcessSamples(statistics, outputTrack.get(), blockSize, &buffer[0]);
 
-      mInSampleCount += blockSize;
-      ProcessSamples(statistics, outputTrack.get(), blockSize, &buffer[0]);
+         // Update the Progress meter, let user cancel
+         bLoopSuccess =
+            !effect.TrackProgress(count,
+                                  ( samplePos - start ).as_double() /
+                                  len.as_double() );
+      }
 
-      // Update the Progress meter, let user cancel
-      bLoopSuccess = 
-         !effect.TrackProgress(count,
-                               ( samplePos - start ).as_double() /
-                               len.as_double() );
-   }
+      if (!bLoopSuccess)
+         return false;
 
-   if (bLoopSuccess) {
       if (mDoProfile)
          FinishTrackStatistics(statistics);
       else
          FinishTrack(statistics, &*outputTrack);
    }
 
-   if (bLoopSuccess && !mDoProfile) {
+   if (!mDoProfile) {
       // Flush the output WaveTrack (since it's buffered)
       outputTrack->Flush();
 
@@ -1373,7 +1435,139 @@ bool EffectNoiseReduction::Worker::ProcessOne
       track->ClearAndPaste(t0, t0 + tLen, &*outputTrack, true, false);
    }
 
-   return bLoopSuccess;
+   return true;
+}
+
+bool EffectNoiseReduction::Worker::ProcessSegments
+(EffectNoiseReduction &effect, Statistics &statistics,
+ int count, const WaveTrack &track, sampleCount start, sampleCount len,
+ sampleCount segmentSteps, size_t nSegments, WaveTrack &outputTrack)
+{
+   auto &pool = ThreadPool::Get();
+
+   struct Segment {
+      WaveTrack::Holder outputTrack;
+      std::future<bool> result;
+   };
+   std::vector<Segment> segments(nSegments);
+   std::atomic<long long> done{ 0 };
+   std::atomic<bool> cancelled{ false };
+   // Workers refer to the segments until they finish
+   auto waitAll = finally([&]{
+      cancelled = true;
+      for (auto &segment : segments)
+         if (segment.result.valid())
+            segment.result.wait();
+   });
+
+   for (size_t ii = 0; ii < nSegments; ++ii) {
+      auto &segment = segments[ii];
+      segment.outputTrack = track.EmptyCopy();
+      const auto firstStep = segmentSteps * ii;
+      // The last segment continues to the end, as one pass would
+      const auto endStep = (ii + 1 == nSegments)
+         ? std::numeric_limits<sampleCount::type>::max()
+         : firstStep + segmentSteps;
+      segment.result = pool.Async(
+      [&, firstStep, endStep, &output = *segment.outputTrack]{
+         // Each thread needs its own FFT state and history of windows
+         Worker worker{ mSettings, mSampleRate
+#ifdef EXPERIMENTAL_SPECTRAL_EDITING
+            , mF0, mF1
+#endif
+         };
+         return worker.ProcessSegment(statistics, track, start, len,
+            firstStep, endStep, output, done, cancelled);
+      });
+   }
+
+   for (auto &segment : segments)
+      while (segment.result.wait_for(std::chrono::milliseconds(50)) !=
+             std::future_status::ready) {
+         // Update the Progress meter, let user cancel
+         if (effect.TrackProgress(count,
+               std::min(1.0, done.load() / len.as_double())))
+            cancelled = true;
+      }
+
+   // Rethrow any exception from a worker
+   bool bGoodResult = true;
+   for (auto &segment : segments)
+      bGoodResult = segment.result.get() && bGoodResult;
+   if (!bGoodResult || cancelled)
+      return false;
+
+   // Stitch the segments together, sharing their blocks
+   const auto pClip = outputTrack.RightmostOrNewClip();
+   for (auto &segment : segments) {
+      segment.outputTrack->Flush();
+      for (const auto &pSegmentClip : segment.outputTrack->GetClips())
+         for (const auto &block : *pSegmentClip->GetSequenceBlockArray())
+            pClip->AppendSharedBlock(block.sb);
+   }
+   pClip->UpdateEnvelopeTrackLen();
+
+   return true;
+}
+
+bool EffectNoiseReduction::Worker::ProcessSegment
+(Statistics &statistics, const WaveTrack &track,
+ sampleCount start, sampleCount len,
+ sampleCount firstStep, sampleCount endStep, WaveTrack &outputTrack,
+ std::atomic<long long> &done, const std::atomic<bool> &cancelled)
+{
+   StartNewTrack();
+   mFirstOutStep = firstStep;
+   mEndOutStep = endStep;
+
+   // Begin some windows early, so that the gains have settled by the first
+   // step written, as they would in one pass over the whole track
+   const auto firstWindow =
+      std::max<sampleCount>(0, firstStep - mWarmupSteps);
+   if (firstWindow > 0) {
+      // As at the start of a track, but with the samples before the first
+      // window instead of zero padding
+      const auto pos = firstWindow * mStepSize;
+      const size_t padding = mInWavePos;
+      const auto available =
+         std::min<sampleCount>(pos, padding).as_size_t();
+      track.GetFloats(&mInWaveBuffer[padding - available],
+         start + pos - available, available);
+      mOutStepCount += firstWindow;
+      mInSampleCount = pos;
+   }
+
+   auto bufferSize = track.GetMaxBlockSize();
+   FloatVector buffer(bufferSize);
+
+   auto reported = firstStep;
+   auto samplePos = start + mInSampleCount;
+   while (samplePos < start + len && mOutStepCount < mEndOutStep) {
+      if (cancelled)
+         return false;
+
+      const auto blockSize = limitSampleBufferSize(
+         track.GetBestBlockSize(samplePos),
+         start + len - samplePos
+      );
+      track.GetFloats(&buffer[0], samplePos, blockSize);
+      samplePos += blockSize;
+
+      mInSampleCount += blockSize;
+      ProcessSamples(statistics, &outputTrack, blockSize, &buffer[0]);
+
+      const auto written = std::min(mOutStepCount, mEndOutStep);
+      if (written > reported) {
+         done += ((written - reported) * mStepSize).as_long_long();
+         reported = written;
+      }
+   }
+
+   // The end of the track may come before the end of the segment
+   if (mOutStepCount < mEndOutStep)
+      FinishTrack(statistics, &outputTrack);
+
+   return !cancelled;
 }
 
 //----------------------------------------------------------------------------
@@ -144,6 +144,11 @@ unsigned EffectPhaser::GetAudioOutCount()
    return 1;
 }
 
+bool EffectPhaser::SupportsParallelProcessing()
+{
+   return true;
+}
+
 bool EffectPhaser::ProcessInitialize(sampleCount /* totalLen */, ChannelNames chanMap)
 {
    InstanceInit(mMaster, mSampleRate);
@@ -247,6 +252,23 @@ bool EffectPhaser::SetAutomationParameters(CommandParameters & parms)
 
 // Effect implementation
 
+bool EffectPhaser::CopySettingsTo(Effect &processor)
+{
+   auto pOther = dynamic_cast<EffectPhaser*>(&processor);
+   if (!pOther)
+      return false;
+
+   pOther->mStages = mStages;
+   pOther->mDryWet = mDryWet;
+   pOther->mFreq = mFreq;
+   pOther->mPhase = mPhase;
+   pOther->mDepth = mDepth;
+   pOther->mFeedback = mFeedback;
+   pOther->mOutGain = mOutGain;
+
+   return true;
+}
+
 void EffectPhaser::PopulateOrExchange(ShuttleGui & S)
 {
    S.SetBorder(5);
@@ -18,6 +18,7 @@
 #include <lib-track/Track.h>
 #include <lib-utility/MemoryX.h>
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <chrono>
@@ -60,10 +61,12 @@ bool RealtimeEffectManager::IsActive() const noexcept
    return mActive;
 }
 
-void RealtimeEffectManager::Initialize(double rate)
+void RealtimeEffectManager::Initialize(double rate, size_t blockSize)
 {
    // Remember the rate
    mRate = rate;
+   mBlockSize = std::max<size_t>(1, blockSize);
+   mScratch.clear();
 
    // (Re)Set processor parameters
    mChans.clear();
@@ -90,6 +93,12 @@ void RealtimeEffectManager::AddTrack(Track *track, unsigned chans, float rate)
    mChans.insert({leader, chans});
    mRates.insert({leader, rate});
 
+   // Allocate now what Process() needs for this many channels
+   while (mScratch.size() < chans)
+      mScratch.emplace_back(mBlockSize);
+   mInputBuffers.reserve(mScratch.size());
+   mOutputBuffers.reserve(mScratch.size());
+
    VisitGroup(leader,
       [&](RealtimeEffectState & state, bool) {
          state.AddTrack(leader, chans, rate);
@@ -111,6 +120,7 @@ void RealtimeEffectManager::Finalize() noexcept
    mGroupLeaders.clear();
    mChans.clear();
    mRates.clear();
+   mScratch.clear();
 
    // No longer active
    mActive = false;
@@ -159,9 +169,6 @@ void RealtimeEffectManager::Resume() noexcept
 //
 void RealtimeEffectManager::ProcessStart()
 {
-   // Protect ourselves from the main thread
-   LockGuard lock(mLock);
-
    // Can be suspended because of the audio stream being paused or because effects
    // have been suspended.
    if (!mSuspended)
@@ -182,26 +189,18 @@ size_t RealtimeEffectManager::Process(Track *track,
 {
    using namespace std::chrono;
 
-   // Protect ourselves from the main thread
-   LockGuard lock(mLock);
-
    // Can be suspended because of the audio stream being paused or because effects
    // have been suspended, so allow the samples to pass as-is.
    if (mSuspended)
       return numSamples;
 
-   auto chans = mChans[track];
-
-   // AK: If we have more channels than our input and output bufffers'
-   // capacities, increase their capacities when necessary.
-   if (mInputBuffers.capacity() < chans)
-   {
-      mInputBuffers.reserve(chans);
-   } else if (mOutputBuffers.capacity() < chans)
-   {
-      mOutputBuffers.reserve(chans);
-   }
+   // Don't use operator [], which may insert
+   const auto iter = mChans.find(track);
+   if (iter == mChans.end())
+      return numSamples;
+   const auto chans = std::min<size_t>(iter->second, mScratch.size());
 
+   // Within the capacities reserved by AddTrack()
    mInputBuffers.resize(chans);
    mOutputBuffers.resize(chans);
 
@@ -209,45 +208,58 @@ size_t RealtimeEffectManager::Process(Track *track,
    // are introducing
    auto start = steady_clock::now();
 
-   // Allocate the in/out buffer arrays
-   // GP: temporary fix until we convert Effect
-   AutoAllocator<float>  floatAllocator;
-
-   // And populate the input with the buffers we've been given while allocating
-   // NEW output buffers
-   for (unsigned int i = 0; i < chans; i++)
-   {
-      mInputBuffers[i] = buffers[i];
-      mOutputBuffers[i] = floatAllocator.Allocate(true, numSamples);
-   }
-
-   // Now call each effect in the chain while swapping buffer pointers to feed the
-   // output of one effect as the input to the next effect
-   // Tracks how many processors were called
-   size_t called = 0;
-   VisitGroup(track,
-      [&](RealtimeEffectState &state, bool bypassed)
+   // The visitor captures only one pointer, so that std::function stores it
+   // without allocating
+   struct Context {
+      Track *track;
+      unsigned chans;
+      size_t len;
+      std::vector<float*> &inputs;
+      std::vector<float*> &outputs;
+      size_t called;
+   } context{ track, chans, 0, mInputBuffers, mOutputBuffers, 0 };
+   const auto pContext = &context;
+
+   for (size_t offset = 0; offset < numSamples; offset += mBlockSize) {
+      context.len = std::min(mBlockSize, numSamples - offset);
+      context.called = 0;
+
+      // Populate the input with the buffers we've been given, and the output
+      // with our scratch buffers
+      for (size_t i = 0; i < chans; i++)
       {
-         if (bypassed)
-            return;
-
-         state.Process(track, chans, mInputBuffers.data(),
-                       mOutputBuffers.data(), numSamples);
-         for (auto i = 0; i < chans; ++i)
-            std::swap(mInputBuffers[i], mOutputBuffers[i]);
-         called++;
+         mInputBuffers[i] = buffers[i] + offset;
+         mOutputBuffers[i] = mScratch[i].get();
       }
-   );
 
-   // Once we're done, we might wind up with the last effect storing its results
-   // in the temporary buffers.  If that's the case, we need to copy it over to
-   // the caller's buffers.  This happens when the number of effects processed
-   // is odd.
-   if (called & 1)
-   {
-      for (unsigned int i = 0; i < chans; i++)
+      // Now call each effect in the chain while swapping buffer pointers to
+      // feed the output of one effect as the input to the next effect
+      VisitGroup(track,
+         [pContext](RealtimeEffectState &state, bool bypassed)
+         {
+            if (bypassed)
+               return;
+
+            auto &context = *pContext;
+            state.Process(context.track, context.chans,
+               context.inputs.data(), context.outputs.data(), context.len);
+            for (unsigned i = 0; i < context.chans; ++i)
+               std::swap(context.inputs[i], context.outputs[i]);
+            context.called++;
+         }
+      );
+
+      // Once we're done, we might wind up with the last effect storing its
+      // results in the scratch buffers.  If that's the case, we need to copy
+      // it over to the caller's buffers.  This happens when the number of
+      // effects processed is odd.
+      if (context.called & 1)
       {
-         memcpy(buffers[i], mInputBuffers[i], numSamples * sizeof(float));
+         for (size_t i = 0; i < chans; i++)
+         {
+            memcpy(buffers[i] + offset, mInputBuffers[i],
+               context.len * sizeof(float));
+         }
       }
    }
 
@@ -265,9 +277,6 @@ size_t RealtimeEffectManager::Process(Track *track,
 //
 void RealtimeEffectManager::ProcessEnd() noexcept
 {
-   // Protect ourselves from the main thread
-   LockGuard lock(mLock);
-
    // Can be suspended because of the audio stream being paused or because effects
    // have been suspended.
    if (!mSuspended)
@@ -22,6 +22,11 @@
 #include "ClientData.h"
 #include "ModuleInterface.h" // for PluginID
 
+// Tenacity libraries
+#include <lib-utility/MemoryX.h>
+
+using Floats = ArrayOf<float>;
+
 class TenacityProject;
 class EffectProcessor;
 class RealtimeEffectList;
@@ -78,13 +83,14 @@ private:
    friend RealtimeEffects::SuspensionScope;
 
    //! Main thread begins to define a set of tracks for playback
-   void Initialize(double rate);
+   void Initialize(double rate, size_t blockSize);
    //! Main thread adds one track (passing the first of one or more channels)
    void AddTrack(Track *track, unsigned chans, float rate);
    //! Main thread cleans up after playback
    void Finalize() noexcept;
 
    friend RealtimeEffects::ProcessingScope;
+   //! These three are called with mLock held by a ProcessingScope
    void ProcessStart();
    size_t Process(Track *track, float **buffers, size_t numSamples);
    void ProcessEnd() noexcept;
@@ -108,6 +114,10 @@ private:
    // of channels being processed.
    std::vector<float*> mInputBuffers;
    std::vector<float*> mOutputBuffers;
+   //! Outputs of effects, allocated by AddTrack() for at most mBlockSize
+   //! samples per channel, so that Process() does not allocate
+   std::vector<Floats> mScratch;
+   size_t mBlockSize{ 1 };
 
    std::mutex mLock;
    Latency mLatency{0};
@@ -127,12 +137,16 @@ namespace RealtimeEffects {
 class InitializationScope {
 public:
    InitializationScope() {}
+   /*!
+    @param blockSize the usual number of samples per channel to be processed
+    at once; larger numbers are processed in pieces
+    */
    explicit InitializationScope(
-      std::weak_ptr<TenacityProject> wProject, double rate)
+      std::weak_ptr<TenacityProject> wProject, double rate, size_t blockSize)
       : mwProject{ move(wProject) }
    {
       if (auto pProject = mwProject.lock())
-         RealtimeEffectManager::Get(*pProject).Initialize(rate);
+         RealtimeEffectManager::Get(*pProject).Initialize(rate, blockSize);
    }
    InitializationScope( InitializationScope &&other ) = default;
    InitializationScope& operator=( InitializationScope &&other ) = default;
@@ -182,36 +196,44 @@ private:
 };
 
 //! Brackets one block of processing in one thread
+/*!
+ The processing thread must not wait for the main thread, so if the main
+ thread is changing the effects, the block passes through unprocessed.
+
+ Nor may it lock or release the project:  the caller must keep the manager
+ alive, with a reference to the project taken in the main thread, for as
+ long as processing can happen
+ */
 class ProcessingScope {
 public:
    ProcessingScope() {}
    //! Require a prior InializationScope to ensure correct nesting
    explicit ProcessingScope(InitializationScope &,
-      std::weak_ptr<TenacityProject> wProject)
-      : mwProject{ move(wProject) }
+      RealtimeEffectManager &manager)
+      : mpManager{ &manager }
+      , mLock{ manager.mLock, std::try_to_lock }
    {
-      if (auto pProject = mwProject.lock())
-         RealtimeEffectManager::Get(*pProject).ProcessStart();
+      if (mLock.owns_lock())
+         mpManager->ProcessStart();
    }
    ProcessingScope( ProcessingScope &&other ) = default;
    ProcessingScope& operator=( ProcessingScope &&other ) = default;
    ~ProcessingScope()
    {
-      if (auto pProject = mwProject.lock())
-         RealtimeEffectManager::Get(*pProject).ProcessEnd();
+      if (mLock.owns_lock())
+         mpManager->ProcessEnd();
    }
 
    size_t Process(Track *track, float **buffers, size_t numSamples)
    {
-      if (auto pProject = mwProject.lock())
-         return RealtimeEffectManager::Get(*pProject)
-            .Process(track, buffers, numSamples);
-      else
+      if (!mLock.owns_lock())
          return numSamples; // consider them trivially processed
+      return mpManager->Process(track, buffers, numSamples);
    }
 
 private:
-   std::weak_ptr<TenacityProject> mwProject;
+   RealtimeEffectManager *mpManager{};
+   std::unique_lock<std::mutex> mLock;
 };
 }
 
@@ -135,6 +135,11 @@ unsigned EffectWahwah::GetAudioOutCount()
    return 1;
 }
 
+bool EffectWahwah::SupportsParallelProcessing()
+{
+   return true;
+}
+
 bool EffectWahwah::ProcessInitialize(sampleCount /* totalLen */, ChannelNames chanMap)
 {
    InstanceInit(mMaster, mSampleRate);
@@ -231,6 +236,22 @@ bool EffectWahwah::SetAutomationParameters(CommandParameters & parms)
 
 // Effect implementation
 
+bool EffectWahwah::CopySettingsTo(Effect &processor)
+{
+   auto pOther = dynamic_cast<EffectWahwah*>(&processor);
+   if (!pOther)
+      return false;
+
+   pOther->mFreq = mFreq;
+   pOther->mPhase = mPhase;
+   pOther->mDepth = mDepth;
+   pOther->mRes = mRes;
+   pOther->mFreqOfs = mFreqOfs;
+   pOther->mOutGain = mOutGain;
+
+   return true;
+}
+
 void EffectWahwah::PopulateOrExchange(ShuttleGui & S)
 {
    S.SetBorder(5);
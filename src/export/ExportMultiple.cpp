@@ -38,9 +38,13 @@
 #include <wx/textctrl.h>
 #include <wx/textdlg.h>
 
+#include <algorithm>
+#include <chrono>
+
 // Tenacity libraries
 #include <lib-files/FileNames.h>
 #include <lib-preferences/Prefs.h>
+#include <lib-utility/ThreadPool.h>
 
 #include "LabelTrack.h"
 #include "Project.h"
@@ -79,6 +83,10 @@ namespace {
     */
 }
 
+//! How many files Export Multiple writes at once, with worker threads
+static IntSetting ExportMultipleConcurrency{
+   L"/Export/MultipleConcurrency", 1 };
+
 /* define our dynamic array of export settings */
 
 enum {
@@ -432,6 +440,9 @@ void ExportMultipleDialog::PopulateOrExchange(ShuttleGui& S)
       mOverwrite = S.Id(OverwriteID).TieCheckBox(XXO("Overwrite existing files"),
                                                  {wxT("/Export/OverwriteExisting"),
                                                   false});
+      S.AddSpace(20, 0);
+      S.TieSpinCtrl(XXO("Files exported at once:"),
+                    ExportMultipleConcurrency, 64, 1);
    }
    S.EndHorizontalLay();
 
@@ -619,6 +630,7 @@ void ExportMultipleDialog::OnExport(wxCommandEvent& /* event */)
 //   bool overwrite = mOverwrite->GetValue();
    ProgressResult ok = ProgressResult::Failed;
    mExported.clear();
+   mFailed.clear();
 
    // Give 'em the result
    auto cleanup = finally( [&]
@@ -639,6 +651,15 @@ void ExportMultipleDialog::OnExport(wxCommandEvent& /* event */)
          FileList += mExported[i];
          FileList += '\n';
       }
+      if (!mFailed.empty()) {
+         FileList += '\n';
+         FileList += XO("Failed to export:").Translation();
+         FileList += '\n';
+         for (const auto &failed : mFailed) {
+            FileList += failed;
+            FileList += '\n';
+         }
+      }
 
       // TODO: give some warning dialog first, when only some files exported
       // successfully.
@@ -868,6 +889,16 @@ ProgressResult ExportMultipleDialog::ExportMultipleByLabel(bool byName,
       l++;  // next label, count up one
    }
 
+   if (const auto concurrency = BeginConcurrentExport(); concurrency > 1) {
+      std::vector<ConcurrentFile> files;
+      for (const auto &kit : exportSettings)
+         // Bug 1440 fix.
+         if (!kit.destfile.GetName().empty())
+            files.push_back({ channels, kit.destfile,
+               kit.t0, kit.t1, kit.filetags, {} });
+      return DoExportConcurrently(files, concurrency);
+   }
+
    auto ok = ProgressResult::Success;   // did it work?
    int count = 0; // count the number of successful runs
    ExportKit activeSetting;  // pointer to the settings in use for this export
@@ -1012,6 +1043,24 @@ ProgressResult ExportMultipleDialog::ExportMultipleByTrack(bool byName,
    }
    // end of user-interactive data gathering loop, start of export processing
    // loop
+   if (const auto concurrency = BeginConcurrentExport(); concurrency > 1) {
+      // Name the tracks of each file, instead of selecting them
+      std::vector<ConcurrentFile> files;
+      size_t iSetting = 0;
+      for (auto tr : mTracks->Leaders<WaveTrack>() -
+         (anySolo ? &WaveTrack::GetNotSolo : &WaveTrack::GetMute)) {
+         const auto &kit = exportSettings[iSetting++];
+         if (kit.destfile.GetName().empty())
+            continue;
+         SampleTrackConstArray tracks;
+         for (auto channel : TrackList::Channels(tr))
+            tracks.push_back(channel->SharedPointer<const SampleTrack>());
+         files.push_back({ kit.channels, kit.destfile,
+            kit.t0, kit.t1, kit.filetags, std::move(tracks) });
+      }
+      return DoExportConcurrently(files, concurrency);
+   }
+
    int count = 0; // count the number of successful runs
    ExportKit activeSetting;  // pointer to the settings in use for this export
    std::unique_ptr<ProgressDialog> pDialog;
@@ -1077,50 +1126,16 @@ ProgressResult ExportMultipleDialog::DoExport(std::unique_ptr<ProgressDialog> &p
       wxLogDebug(wxT("Whole Project"));
 
    wxFileName backup;
-   if (mOverwrite->GetValue()) {
-      name = inName;
-      backup.Assign(name);
-
-      int suffix = 0;
-      do {
-         backup.SetName(name.GetName() +
-                           wxString::Format(wxT("%d"), suffix));
-         ++suffix;
-      }
-      while (backup.FileExists());
-      ::wxRenameFile(inName.GetFullPath(), backup.GetFullPath());
-   }
-   else {
-      name = inName;
-      int i = 2;
-      wxString base(name.GetName());
-      while (name.FileExists()) {
-         name.SetName(wxString::Format(wxT("%s-%d"), base, i++));
-      }
-   }
+   name = PrepareDestination(inName, backup);
 
    ProgressResult success = ProgressResult::Cancelled;
    const wxString fullPath{name.GetFullPath()};
 
    auto cleanup = finally( [&] {
-      bool ok =
+      FinishDestination(
          success == ProgressResult::Stopped ||
-         success == ProgressResult::Success;
-      if (backup.IsOk()) {
-         if ( ok )
-            // Remove backup
-            ::wxRemoveFile(backup.GetFullPath());
-         else {
-            // Restore original
-            ::wxRemoveFile(fullPath);
-            ::wxRenameFile(backup.GetFullPath(), fullPath);
-         }
-      }
-      else {
-         if ( ! ok )
-            // Remove any new, and only partially written, file.
-            ::wxRemoveFile(fullPath);
-      }
+         success == ProgressResult::Success,
+         fullPath, backup);
    } );
 
    // Call the format export routine
@@ -1145,6 +1160,208 @@ ProgressResult ExportMultipleDialog::DoExport(std::unique_ptr<ProgressDialog> &p
    return success;
 }
 
+wxFileName ExportMultipleDialog::ChooseDestination(const wxFileName &inName,
+   bool overwrite, const std::vector<wxFileName> &reserved)
+{
+   const auto isReserved = [&](const wxFileName &name){
+      return std::any_of(reserved.begin(), reserved.end(),
+         [&](const wxFileName &other){ return other.SameAs(name); });
+   };
+
+   wxFileName name = inName;
+   int i = 2;
+   wxString base(name.GetName());
+   while (isReserved(name) || (!overwrite && name.FileExists())) {
+      name.SetName(wxString::Format(wxT("%s-%d"), base, i++));
+   }
+   return name;
+}
+
+wxFileName ExportMultipleDialog::PrepareDestination(
+   const wxFileName &inName, wxFileName &backup,
+   const std::vector<wxFileName> &reserved)
+{
+   const bool overwrite = mOverwrite->GetValue();
+   wxFileName name = ChooseDestination(inName, overwrite, reserved);
+   if (overwrite && name.FileExists()) {
+      backup.Assign(name);
+
+      int suffix = 0;
+      do {
+         backup.SetName(name.GetName() +
+                           wxString::Format(wxT("%d"), suffix));
+         ++suffix;
+      }
+      while (backup.FileExists());
+      ::wxRenameFile(name.GetFullPath(), backup.GetFullPath());
+   }
+   return name;
+}
+
+void ExportMultipleDialog::FinishDestination(
+   bool ok, const wxString &fullPath, const wxFileName &backup)
+{
+   if (backup.IsOk()) {
+      if ( ok )
+         // Remove backup
+         ::wxRemoveFile(backup.GetFullPath());
+      else {
+         // Restore original
+         ::wxRemoveFile(fullPath);
+         ::wxRenameFile(backup.GetFullPath(), fullPath);
+      }
+   }
+   else {
+      if ( ! ok )
+         // Remove any new, and only partially written, file.
+         ::wxRemoveFile(fullPath);
+   }
+}
+
+size_t ExportMultipleDialog::BeginConcurrentExport()
+{
+   const auto concurrency = std::min<size_t>(
+      std::max(1, ExportMultipleConcurrency.Read()),
+      ThreadPool::Get().GetNumThreads());
+   if (concurrency < 2 ||
+       !mPlugins[mPluginIndex]->BeginBackgroundExport(mSubFormatIndex))
+      return 1;
+   return concurrency;
+}
+
+ProgressResult ExportMultipleDialog::DoExportConcurrently(
+   std::vector<ConcurrentFile> &files, size_t concurrency)
+{
+   auto &plugin = *mPlugins[mPluginIndex];
+   auto endBackground = finally([&]{ plugin.EndBackgroundExport(); });
+
+   // Decide names, and move files to be overwritten, in this thread.
+   // No file exists yet to keep two of the same name apart, so remember them
+   std::vector<wxFileName> reserved;
+   for (auto &file : files) {
+      file.target = PrepareDestination(file.name, file.backup, reserved);
+      reserved.push_back(file.target);
+      wxLogDebug(wxT("Doing multiple Export: File name \"%s\""),
+         file.target.GetFullName());
+   }
+
+   ProgressResult ok;
+   {
+      ProgressDialog dialog(XO("Export Multiple"),
+         XO("Exporting %lld files").Format( (long long) files.size() ),
+         pdlgHideStopButton);
+      ok = ExportConcurrently(plugin, mProject, mSubFormatIndex,
+         files, concurrency,
+         [&](double done, const wxString &inProgress){
+            return dialog.Update(done, (double) files.size(),
+               Verbatim(inProgress));
+         },
+         mExported, mFailed);
+   }
+
+   Refresh();
+   Update();
+
+   return ok;
+}
+
+ProgressResult ExportMultipleDialog::ExportConcurrently(ExportPlugin &plugin,
+   TenacityProject *project, int subformat,
+   std::vector<ConcurrentFile> &files, size_t concurrency,
+   const ConcurrentProgress &progress,
+   FilePaths &exported, FilePaths &failed)
+{
+   struct Job {
+      ConcurrentFile *pFile{};
+      ExportPlugin::BackgroundExport state;
+      std::atomic<bool> started{ false };
+      std::atomic<bool> finished{ false };
+      ProgressResult result{ ProgressResult::Cancelled };
+   };
+   // Jobs don't move, so that workers may refer to them
+   std::vector<Job> jobs(files.size());
+   std::atomic<bool> cancelled{ false };
+   for (size_t ii = 0; ii < files.size(); ++ii) {
+      auto &job = jobs[ii];
+      job.pFile = &files[ii];
+      job.state.tracks = files[ii].tracks;
+      job.state.pCancelled = &cancelled;
+   }
+
+   // Each runner takes the next file until there are none
+   std::atomic<size_t> next{ 0 };
+   const auto run = [&]{
+      for (auto ii = next++; ii < jobs.size(); ii = next++) {
+         auto &job = jobs[ii];
+         auto &file = *job.pFile;
+         if (!cancelled) {
+            job.started = true;
+            ExportPlugin::BackgroundScope scope{ job.state };
+            job.result = GuardedCall<ProgressResult>([&]{
+               std::unique_ptr<ProgressDialog> pDialog;
+               return plugin.Export(project, pDialog, file.channels,
+                  file.target, !file.tracks.empty(), file.t0, file.t1,
+                  nullptr, &file.tags, subformat);
+            }, MakeSimpleGuard(ProgressResult::Failed));
+            // Plug-ins report most errors, then return Cancelled
+            if (job.state.failed && !cancelled)
+               job.result = ProgressResult::Failed;
+         }
+         job.finished = true;
+      }
+   };
+
+   auto &pool = ThreadPool::Get();
+   std::vector<std::future<void>> runners;
+   // Workers refer to the jobs until they finish
+   auto waitAll = finally([&]{
+      for (auto &runner : runners)
+         runner.wait();
+   });
+   for (size_t ii = 0, nn = std::min(concurrency, jobs.size()); ii < nn; ++ii)
+      runners.push_back(pool.Async(run));
+
+   for (auto &runner : runners) {
+      while (runner.wait_for(std::chrono::milliseconds(50)) !=
+             std::future_status::ready) {
+         // Show each file in progress
+         double done = 0;
+         wxString inProgress;
+         for (const auto &job : jobs) {
+            if (job.finished)
+               done += 1;
+            else if (job.started) {
+               const double fraction = job.state.done;
+               done += fraction;
+               inProgress += wxString::Format(wxT("%s (%d%%)\n"),
+                  job.pFile->target.GetFullName(), (int)(100 * fraction));
+            }
+         }
+         if (progress(done, inProgress.Trim()) != ProgressResult::Success)
+            cancelled = true;
+      }
+   }
+
+   // Report the outcomes in the order of the files
+   auto ok = ProgressResult::Success;
+   for (auto &job : jobs) {
+      const auto fullPath = job.pFile->target.GetFullPath();
+      const bool isExported = job.result == ProgressResult::Success;
+      FinishDestination(isExported, fullPath, job.pFile->backup);
+      if (isExported)
+         exported.push_back(fullPath);
+      else if (job.result == ProgressResult::Failed) {
+         failed.push_back(fullPath);
+         if (ok == ProgressResult::Success)
+            ok = ProgressResult::Failed;
+      }
+      else
+         ok = ProgressResult::Cancelled;
+   }
+
+   return ok;
+}
+
 wxString ExportMultipleDialog::MakeFileName(const wxString &input)
 {
    wxString newname = input; // name we are generating
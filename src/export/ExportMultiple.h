@@ -42,6 +42,52 @@ public:
 
    int ShowModal();
 
+   /** \brief Choose the name to write, without changing any files
+    *
+    * @param overwrite whether an existing file may be replaced
+    * @param reserved names chosen already for other files of the same
+    * export, which are avoided even if overwriting, though the files don't
+    * exist yet
+    * @return inName, or if it must be avoided, the first of inName-2,
+    * inName-3, ... that need not be */
+   static wxFileName ChooseDestination(const wxFileName &inName,
+      bool overwrite, const std::vector<wxFileName> &reserved = {});
+
+   //! One file of a concurrent export
+   struct ConcurrentFile
+   {
+      unsigned channels;
+      wxFileNameWrapper name;
+      double t0;
+      double t1;
+      Tags tags;
+      //! If not empty, mixed instead of all unmuted tracks
+      SampleTrackConstArray tracks;
+      //! Where it is written, and where an overwritten file was moved
+      wxFileNameWrapper target;
+      wxFileName backup;
+   };
+
+   //! Called in the main thread while files export, with how many are done,
+   //! counting fractions, and the names of those in progress; a result other
+   //! than Success cancels the rest
+   using ConcurrentProgress =
+      std::function<ProgressResult(double done, const wxString &inProgress)>;
+
+   /** \brief Export files to their targets on worker threads, at most
+    * concurrency of them at once, with a plug-in that BeginBackgroundExport()
+    * prepared
+    *
+    * Finishes each destination, and adds its path to exported or failed.  A
+    * file fails if it reported an error, unless the export was cancelled.
+    * @return Cancelled if the export was cancelled, or else Failed if any
+    * failed, or else Success */
+   static ProgressResult ExportConcurrently(ExportPlugin &plugin,
+      TenacityProject *project, int subformat,
+      std::vector<ConcurrentFile> &files, size_t concurrency,
+      const ConcurrentProgress &progress,
+      FilePaths &exported, FilePaths &failed);
+
 private:
 
    // Export
@@ -83,6 +129,29 @@ private:
                  double t0,
                  double t1,
                  const Tags &tags);
+
+   /** \brief Prepare the selected plug-in to export on worker threads
+    *
+    * @return how many files to export at once; if more than one, then
+    * DoExportConcurrently() must follow */
+   size_t BeginConcurrentExport();
+
+   /** Export files on worker threads, at most concurrency of them at once,
+    * reporting progress and failures of all of them in this thread */
+   ProgressResult DoExportConcurrently(
+      std::vector<ConcurrentFile> &files, size_t concurrency);
+
+   /** \brief Choose the name to write, and if overwriting, move the existing
+    * file to a backup name, which is then assigned to backup
+    *
+    * @param reserved as for ChooseDestination() */
+   wxFileName PrepareDestination(const wxFileName &inName, wxFileName &backup,
+      const std::vector<wxFileName> &reserved = {});
+
+   /** \brief Remove the backup after success, or else restore it, or remove
+    * the partially written file */
+   static void FinishDestination(
+      bool ok, const wxString &fullPath, const wxFileName &backup);
    /** \brief Takes an arbitrary text string and converts it to a form that can
     * be used as a file name, if necessary prompting the user to edit the file
     * name produced */
@@ -129,6 +198,8 @@ private:
 
    // List of file actually exported
    FilePaths mExported;
+   // List of files that failed to export concurrently with others
+   FilePaths mFailed;
 
    wxChoice      *mFormat;    /**< Drop-down list of export formats
                                 (combinations of plug-in and subformat) */
@@ -20,6 +20,8 @@
 #include <wx/textctrl.h>
 #include <wx/window.h>
 
+#include <unordered_map>
+
 #include "sndfile.h"
 
 // Tenacity libraries
@@ -404,13 +406,20 @@ public:
    FileExtension GetExtension(int index) override;
    unsigned GetMaxChannels(int index) override;
 
+   bool BeginBackgroundExport(int subformat) override;
+   void EndBackgroundExport() override;
+
 private:
+   int GetSFFormat(int subformat);
    void ReportTooBigError(wxWindow * pParent);
    ArrayOf<char> AdjustString(const wxString & wxStr, int sf_format);
    bool AddStrings(TenacityProject *project, SNDFILE *sf, const Tags *tags, int sf_format);
    bool AddID3Chunk(
       const wxFileNameWrapper &fName, const Tags *tags, int sf_format);
 
+   //! Formats from preferences, read in the main thread, for background
+   //! exports, by subformat
+   std::unordered_map<int, int> mBackgroundFormats;
 };
 
 ExportPCM::ExportPCM()
@@ -460,25 +469,8 @@ void ExportPCM::ReportTooBigError(wxWindow * pParent)
 #endif
 }
 
-/**
- *
- * @param subformat Control whether we are doing a "preset" export to a popular
- * file type, or giving the user full control over libsndfile.
- */
-ProgressResult ExportPCM::Export(TenacityProject *project,
-                                 std::unique_ptr<ProgressDialog> &pDialog,
-                                 unsigned numChannels,
-                                 const wxFileNameWrapper &fName,
-                                 bool selectionOnly,
-                                 double t0,
-                                 double t1,
-                                 MixerSpec *mixerSpec,
-                                 const Tags *metadata,
-                                 int subformat)
+int ExportPCM::GetSFFormat(int subformat)
 {
-   double rate = ProjectRate::Get( *project ).GetRate();
-   const auto &tracks = TrackList::Get( *project );
-
    // Set a default in case the settings aren't found
    int sf_format;
 
@@ -513,6 +505,46 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
       sf_format |= SF_FORMAT_PCM_16;
    }
 
+   return sf_format;
+}
+
+bool ExportPCM::BeginBackgroundExport(int subformat)
+{
+   mBackgroundFormats[subformat] = GetSFFormat(subformat);
+   mBackgroundMixerPreferences.emplace();
+   return true;
+}
+
+void ExportPCM::EndBackgroundExport()
+{
+   mBackgroundFormats.clear();
+   mBackgroundMixerPreferences.reset();
+}
+
+/**
+ *
+ * @param subformat Control whether we are doing a "preset" export to a popular
+ * file type, or giving the user full control over libsndfile.
+ */
+ProgressResult ExportPCM::Export(TenacityProject *project,
+                                 std::unique_ptr<ProgressDialog> &pDialog,
+                                 unsigned numChannels,
+                                 const wxFileNameWrapper &fName,
+                                 bool selectionOnly,
+                                 double t0,
+                                 double t1,
+                                 MixerSpec *mixerSpec,
+                                 const Tags *metadata,
+                                 int subformat)
+{
+   double rate = ProjectRate::Get( *project ).GetRate();
+   const auto &tracks = TrackList::Get( *project );
+
+   const auto pBackground = GetBackgroundExport();
+   const int sf_format = pBackground
+      ? mBackgroundFormats.at(subformat)
+      : GetSFFormat(subformat);
+
    int fileFormat = sf_format & SF_FORMAT_TYPEMASK;
    
    auto updateResult = ProgressResult::Success;
@@ -541,13 +573,13 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
       // Bug 46.  Trap here, as sndfile.c does not trap it properly.
       if( (numChannels != 1) && ((sf_format & SF_FORMAT_SUBMASK) == SF_FORMAT_GSM610) )
       {
-         AudacityMessageBox( XO("GSM 6.10 requires mono") );
+         ReportError([]{ AudacityMessageBox( XO("GSM 6.10 requires mono") ); });
          return ProgressResult::Cancelled;
       }
 
       if (sf_format == SF_FORMAT_WAVEX + SF_FORMAT_GSM610) {
-         AudacityMessageBox(
-            XO("WAVEX and GSM 6.10 formats are not compatible") );
+         ReportError([]{ AudacityMessageBox(
+            XO("WAVEX and GSM 6.10 formats are not compatible") ); });
          return ProgressResult::Cancelled;
       }
 
@@ -560,7 +592,8 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
       if (!sf_format_check(&info))
          info.format = (info.format & SF_FORMAT_TYPEMASK);
       if (!sf_format_check(&info)) {
-         AudacityMessageBox( XO("Cannot export audio in this format.") );
+         ReportError([]{
+            AudacityMessageBox( XO("Cannot export audio in this format.") ); });
          return ProgressResult::Cancelled;
       }
       const auto path = fName.GetFullPath();
@@ -574,7 +607,8 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
       }
 
       if (!sf) {
-         AudacityMessageBox( XO("Cannot export audio to %s").Format( path ) );
+         ReportError([path]{
+            AudacityMessageBox( XO("Cannot export audio to %s").Format( path ) ); });
          return ProgressResult::Cancelled;
       }
       // Retrieve tags if not given a set
@@ -608,7 +642,7 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
          // Test for 4 Gibibytes, rather than 4 Gigabytes
          if( byteCount > 4.295e9)
          {
-            ReportTooBigError( wxTheApp->GetTopWindow() );
+            ReportError([this]{ ReportTooBigError( wxTheApp->GetTopWindow() ); });
             return ProgressResult::Failed;
          }
       }
@@ -631,7 +665,6 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
                ? XO("Exporting the selected audio as %s")
                : XO("Exporting the audio as %s"))
                .Format( formatStr ) );
-         auto &progress = *pDialog;
 
          while (updateResult == ProgressResult::Success) {
             sf_count_t samplesWritten;
@@ -689,7 +722,8 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
                break;
             }
             
-            updateResult = progress.Update(mixer->MixGetCurrentTime() - t0, t1 - t0);
+            updateResult = UpdateProgress(pDialog.get(),
+               mixer->MixGetCurrentTime() - t0, t1 - t0);
          }
       }
       
@@ -700,13 +734,13 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
              fileFormat == SF_FORMAT_WAVEX) {
             if (!AddStrings(project, sf.get(), metadata, sf_format)) {
                // TODO: more precise message
-               ShowExportErrorDialog("PCM:675");
+               ReportError([]{ ShowExportErrorDialog("PCM:675"); });
                return ProgressResult::Cancelled;
             }
          }
          if (0 != sf.close()) {
             // TODO: more precise message
-            ShowExportErrorDialog("PCM:681");
+            ReportError([]{ ShowExportErrorDialog("PCM:681"); });
             return ProgressResult::Cancelled;
          }
       }
@@ -719,7 +753,7 @@ ProgressResult ExportPCM::Export(TenacityProject *project,
          // Note: file has closed, and gets reopened and closed again here:
          if (!AddID3Chunk(fName, metadata, sf_format) ) {
             // TODO: more precise message
-            ShowExportErrorDialog("PCM:694");
+            ReportError([]{ ShowExportErrorDialog("PCM:694"); });
             return ProgressResult::Cancelled;
          }
 
@@ -12,6 +12,8 @@
 #include "ExportPlugin.h"
 #include "Export.h"
 
+#include <algorithm>
+
 // Tenacity libraries
 #include <lib-files/wxFileNameWrapper.h>
 #include <lib-track/Track.h>
@@ -175,18 +177,28 @@ std::unique_ptr<Mixer> ExportPlugin::CreateMixer(const TrackList &tracks,
 {
     SampleTrackConstArray inputTracks;
 
-    bool anySolo = !(( tracks.Any<const WaveTrack>() + &WaveTrack::GetSolo ).empty());
+    const auto pBackground = GetBackgroundExport();
+    if (pBackground && !pBackground->tracks.empty())
+        inputTracks = pBackground->tracks;
+    else {
+        bool anySolo = !(( tracks.Any<const WaveTrack>() + &WaveTrack::GetSolo ).empty());
 
-    auto range = tracks.Any< const WaveTrack >()
-        + (selectionOnly ? &Track::IsSelected : &Track::Any )
-        - ( anySolo ? &WaveTrack::GetNotSolo : &WaveTrack::GetMute);
-    for (auto pTrack: range)
-    {
-        inputTracks.push_back(
-            pTrack->SharedPointer< const SampleTrack >()
-        );
+        auto range = tracks.Any< const WaveTrack >()
+            + (selectionOnly ? &Track::IsSelected : &Track::Any )
+            - ( anySolo ? &WaveTrack::GetNotSolo : &WaveTrack::GetMute);
+        for (auto pTrack: range)
+        {
+            inputTracks.push_back(
+                pTrack->SharedPointer< const SampleTrack >()
+            );
+        }
     }
 
+    // Worker threads can't read preferences
+    wxASSERT(!pBackground || mBackgroundMixerPreferences);
+    const auto pPreferences = pBackground && mBackgroundMixerPreferences
+        ? &*mBackgroundMixerPreferences : nullptr;
+
     // MB: the stop time should not be warped, this was a bug.
     return std::make_unique<Mixer>(
         inputTracks,
@@ -196,13 +208,16 @@ std::unique_ptr<Mixer> ExportPlugin::CreateMixer(const TrackList &tracks,
         startTime, stopTime,
         numOutChannels, outBufferSize, outInterleaved,
         outRate, outFormat,
-        true, mixerSpec
+        true, mixerSpec, true, pPreferences
     );
 }
 
 void ExportPlugin::InitProgress(std::unique_ptr<ProgressDialog> &pDialog,
    const TranslatableString &title, const TranslatableString &message)
 {
+    if (GetBackgroundExport())
+        return;
+
     if (!pDialog)
     {
         pDialog = std::make_unique<ProgressDialog>( title, message );
@@ -220,4 +235,56 @@ void ExportPlugin::InitProgress(std::unique_ptr<ProgressDialog> &pDialog,
     return InitProgress(
         pDialog, Verbatim( title.GetName() ), message
     );
-}
\ No newline at end of file
+}
+
+namespace {
+thread_local ExportPlugin::BackgroundExport *spBackgroundExport = nullptr;
+}
+
+ExportPlugin::BackgroundScope::BackgroundScope(BackgroundExport &state)
+    : mpPrevious{ spBackgroundExport }
+{
+    spBackgroundExport = &state;
+}
+
+ExportPlugin::BackgroundScope::~BackgroundScope()
+{
+    spBackgroundExport = mpPrevious;
+}
+
+bool ExportPlugin::BeginBackgroundExport(int /* subformat */)
+{
+    return false;
+}
+
+void ExportPlugin::EndBackgroundExport()
+{
+}
+
+auto ExportPlugin::GetBackgroundExport() -> BackgroundExport *
+{
+    return spBackgroundExport;
+}
+
+auto ExportPlugin::UpdateProgress(ProgressDialog *pDialog,
+    double current, double total) -> ProgressResult
+{
+    if (const auto pBackground = GetBackgroundExport()) {
+        if (total > 0)
+            pBackground->done = std::min(1.0, current / total);
+        return (pBackground->pCancelled && *pBackground->pCancelled)
+            ? ProgressResult::Cancelled
+            : ProgressResult::Success;
+    }
+    return pDialog->Update(current, total);
+}
+
+void ExportPlugin::ReportError(std::function<void()> show)
+{
+    if (const auto pBackground = GetBackgroundExport()) {
+        pBackground->failed = true;
+        GenericUI::CallAfter(std::move(show));
+    }
+    else
+        show();
+}
@@ -11,7 +11,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 
 class wxFileName;
@@ -118,7 +121,52 @@ class TENACITY_DLL_API ExportPlugin /* not final */
                                       const Tags *metadata = NULL,
                                       int subformat = 0) = 0;
 
+        //! Progress and outcome of one file exported on a worker thread
+        struct BackgroundExport
+        {
+            //! If not empty, these are mixed instead of the selected tracks
+            SampleTrackConstArray tracks;
+            //! Fraction of the file written
+            std::atomic<double> done{ 0.0 };
+            //! Shared by a batch of exports; when set, they return Cancelled
+            const std::atomic<bool> *pCancelled{ nullptr };
+            //! Set when an error was reported, to be shown in the main thread
+            std::atomic<bool> failed{ false };
+        };
+
+        //! While it exists, Export() on this thread reports to the given state
+        class TENACITY_DLL_API BackgroundScope
+        {
+        public:
+            explicit BackgroundScope(BackgroundExport &state);
+            ~BackgroundScope();
+        private:
+            BackgroundExport *mpPrevious;
+        };
+
+        /** \brief Whether Export() may run on worker threads for a sub-format
+        *
+        * Called in the main thread before a batch of exports.  The plug-in may
+        * read its preferences now, for use until EndBackgroundExport(), because
+        * they can't be read from other threads.  That includes those of the
+        * mixer, in mBackgroundMixerPreferences, if it uses CreateMixer().
+        */
+        virtual bool BeginBackgroundExport(int subformat);
+        virtual void EndBackgroundExport();
+
     protected:
+        //! @return null except while exporting in the background
+        static BackgroundExport *GetBackgroundExport();
+
+        //! Update the dialog, or else the progress of a background export
+        static ProgressResult UpdateProgress(ProgressDialog *pDialog,
+                double current, double total);
+
+        //! Show an error now, or for a background export, fail it and show
+        //! the error later in the main thread
+        static void ReportError(std::function<void()> show);
+
+        //! For a background export, uses mBackgroundMixerPreferences
         std::unique_ptr<Mixer> CreateMixer(const TrackList &tracks,
                 bool selectionOnly,
                 double startTime, double stopTime,
@@ -126,7 +174,11 @@ class TENACITY_DLL_API ExportPlugin /* not final */
                 double outRate, sampleFormat outFormat,
                 MixerSpec *mixerSpec);
 
-    // Create or recycle a dialog.
+        //! Read by BeginBackgroundExport() of plug-ins that use CreateMixer(),
+        //! and reset by EndBackgroundExport()
+        std::optional<Mixer::Preferences> mBackgroundMixerPreferences;
+
+    // Create or recycle a dialog.  There is none for a background export.
     static void InitProgress(std::unique_ptr<ProgressDialog> &pDialog,
             const TranslatableString &title, const TranslatableString &message);
     static void InitProgress(std::unique_ptr<ProgressDialog> &pDialog,
@@ -452,45 +452,10 @@ std::unique_ptr<ExtImportItem> Importer::CreateDefaultImportItem()
 }
 
 // returns number of tracks imported
-bool Importer::Import( TenacityProject &project,
-                     const FilePath &fName,
-                     WaveTrackFactory *trackFactory,
-                     TrackHolders &tracks,
-                     Tags *tags,
-                     LabelHolders &labels,
-                     TranslatableString &errorMessage)
+std::vector< ImportPlugin* > Importer::OrderPlugins(
+   const FilePath &fName, const FileExtension &extension) const
 {
-   TenacityProject *pProj = &project;
-   auto cleanup = valueRestorer( pProj->mbBusyImporting, true );
-
-   const FileExtension extension{ fName.AfterLast(wxT('.')) };
-
-   // Always refuse to import MIDI, even though the FFmpeg plugin pretends to know how (but makes very bad renderings)
-#ifdef USE_MIDI
-   // MIDI files must be imported, not opened
-   if (FileNames::IsMidi(fName)) {
-      errorMessage = XO(
-"\"%s\" \nis a MIDI file, not an audio file. \nTenacity cannot open this type of file for playing, but you can\nedit it by clicking File > Import > MIDI.")
-         .Format( fName );
-      return false;
-   }
-#endif
-
-   // Bug #2647: Peter has a Word 2000 .doc file that is recognized and imported by FFmpeg.
-   if (wxFileName(fName).GetExt() == wxT("doc")) {
-      errorMessage =
-         XO("\"%s\" \nis a not an audio file. \nTenacity cannot open this type of file.")
-         .Format( fName );
-      return false;
-   }
-
-   using ImportPluginPtrs = std::vector< ImportPlugin* >;
-
-   // This list is used to call plugins in correct order
-   ImportPluginPtrs importPlugins;
-
-   // This list is used to remember plugins that should have been compatible with the file.
-   ImportPluginPtrs compatiblePlugins;
+   std::vector< ImportPlugin* > importPlugins;
 
    // Not implemented (yet?)
    wxString mime_type = wxT("*");
@@ -603,6 +568,70 @@ bool Importer::Import( TenacityProject &project,
       }
    }
 
+   return importPlugins;
+}
+
+std::unique_ptr<ImportFileHandle> Importer::OpenForBackground(
+   TenacityProject &project, const FilePath &fName) const
+{
+   const FileExtension extension{ fName.AfterLast(wxT('.')) };
+
+   // Take the first plugin that would be used by Import(), and only if it
+   // needs no questions
+   for (const auto plugin : OrderPlugins(fName, extension))
+   {
+      wxLogMessage(wxT("Opening with %s"),plugin->GetPluginStringID());
+      auto inFile = plugin->Open(fName, &project);
+      if ( (inFile != NULL) && (inFile->GetStreamCount() > 0) )
+      {
+         if (inFile->GetStreamCount() > 1 ||
+             !inFile->SupportsBackgroundImport())
+            return {};
+         inFile->SetStreamUsage(0,TRUE);
+         return inFile;
+      }
+   }
+   return {};
+}
+
+bool Importer::Import( TenacityProject &project,
+                     const FilePath &fName,
+                     WaveTrackFactory *trackFactory,
+                     TrackHolders &tracks,
+                     Tags *tags,
+                     LabelHolders &labels,
+                     TranslatableString &errorMessage)
+{
+   TenacityProject *pProj = &project;
+   auto cleanup = valueRestorer( pProj->mbBusyImporting, true );
+
+   const FileExtension extension{ fName.AfterLast(wxT('.')) };
+
+   // Always refuse to import MIDI, even though the FFmpeg plugin pretends to know how (but makes very bad renderings)
+#ifdef USE_MIDI
+   // MIDI files must be imported, not opened
+   if (FileNames::IsMidi(fName)) {
+      errorMessage = XO(
+"\"%s\" \nis a MIDI file, not an audio file. \nTenacity cannot open this type of file for playing, but you can\nedit it by clicking File > Import > MIDI.")
+         .Format( fName );
+      return false;
+   }
+#endif
+
+   // Bug #2647: Peter has a Word 2000 .doc file that is recognized and imported by FFmpeg.
+   if (wxFileName(fName).GetExt() == wxT("doc")) {
+      errorMessage =
+         XO("\"%s\" \nis a not an audio file. \nTenacity cannot open this type of file.")
+         .Format( fName );
+      return false;
+   }
+
+   // This list is used to call plugins in correct order
+   auto importPlugins = OrderPlugins(fName, extension);
+
+   // This list is used to remember plugins that should have been compatible with the file.
+   std::vector< ImportPlugin* > compatiblePlugins;
+
    // Try the import plugins, in the permuted sequences just determined
    for (const auto plugin : importPlugins)
    {
@@ -180,7 +180,19 @@ public:
               LabelHolders &labelTracks,
               TranslatableString &errorMessage);
 
+   //! Open a file, as Import() would, for import in the background
+   /*!
+    @return null unless the file has one stream, and the plugin that Import()
+    would use first supports background import; then Import() should be used
+    instead
+    */
+   std::unique_ptr<ImportFileHandle> OpenForBackground(
+      TenacityProject &project, const FilePath &fName) const;
+
 private:
+   std::vector< ImportPlugin* > OrderPlugins(
+      const FilePath &fName, const FileExtension &extension) const;
+
    static Importer mInstance;
 
    ExtImportItems mExtImportItems;
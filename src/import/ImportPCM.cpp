@@ -46,6 +46,7 @@
 
 // Tenacity libraries
 #include <lib-preferences/Prefs.h>
+#include <lib-utility/ThreadPool.h>
 
 #include "../FileFormats.h"
 #include "../shuttle/ShuttleGui.h"
@@ -85,6 +86,8 @@ public:
 };
 
 
+using NewChannelGroup = std::vector< std::shared_ptr<WaveTrack> >;
+
 class PCMImportFileHandle final : public ImportFileHandle
 {
 public:
@@ -107,10 +110,17 @@ public:
    void SetStreamUsage(wxInt32 /* StreamID */, bool /* Use */) override
    {}
 
+   bool SupportsBackgroundImport() const override { return true; }
+   void PrepareBackgroundImport(
+      WaveTrackFactory *trackFactory, BackgroundProgress &progress) override;
+
 private:
+   void MakeChannels(WaveTrackFactory &trackFactory);
+
    SFFile                mFile;
    const SF_INFO         mInfo;
    sampleFormat          mFormat;
+   NewChannelGroup       mChannels;
 };
 
 TranslatableString PCMImportPlugin::GetPluginFormatDescription()
@@ -285,7 +295,28 @@ struct id3_tag_deleter {
 using id3_tag_holder = std::unique_ptr<id3_tag, id3_tag_deleter>;
 #endif
 
-using NewChannelGroup = std::vector< std::shared_ptr<WaveTrack> >;
+void PCMImportFileHandle::MakeChannels(WaveTrackFactory &trackFactory)
+{
+   if (!mChannels.empty())
+      return;
+
+   NewChannelGroup channels(mInfo.channels);
+   for (auto &channel : channels) {
+      channel = NewWaveTrack(trackFactory, mFormat, mInfo.samplerate);
+      // Make the clip now too, so that appending never needs to
+      channel->RightmostOrNewClip();
+   }
+   mChannels = std::move(channels);
+}
+
+void PCMImportFileHandle::PrepareBackgroundImport(
+   WaveTrackFactory *trackFactory, BackgroundProgress &progress)
+{
+   ImportFileHandle::PrepareBackgroundImport(trackFactory, progress);
+   if (mInfo.channels > 0)
+      MakeChannels(*trackFactory);
+   UpdateProgress(0, mInfo.frames);
+}
 
 ProgressResult PCMImportFileHandle::Import(WaveTrackFactory *trackFactory,
                                 TrackHolders &outTracks,
@@ -298,29 +329,29 @@ ProgressResult PCMImportFileHandle::Import(WaveTrackFactory *trackFactory,
 
    CreateProgress();
 
-   NewChannelGroup channels(mInfo.channels);
+   // PRL:  guard against excessive memory buffer allocation in case of many channels
+   if (mInfo.channels < 1)
+      return ProgressResult::Failed;
 
-   {
-      // iter not used outside this scope.
-      auto iter = channels.begin();
-      for (int c = 0; c < mInfo.channels; ++iter, ++c)
-         *iter = NewWaveTrack(*trackFactory, mFormat, mInfo.samplerate);
-   }
+   MakeChannels(*trackFactory);
+   // The caller owns the tracks from now on, even if this fails, so that
+   // they are destroyed where it chooses
+   outTracks.push_back(std::move(mChannels));
+   mChannels.clear();
+   const auto &channels = outTracks.back();
 
    auto fileTotalFrames =
       (sampleCount)mInfo.frames; // convert from sf_count_t
    auto maxBlockSize = channels.begin()->get()->GetMaxBlockSize();
    auto updateResult = ProgressResult::Cancelled;
+   auto &pool = ThreadPool::Get();
 
    {
       // Otherwise, we're in the "copy" mode, where we read in the actual
       // samples from the file and store our own local copy of the
       // samples in the tracks.
 
-      // PRL:  guard against excessive memory buffer allocation in case of many channels
       using type = decltype(maxBlockSize);
-      if (mInfo.channels < 1)
-         return ProgressResult::Failed;
       auto maxBlock = std::min(maxBlockSize,
          std::numeric_limits<type>::max() /
             (mInfo.channels * SAMPLE_SIZE(mFormat))
@@ -328,59 +359,70 @@ ProgressResult PCMImportFileHandle::Import(WaveTrackFactory *trackFactory,
       if (maxBlock < 1)
          return ProgressResult::Failed;
 
-      SampleBuffer srcbuffer, buffer;
-      wxASSERT(mInfo.channels >= 0);
-      while (NULL == srcbuffer.Allocate(maxBlock * mInfo.channels, mFormat).ptr() ||
-             NULL == buffer.Allocate(maxBlock, mFormat).ptr())
+      // Two stages overlap:  one thread decodes into one buffer, while
+      // others deinterleave the other into the channels, making the
+      // blocks, their summaries and their rows in the database.  The
+      // calling thread takes part, so this can't starve even when called
+      // from a worker.
+      SampleBuffer srcbuffers[2];
+      while (NULL == srcbuffers[0].Allocate(maxBlock * mInfo.channels, mFormat).ptr() ||
+             NULL == srcbuffers[1].Allocate(maxBlock * mInfo.channels, mFormat).ptr())
       {
          maxBlock /= 2;
          if (maxBlock < 1)
             return ProgressResult::Failed;
       }
 
-      decltype(fileTotalFrames) framescompleted = 0;
-
-      long block;
-      do {
-         block = maxBlock;
+      const auto read = [&](samplePtr srcbuffer) -> long {
+         long block = maxBlock;
 
          if (mFormat == int16Sample)
-            block = SFCall<sf_count_t>(sf_readf_short, mFile.get(), (short *)srcbuffer.ptr(), block);
+            block = SFCall<sf_count_t>(sf_readf_short, mFile.get(), (short *)srcbuffer, block);
          //import 24 bit int as float and have the append function convert it.  This is how PCMAliasBlockFile worked too.
          else
-            block = SFCall<sf_count_t>(sf_readf_float, mFile.get(), (float *)srcbuffer.ptr(), block);
+            block = SFCall<sf_count_t>(sf_readf_float, mFile.get(), (float *)srcbuffer, block);
 
          if(block < 0 || block > (long)maxBlock) {
             wxASSERT(false);
             block = maxBlock;
          }
+         return block;
+      };
 
-         if (block) {
-            auto iter = channels.begin();
-            for(int c=0; c<mInfo.channels; ++iter, ++c) {
-               if (mFormat==int16Sample) {
-                  for(int j=0; j<block; j++)
-                     ((short *)buffer.ptr())[j] =
-                        ((short *)srcbuffer.ptr())[mInfo.channels*j+c];
-               }
-               else {
-                  for(int j=0; j<block; j++)
-                     ((float *)buffer.ptr())[j] =
-                        ((float *)srcbuffer.ptr())[mInfo.channels*j+c];
-               }
+      const auto format = (mFormat == int16Sample) ? int16Sample : floatSample;
+      const auto nChannels = mInfo.channels;
 
-               iter->get()->Append(buffer.ptr(), (mFormat == int16Sample)?int16Sample:floatSample, block);
-            }
+      decltype(fileTotalFrames) framescompleted = 0;
+
+      int current = 0;
+      long block = read(srcbuffers[current].ptr());
+      do {
+         long next = 0;
+         if (block) {
+            const auto srcbuffer = srcbuffers[current].ptr();
+            const auto nextbuffer = srcbuffers[1 - current].ptr();
+            // Item 0 decodes ahead; the rest append one channel each, the
+            // stride deinterleaving and converting
+            pool.ParallelFor(nChannels + 1, [&](size_t ii){
+               if (ii == 0)
+                  next = read(nextbuffer);
+               else
+                  channels[ii - 1]->Append(
+                     srcbuffer + (ii - 1) * SAMPLE_SIZE(format),
+                     format, block, nChannels);
+            });
+            current = 1 - current;
             framescompleted += block;
          }
 
-         updateResult = mProgress->Update(
+         updateResult = UpdateProgress(
             framescompleted.as_long_long(),
             fileTotalFrames.as_long_long()
          );
          if (updateResult != ProgressResult::Success)
             break;
 
+         block = next;
       } while (block > 0);
    }
 
@@ -388,11 +430,8 @@ ProgressResult PCMImportFileHandle::Import(WaveTrackFactory *trackFactory,
       return updateResult;
    }
 
-   for(const auto &channel : channels)
-      channel->Flush();
-
-   if (!channels.empty())
-      outTracks.push_back(std::move(channels));
+   pool.ParallelFor(channels.size(),
+      [&](size_t c){ channels[c]->Flush(); });
 
    const char *str;
 
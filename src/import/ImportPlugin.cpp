@@ -44,6 +44,9 @@ ImportFileHandle::~ImportFileHandle()
 
 void ImportFileHandle::CreateProgress()
 {
+   if (mpBackgroundProgress)
+      return;
+
    wxFileName ff( mFilename );
 
    auto title = XO("Importing %s").Format( GetFileDescription() );
@@ -51,6 +54,34 @@ void ImportFileHandle::CreateProgress()
       title, Verbatim( ff.GetFullName() ) );
 }
 
+bool ImportFileHandle::SupportsBackgroundImport() const
+{
+   return false;
+}
+
+void ImportFileHandle::PrepareBackgroundImport(
+   WaveTrackFactory *, BackgroundProgress &progress)
+{
+   mpBackgroundProgress = &progress;
+}
+
+auto ImportFileHandle::UpdateProgress(long long done, long long total)
+   -> ProgressResult
+{
+   if (!mpBackgroundProgress)
+      return mProgress->Update(done, total);
+
+   // Add only the changes since the last report to the sums
+   auto &progress = *mpBackgroundProgress;
+   progress.total += total - mReportedTotal;
+   progress.done += done - mReportedDone;
+   mReportedTotal = total;
+   mReportedDone = done;
+   return progress.cancelled
+      ? ProgressResult::Cancelled
+      : ProgressResult::Success;
+}
+
 sampleFormat ImportFileHandle::ChooseFormat(sampleFormat effectiveFormat)
 {
    // Consult user preference
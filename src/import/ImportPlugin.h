@@ -45,6 +45,7 @@ but little else.
 #ifndef __AUDACITY_IMPORTER__
 #define __AUDACITY_IMPORTER__
 
+#include <atomic>
 #include <memory>
 
 // Tenacity libraries
@@ -117,8 +118,31 @@ public:
 
    // The importer should call this to create the progress dialog and
    // identify the filename being imported.
+   // It does nothing when importing in the background.
    void CreateProgress();
 
+   //! Progress of imports on worker threads, summed over their files, for
+   //! the thread that started them to show
+   struct BackgroundProgress
+   {
+      std::atomic<long long> done{ 0 };
+      std::atomic<long long> total{ 0 };
+      //! Set to make the imports return Cancelled at their next report
+      std::atomic<bool> cancelled{ false };
+   };
+
+   //! Whether Import() may run on a worker thread, after
+   //! PrepareBackgroundImport()
+   virtual bool SupportsBackgroundImport() const;
+
+   //! Call on the main thread, before Import() on a worker thread
+   /*!
+    Importers overriding this should make their tracks here, because
+    construction of tracks consults preferences
+    */
+   virtual void PrepareBackgroundImport(
+      WaveTrackFactory *trackFactory, BackgroundProgress &progress);
+
    // This is similar to GetPluginFormatDescription, but if possible the
    // importer will return a more specific description of the
    // specific file that is open.
@@ -158,8 +182,16 @@ protected:
    std::shared_ptr<WaveTrack> NewWaveTrack( WaveTrackFactory &trackFactory,
       sampleFormat effectiveFormat, double rate);
 
+   //! Report progress to the dialog, or to the background progress
+   ProgressResult UpdateProgress(long long done, long long total);
+
    FilePath mFilename;
    std::unique_ptr<ProgressDialog> mProgress;
+
+private:
+   BackgroundProgress *mpBackgroundProgress{ nullptr };
+   long long mReportedDone{ 0 };
+   long long mReportedTotal{ 0 };
 };
 
 
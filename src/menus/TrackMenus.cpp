@@ -651,7 +651,7 @@ void OnResample(const CommandContext &context)
 
    int ndx = 0;
    auto flags = UndoPush::NONE;
-   for (auto wt : tracks.Selected< WaveTrack >())
+   for (auto wt : tracks.SelectedLeaders< WaveTrack >())
    {
       auto msg = XO("Resampling track %d").Format( ++ndx );
 
@@ -663,7 +663,11 @@ void OnResample(const CommandContext &context)
       // But the thrown exception will cause rollback in the application
       // level handler.
 
-       wt->Resample(newRate, progress.get());
+      // The channels are resampled together, in one pass.
+      std::vector<WaveTrack*> channels;
+      for (auto channel : TrackList::Channels(wt))
+         channels.push_back(channel);
+      WaveTrack::Resample(channels, newRate, progress.get());
 
       // Each time a track is successfully, completely resampled,
       // commit that to the undo stack.  The second and later times,
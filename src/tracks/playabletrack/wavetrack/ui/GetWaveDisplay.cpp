@@ -12,53 +12,24 @@
 
 #include <algorithm>
 #include <cmath>
-#include <float.h>
 #include <wx/debug.h>
 #include "SampleBlock.h"
 #include "SampleCount.h"
 #include "Sequence.h"
 
-namespace {
+// Tenacity libraries
+#include <lib-math/SampleSummary.h>
 
-struct MinMaxSumsq
+namespace {
+//! Summarize samples, or triples of summaries, as the divisor says
+MinMaxSumsq Summarize(const float *pv, int count, int divisor)
 {
-   MinMaxSumsq(const float *pv, int count, int divisor)
-   {
-      min = FLT_MAX, max = -FLT_MAX, sumsq = 0.0f;
-      while (count--) {
-         float v;
-         switch (divisor) {
-         default:
-         case 1:
-            // array holds samples
-            v = *pv++;
-            if (v < min)
-               min = v;
-            if (v > max)
-               max = v;
-            sumsq += v * v;
-            break;
-         case 256:
-         case 65536:
-            // array holds triples of min, max, and rms values
-            v = *pv++;
-            if (v < min)
-               min = v;
-            v = *pv++;
-            if (v > max)
-               max = v;
-            v = *pv++;
-            sumsq += v * v;
-            break;
-         }
-      }
-   }
-
-   float min;
-   float max;
-   float sumsq;
-};
-
+   if (count <= 0)
+      return {};
+   return divisor == 1
+      ? SummarizeSamples(pv, count)
+      : SummarizeTriples(pv, count);
+}
 }
 
 bool GetWaveDisplay(const Sequence &sequence,
@@ -83,8 +54,8 @@ bool GetWaveDisplay(const Sequence &sequence,
 
    auto srcX = s0;
    decltype(srcX) nextSrcX = 0;
-   int lastRmsDenom = 0;
-   int lastDivisor = 0;
+   // How many samples the last assigned column summarizes so far
+   double lastNumSamples = 0;
    auto whereNow = std::min(s1 - 1, where[0]);
    decltype(whereNow) whereNext = 0;
    // Loop over block files, opening and reading and closing each
@@ -92,6 +63,26 @@ bool GetWaveDisplay(const Sequence &sequence,
    const auto &blocks = sequence.GetBlockArray();
    unsigned nBlocks = blocks.size();
    const unsigned int block0 = sequence.FindBlock(s0);
+
+   // The previous pixel column might straddle blocks.
+   // Impute more data to it.
+   const auto addToLastPixel =
+   [&](float vmin, float vmax, double sumsq, double samples){
+      if (pixel == 0 || samples <= 0)
+         return;
+      const auto lastPixel = pixel - 1;
+      float &lastMin = min[lastPixel];
+      lastMin = std::min(lastMin, vmin);
+      float &lastMax = max[lastPixel];
+      lastMax = std::max(lastMax, vmax);
+      float &lastRms = rms[lastPixel];
+      lastRms = sqrt(
+         (lastRms * lastRms * lastNumSamples + sumsq) /
+         (lastNumSamples + samples)
+      );
+      lastNumSamples += samples;
+   };
+
    for (unsigned int b = block0; b < nBlocks; ++b) {
       if (b > block0)
          srcX = nextSrcX;
@@ -121,15 +112,28 @@ bool GetWaveDisplay(const Sequence &sequence,
                 (whereNext = std::min(s1 - 1, where[nextPixel])) < nextSrcX)
             ++nextPixel;
       }
-      if (nextPixel == pixel)
+      if (nextPixel == pixel) {
          // The entire block's samples fall within one pixel column.
          // Either it's a rare odd block at the end, or else,
          // we must be really zoomed out!
-         // Omit the entire block's contents from min/max/rms
-         // calculation, which is not correct, but correctness might not
-         // be worth the compute time if this happens every pixel
-         // column. -- PRL
+         // Find the run of whole blocks that end in the column, and impute
+         // the combined summaries of all of them at once, so that the cost
+         // is not proportional to the number of blocks
+         const auto columnEnd = (pixel < len) ? whereNext : s1;
+         const auto bEnd = (columnEnd >= numSamples)
+            ? nBlocks
+            : std::max(b, unsigned(sequence.FindBlock(columnEnd)));
+         if (bEnd == b)
+            // A partial block at the end is omitted
+            continue;
+         const auto values = sequence.SummarizeBlocks(b, bEnd);
+         addToLastPixel(values.min, values.max, values.sumsq, values.samples);
+         b = bEnd - 1;
+         const SeqBlock &lastBlock = blocks[b];
+         nextSrcX =
+            std::min(s1, lastBlock.start + lastBlock.sb->GetSampleCount());
          continue;
+      }
       if (nextPixel == len)
          whereNext = s1;
 
@@ -196,18 +200,9 @@ bool GetWaveDisplay(const Sequence &sequence,
          auto midPosition = ((whereNow - start) / divisor).as_size_t();
          int diff(midPosition - filePosition);
          if (diff > 0) {
-            MinMaxSumsq values(temp.get(), diff, divisor);
-            const int lastPixel = pixel - 1;
-            float &lastMin = min[lastPixel];
-            lastMin = std::min(lastMin, values.min);
-            float &lastMax = max[lastPixel];
-            lastMax = std::max(lastMax, values.max);
-            float &lastRms = rms[lastPixel];
-            int lastNumSamples = lastRmsDenom * lastDivisor;
-            lastRms = sqrt(
-               (lastRms * lastRms * lastNumSamples + values.sumsq * divisor) /
-               (lastNumSamples + diff * divisor)
-            );
+            const auto values = Summarize(temp.get(), diff, divisor);
+            addToLastPixel(values.min, values.max,
+               double(values.sumsq) * divisor, double(diff) * divisor);
 
             filePosition = midPosition;
          }
@@ -237,7 +232,7 @@ bool GetWaveDisplay(const Sequence &sequence,
          wxASSERT(rmsDenom > 0);
          const float *const pv =
             temp.get() + (filePosition - startPosition) * (divisor == 1 ? 1 : 3);
-         MinMaxSumsq values(pv, std::max(0, rmsDenom), divisor);
+         const auto values = Summarize(pv, rmsDenom, divisor);
 
          // Assign results
          std::fill(&min[pixel], &min[pixelX], values.min);
@@ -251,8 +246,7 @@ bool GetWaveDisplay(const Sequence &sequence,
       wxASSERT(pixel == nextPixel);
       whereNow = whereNext;
       pixel = nextPixel;
-      lastDivisor = divisor;
-      lastRmsDenom = rmsDenom;
+      lastNumSamples = double(rmsDenom) * divisor;
    } // for each block file
 
    wxASSERT(pixel == len);
@@ -0,0 +1,249 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SpectrogramTiles.cpp
+  @brief Spectra of whole sample blocks, kept in the project for reuse
+
+**********************************************************************/
+
+#include "SpectrogramTiles.h"
+
+#include <algorithm>
+
+#include "SampleBlock.h"
+#include "SpectrumCache.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+
+// Tenacity libraries
+#include <lib-preferences/Prefs.h>
+#include <lib-utility/ThreadPool.h>
+
+BoolSetting SpectrogramTilesEnabled{ L"/Performance/SpectrogramTiles", false };
+
+namespace {
+//! Hops are the window size divided by powers of two, up to this one
+constexpr size_t MaxHopDivisor = 8;
+
+//! Hops are at most this fraction of a pixel, so that the nearest window
+//! is at most half that away
+constexpr double MinHopsPerPixel = 4.0;
+
+//! Computing whole tiles is not worth it for much coarser zooms, where few
+//! of their columns are shown; but tiles already stored are still used
+constexpr double MaxComputeHopsPerPixel = 8.0;
+
+std::string MakeKey(
+   const SpectrogramSettings &settings, double rate, size_t hop)
+{
+   std::string key = "spectrogram"
+      "/a" + std::to_string(settings.algorithm) +
+      "/w" + std::to_string(settings.WindowSize()) +
+      "/z" + std::to_string(settings.ZeroPaddingFactor()) +
+      "/t" + std::to_string(settings.windowType) +
+      "/h" + std::to_string(hop);
+   if (settings.algorithm == SpectrogramSettings::algPitchEAC)
+      key += "/r" + std::to_string(static_cast<long>(rate));
+   return key;
+}
+}
+
+std::shared_ptr<SpectrogramTiles> SpectrogramTiles::Create(
+   const WaveTrack &track, const WaveClip &clip,
+   const SpectrogramSettings &settings, double samplesPerPixel)
+{
+   if (!SpectrogramTilesEnabled.Read())
+      return {};
+
+   // Reassignment accumulates across columns, so it has no tiles
+   if (settings.algorithm != SpectrogramSettings::algSTFT &&
+       settings.algorithm != SpectrogramSettings::algPitchEAC)
+      return {};
+
+   // The greatest hop near enough to the pixel columns
+   const auto windowSize = settings.WindowSize();
+   auto hop = windowSize;
+   while (hop * MinHopsPerPixel > samplesPerPixel) {
+      hop /= 2;
+      if (hop == 0 || hop * MaxHopDivisor < windowSize)
+         return {};
+   }
+
+   const auto &pFactory = track.GetSampleBlockFactory();
+   if (!pFactory || !pFactory->EnableDerivedData())
+      return {};
+
+   return std::make_shared<SpectrogramTiles>(pFactory,
+      clip.GetSequence()->GetBlockArray(), settings, clip.GetRate(), hop,
+      samplesPerPixel <= hop * MaxComputeHopsPerPixel);
+}
+
+SpectrogramTiles::SpectrogramTiles(
+   const std::shared_ptr<SampleBlockFactory> &pFactory,
+   const BlockArray &blocks, const SpectrogramSettings &settings,
+   double rate, size_t hop, bool mayCompute)
+: mpFactory{ pFactory }
+, mBlocks{ blocks }
+, mSettings{ settings }
+, mRate{ rate }
+, mMayCompute{ mayCompute }
+, mHop{ hop }
+, mNBins{ settings.NBins() }
+, mKey{ MakeKey(settings, rate, hop) }
+{
+   mSettings.CacheWindows();
+}
+
+SpectrogramTiles::~SpectrogramTiles() = default;
+
+size_t SpectrogramTiles::CountColumns(const SampleBlock &block) const
+{
+   const auto windowSize = mSettings.WindowSize();
+   const auto numSamples = block.GetSampleCount();
+   return numSamples < windowSize ? 0 : (numSamples - windowSize) / mHop + 1;
+}
+
+bool SpectrogramTiles::Find(sampleCount where, float *out)
+{
+   // Find the block containing the sample
+   auto iter = std::upper_bound(mBlocks.begin(), mBlocks.end(), where,
+      [](sampleCount sample, const SeqBlock &block){
+         return sample < block.start; });
+   if (iter == mBlocks.begin())
+      return false;
+   --iter;
+
+   // Columns are centered half a window after multiples of the hop
+   const auto half = mSettings.WindowSize() / 2;
+   const auto offset = (where - iter->start).as_long_long();
+   if (offset < (long long)half)
+      return false;
+   const auto iColumn = (size_t(offset) - half + mHop / 2) / mHop;
+
+   const auto pTile = GetTile(iter - mBlocks.begin());
+   if (!pTile || iColumn >= pTile->nColumns)
+      return false;
+
+   const auto column = &pTile->columns[iColumn * mNBins];
+   std::copy(column, column + mNBins, out);
+   return true;
+}
+
+auto SpectrogramTiles::GetTile(size_t iBlock) -> TilePtr
+{
+   std::promise<TilePtr> promise;
+   std::shared_future<TilePtr> future;
+   bool mine = false;
+   {
+      std::lock_guard<std::mutex> guard(mMutex);
+      auto iter = mTiles.find(iBlock);
+      if (iter != mTiles.end())
+         future = iter->second;
+      else {
+         future = promise.get_future().share();
+         mTiles.emplace(iBlock, future);
+         mOrder.push_back(iBlock);
+         mine = true;
+
+         // Bound the memory; a few tiles for each thread computing columns
+         const auto maxTiles = 4 * (ThreadPool::Get().GetNumThreads() + 1);
+         while (mOrder.size() > maxTiles) {
+            mTiles.erase(mOrder.front());
+            mOrder.pop_front();
+         }
+      }
+   }
+
+   if (mine) {
+      // Other threads wanting the same tile wait for this one to make it
+      TilePtr pTile;
+      auto &block = *mBlocks[iBlock].sb;
+      // Silent blocks need no storage, and are quick to compute anyway
+      if (block.GetBlockID() > 0) {
+         try {
+            pTile = LoadTile(block);
+            if (!pTile && mMayCompute) {
+               pTile = ComputeTile(block);
+               if (pTile) {
+                  std::lock_guard<std::mutex> guard(mMutex);
+                  mComputed.emplace_back(iBlock, pTile);
+               }
+            }
+         }
+         catch ( ... ) {
+            // Don't throw in this drawing operation
+            pTile.reset();
+         }
+      }
+      promise.set_value(pTile);
+   }
+
+   return future.get();
+}
+
+auto SpectrogramTiles::LoadTile(const SampleBlock &block) const -> TilePtr
+{
+   std::vector<char> data;
+   if (!mpFactory->LoadDerivedData(block, mKey, data))
+      return {};
+
+   auto pTile = std::make_shared<Tile>();
+   pTile->nColumns = CountColumns(block);
+   const auto size = pTile->nColumns * mNBins;
+   // Ignore a tile of the wrong size, which will be replaced
+   if (data.size() != size * sizeof(float))
+      return {};
+   pTile->columns.resize(size);
+   std::copy(data.begin(), data.end(),
+      reinterpret_cast<char*>(pTile->columns.data()));
+   return pTile;
+}
+
+auto SpectrogramTiles::ComputeTile(SampleBlock &block) const -> TilePtr
+{
+   const auto nColumns = CountColumns(block);
+   if (nColumns == 0)
+      return {};
+
+   // Worker threads may not load blocks lazily; leave the columns to the
+   // caller, as BlockPrefetcher does
+   if (!block.IsLoaded())
+      return {};
+
+   const auto numSamples = block.GetSampleCount();
+   Floats samples{ numSamples };
+   if (block.GetSamples(reinterpret_cast<samplePtr>(samples.get()),
+         floatSample, 0, numSamples, false) != numSamples)
+      return {};
+
+   const auto windowSize = mSettings.WindowSize();
+   const auto fftLen = windowSize * mSettings.ZeroPaddingFactor();
+   const auto padding = (fftLen - windowSize) / 2;
+   std::vector<float> buffer(fftLen);
+
+   auto pTile = std::make_shared<Tile>();
+   pTile->nColumns = nColumns;
+   pTile->columns.resize(nColumns * mNBins);
+   for (size_t iColumn = 0; iColumn < nColumns; ++iColumn) {
+      std::fill(buffer.begin(), buffer.end(), 0.0f);
+      const auto first = samples.get() + iColumn * mHop;
+      std::copy(first, first + windowSize, buffer.begin() + padding);
+      ComputeSpectrogramColumn(mSettings, buffer.data(), mRate,
+         &pTile->columns[iColumn * mNBins]);
+   }
+   return pTile;
+}
+
+void SpectrogramTiles::Flush()
+{
+   std::vector<std::pair<size_t, TilePtr>> computed;
+   {
+      std::lock_guard<std::mutex> guard(mMutex);
+      computed.swap(mComputed);
+   }
+
+   for (auto &[iBlock, pTile] : computed)
+      mpFactory->StoreDerivedData(*mBlocks[iBlock].sb, mKey,
+         pTile->columns.data(), pTile->columns.size() * sizeof(float));
+}
@@ -0,0 +1,106 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file SpectrogramTiles.h
+  @brief Spectra of whole sample blocks, kept in the project for reuse
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SPECTROGRAM_TILES__
+#define __AUDACITY_SPECTROGRAM_TILES__
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Sequence.h" // for BlockArray
+#include "../../../../prefs/SpectrogramSettings.h"
+
+class BoolSetting;
+class SampleBlock;
+class SampleBlockFactory;
+class WaveClip;
+class WaveTrack;
+
+//! Whether spectrogram tiles are stored in projects and reused
+extern TENACITY_DLL_API BoolSetting SpectrogramTilesEnabled;
+
+///\brief Spectrogram columns of sample blocks, stored beside their samples
+/*!
+ A tile holds the spectra of one sample block, for all windows lying
+ entirely within the block, at one of a few hops: the window size, or that
+ divided by 2, 4 or 8.  Blocks never change, so neither do their tiles,
+ which serve all zoom levels that choose the same hop, in this session and
+ later ones.  A zoom level chooses the greatest hop that is at most a
+ quarter of a pixel, so that each column comes from the nearest window in
+ the tile, at most an eighth of a pixel away from the window that would
+ be computed for it.  Zooms closer than two pixels per window use no tiles.
+ Tiles are deleted with their blocks.
+
+ Spectra are stored before any frequency dependent gain.  Columns near the
+ ends of blocks, or where there is no tile, are left to the caller.
+ */
+class TENACITY_DLL_API SpectrogramTiles final
+{
+public:
+   //! @return null if tiles are disabled or unusable at this zoom
+   /*! Main thread only */
+   static std::shared_ptr<SpectrogramTiles> Create(const WaveTrack &track,
+      const WaveClip &clip, const SpectrogramSettings &settings,
+      double samplesPerPixel);
+
+   /*!
+    @param hop between windows; at most the window size
+    @param mayCompute if false, only tiles already stored are used; if true,
+    missing tiles are computed, to be stored by Flush()
+    */
+   SpectrogramTiles(const std::shared_ptr<SampleBlockFactory> &pFactory,
+      const BlockArray &blocks, const SpectrogramSettings &settings,
+      double rate, size_t hop, bool mayCompute);
+   ~SpectrogramTiles();
+
+   //! Copy the spectrum nearest the given sample of the sequence; any thread
+   /*! @return false if there is no such spectrum, and then out is unchanged */
+   bool Find(sampleCount where, float *out);
+
+   //! Store the tiles computed since the last call; main thread only
+   void Flush();
+
+private:
+   struct Tile {
+      size_t nColumns{ 0 };
+      std::vector<float> columns;
+   };
+   using TilePtr = std::shared_ptr<const Tile>;
+
+   size_t CountColumns(const SampleBlock &block) const;
+   TilePtr GetTile(size_t iBlock);
+   TilePtr LoadTile(const SampleBlock &block) const;
+   TilePtr ComputeTile(SampleBlock &block) const;
+
+   const std::shared_ptr<SampleBlockFactory> mpFactory;
+   const BlockArray mBlocks;
+   const SpectrogramSettings mSettings;
+   const double mRate;
+   const bool mMayCompute;
+   const size_t mHop;
+   const size_t mNBins;
+   //! Names the algorithm and its parameters in the project
+   const std::string mKey;
+
+   std::mutex mMutex;
+   //! Tiles by index in mBlocks, shared while loading or computing
+   std::unordered_map<size_t, std::shared_future<TilePtr>> mTiles;
+   //! Indices in mTiles, oldest first, for eviction
+   std::deque<size_t> mOrder;
+   //! Computed but not yet stored
+   std::vector<std::pair<size_t, TilePtr>> mComputed;
+};
+
+#endif
@@ -10,14 +10,23 @@
 
 #include "SpectrumCache.h"
 
+#include <algorithm>
 #include <cmath>
+#include <mutex>
 #include "RealFFTf.h"
 #include "SampleTrackCache.h"
+#include "Sequence.h"
+#include "SpectrogramTiles.h"
+#include "../../../../SpectrogramScheduler.h"
 #include "../../../../prefs/SpectrogramSettings.h"
 #include "Spectrum.h"
 #include "WaveClipUtilities.h"
 #include "WaveTrack.h"
 
+// Tenacity libraries
+#include <lib-exceptions/TenacityException.h>
+#include <lib-utility/ThreadPool.h>
+
 class WaveTrack;
 
 namespace {
@@ -71,6 +80,32 @@ void ComputeSpectrogramGainFactors
    }
 }
 
+//! Fill a column from a stored tile, if there is one, and apply the gain
+bool FillFromTiles(SpectrogramTiles &tiles, sampleCount where, size_t nBins,
+   const std::vector<float> &gainFactors, float *results)
+{
+   if (!tiles.Find(where, results))
+      return false;
+   if (!gainFactors.empty()) {
+      // Apply a frequency-dependent gain factor
+      for (size_t ii = 0; ii < nBins; ++ii)
+         results[ii] += gainFactors[ii];
+   }
+   return true;
+}
+
+}
+
+void ComputeSpectrogramColumn(const SpectrogramSettings &settings,
+   float *buffer, double rate, float *out)
+{
+   if (settings.algorithm == SpectrogramSettings::algPitchEAC)
+      ComputeSpectrum(buffer, settings.WindowSize(), settings.WindowSize(),
+         rate, out, true, settings.windowType);
+   else
+      ComputeSpectrumUsingRealFFTf(buffer, settings.hFFT.get(),
+         settings.window.get(),
+         settings.WindowSize() * settings.ZeroPaddingFactor(), out);
 }
 
 bool SpecCache::Matches
@@ -102,6 +137,23 @@ bool SpecCache::CalculateOneSpectrum
     int lowerBoundX, int upperBoundX,
     const std::vector<float> &gainFactors,
     float* __restrict scratch, float* __restrict out) const
+{
+   return CalculateOneSpectrum(settings,
+      [&](sampleCount start, size_t len){
+         // Don't throw in this drawing operation
+         return waveTrackCache.GetFloats(start, len, false); },
+      xx, numSamples, offset, rate, pixelsPerSecond, lowerBoundX, upperBoundX,
+      gainFactors, scratch, out);
+}
+
+bool SpecCache::CalculateOneSpectrum
+   (const SpectrogramSettings &settings,
+    const SampleSource &source,
+    const int xx, const sampleCount numSamples,
+    double offset, double rate, double pixelsPerSecond,
+    int lowerBoundX, int upperBoundX,
+    const std::vector<float> &gainFactors,
+    float* __restrict scratch, float* __restrict out) const
 {
    bool result = false;
    const bool reassignment =
@@ -172,13 +224,11 @@ bool SpecCache::CalculateOneSpectrum
          }
 
          if (myLen > 0) {
-            useBuffer = (float*)(waveTrackCache.GetFloats(
+            useBuffer = (float*)(source(
                sampleCount(
                   floor(0.5 + from.as_double() + offset * rate)
                ),
-               myLen,
-               // Don't throw in this drawing operation
-               false)
+               myLen)
             );
 
             if (copy) {
@@ -198,9 +248,7 @@ bool SpecCache::CalculateOneSpectrum
          wxASSERT(xx >= 0);
          float *const results = &out[nBins * xx];
          // This function does not mutate useBuffer
-         ComputeSpectrum(useBuffer, windowSizeSetting, windowSizeSetting,
-            rate, results,
-            autocorrelation, settings.windowType);
+         ComputeSpectrogramColumn(settings, useBuffer, rate, results);
       }
       else if (reassignment) {
          static const double epsilon = 1e-16;
@@ -305,8 +353,7 @@ bool SpecCache::CalculateOneSpectrum
          // the part of useBuffer in the padding zones.
 
          // This function mutates useBuffer
-         ComputeSpectrumUsingRealFFTf
-            (useBuffer, settings.hFFT.get(), settings.window.get(), fftLen, results);
+         ComputeSpectrogramColumn(settings, useBuffer, rate, results);
          if (!gainFactors.empty()) {
             // Apply a frequency-dependent gain factor
             for (size_t ii = 0; ii < nBins; ++ii)
@@ -345,7 +392,8 @@ void SpecCache::Populate
    (const SpectrogramSettings &settings, SampleTrackCache &waveTrackCache,
     int copyBegin, int copyEnd, size_t numPixels,
     sampleCount numSamples,
-    double offset, double rate, double pixelsPerSecond)
+    double offset, double rate, double pixelsPerSecond,
+    SpectrogramTiles *pTiles)
 {
    const int &frequencyGainSetting = settings.frequencyGain;
    const size_t windowSizeSetting = settings.WindowSize();
@@ -395,6 +443,9 @@ void SpecCache::Populate
 #endif
       for (auto xx = lowerBoundX; xx < upperBoundX; ++xx)
       {
+         if (pTiles && FillFromTiles(*pTiles, where[xx], nBins,
+               gainFactors, &freq[nBins * xx]))
+            continue;
 #ifdef _OPENMP
          tls.init(waveTrackCache, scratchSize);
          SampleTrackCache& cache = *tls.cache;
@@ -466,12 +517,265 @@ void SpecCache::Populate
    }
 }
 
+namespace {
+//! The blocks of a sequence that some columns need, copied in the main thread
+/*!
+ Like BlockPrefetcher, reading in other threads skips blocks that are not
+ yet loaded, because only the main thread may load them.
+ */
+class SequenceSnapshot
+{
+public:
+   //! Add the blocks overlapping samples [start, end) of the sequence, after
+   //! those added already; main thread only
+   void Add(const Sequence &sequence, sampleCount start, sampleCount end);
+
+   //! Read samples of the sequence, with zeroes where there were no blocks
+   /*!
+    @param mayLoad whether to load blocks as needed, in the main thread;
+    if false, their samples are zeroes too
+    @return false if a block was skipped because it was not loaded
+    */
+   bool Read(float *dest, sampleCount start, size_t len, bool mayLoad) const;
+
+private:
+   std::vector<SeqBlock> mBlocks;
+};
+
+void SequenceSnapshot::Add(
+   const Sequence &sequence, sampleCount start, sampleCount end)
+{
+   const auto &blocks = sequence.GetBlockArray();
+   auto iter = std::upper_bound(blocks.begin(), blocks.end(), start,
+      [](sampleCount pos, const SeqBlock &block){ return pos < block.start; });
+   if (iter != blocks.begin())
+      --iter;
+   for (; iter != blocks.end() && iter->start < end; ++iter)
+      if (mBlocks.empty() || mBlocks.back().start < iter->start)
+         mBlocks.push_back(*iter);
+}
+
+bool SequenceSnapshot::Read(
+   float *dest, sampleCount start, size_t len, bool mayLoad) const
+{
+   std::fill(dest, dest + len, 0.0f);
+   bool result = true;
+   const auto end = start + len;
+   auto iter = std::upper_bound(mBlocks.begin(), mBlocks.end(), start,
+      [](sampleCount pos, const SeqBlock &block){ return pos < block.start; });
+   if (iter != mBlocks.begin())
+      --iter;
+   for (; iter != mBlocks.end() && iter->start < end; ++iter) {
+      auto &block = *iter->sb;
+      const auto blockEnd = iter->start + block.GetSampleCount();
+      const auto first = std::max(start, iter->start);
+      const auto last = std::min(end, blockEnd);
+      if (first >= last)
+         continue;
+      if (!mayLoad && !block.IsLoaded()) {
+         result = false;
+         continue;
+      }
+      // Don't throw in this drawing operation
+      block.GetSamples(
+         reinterpret_cast<samplePtr>(dest + (first - start).as_size_t()),
+         floatSample, (first - iter->start).as_size_t(),
+         (last - first).as_size_t(), false);
+   }
+   return result;
+}
+}
+
+//! Computes the dirty columns of a SpecCache in the background, in chunks
+/*!
+ The settings are copied, and so are the blocks of the clip that the columns
+ need, so that the track may change meanwhile in the main thread.  Columns
+ needing blocks not yet loaded are computed again in the main thread, when
+ harvested.  The results are copied into the cache only in the main thread,
+ so that the cache is never shared.
+ */
+class SpectrogramColumns final : public SpectrogramScheduler::Job
+{
+public:
+   /*!
+    @param ranges of columns to compute
+    @param numSamples in the sequence of the clip
+    */
+   SpectrogramColumns(const SpectrogramSettings &settings,
+      const Sequence &sequence,
+      const std::shared_ptr<SpectrogramTiles> &pTiles,
+      const SpecCache &cache,
+      const std::vector<std::pair<int, int>> &ranges,
+      sampleCount numSamples, double rate,
+      double pixelsPerSecond,
+      const WaveClipSpectrumCache::ProgressCallback &onProgress);
+
+   size_t NumChunks() const { return mChunks.size(); }
+   bool Finished() const { return mnHarvested == mChunks.size(); }
+
+   //! Copy into the cache the columns that became ready since the last call
+   /*! @return whether there were any */
+   bool Harvest(SpecCache &cache);
+
+private:
+   void Compute(size_t iTask) override;
+   void OnReady(size_t iTask) override;
+
+   //! @return false if skipped blocks left the column incomplete
+   bool ComputeColumn(int xx, int begin, int end, bool mayLoad,
+      float *buffer, float *scratch);
+
+   size_t FFTLength() const
+   {
+      return mSettings.WindowSize() * mSettings.ZeroPaddingFactor();
+   }
+
+   //! Few enough that the display fills in smoothly
+   static constexpr int ColumnsPerChunk = 32;
+
+   const SpectrogramSettings mSettings;
+   SequenceSnapshot mSnapshot;
+   //! May be null
+   const std::shared_ptr<SpectrogramTiles> mpTiles;
+   //! Only len and where are copied from the cache; freq receives results
+   SpecCache mColumns;
+   std::vector<std::pair<int, int>> mChunks;
+   std::vector<float> mGainFactors;
+   const sampleCount mNumSamples;
+   const double mRate, mPixelsPerSecond;
+   const WaveClipSpectrumCache::ProgressCallback mOnProgress;
+
+   std::mutex mMutex;
+   //! Chunks computed but not yet harvested; guarded by mMutex
+   std::vector<size_t> mReady;
+   //! Columns of those chunks to compute again; guarded by mMutex
+   std::vector<int> mDeferred;
+   size_t mnHarvested{ 0 };
+};
+
+SpectrogramColumns::SpectrogramColumns(const SpectrogramSettings &settings,
+   const Sequence &sequence,
+   const std::shared_ptr<SpectrogramTiles> &pTiles,
+   const SpecCache &cache,
+   const std::vector<std::pair<int, int>> &ranges,
+   sampleCount numSamples, double rate,
+   double pixelsPerSecond,
+   const WaveClipSpectrumCache::ProgressCallback &onProgress)
+: mSettings{ settings }
+, mpTiles{ pTiles }
+, mNumSamples{ numSamples }
+, mRate{ rate }
+, mPixelsPerSecond{ pixelsPerSecond }
+, mOnProgress{ onProgress }
+{
+   mSettings.CacheWindows();
+   mColumns.len = cache.len;
+   mColumns.where = cache.where;
+   mColumns.freq.resize(cache.freq.size());
+
+   // Each column takes a window centered at its sample
+   const auto halfWindow = mSettings.WindowSize() / 2;
+   for (auto [begin, end] : ranges) {
+      if (begin >= end)
+         continue;
+      mSnapshot.Add(sequence, cache.where[begin] - halfWindow,
+         cache.where[end] + halfWindow);
+      for (auto xx = begin; xx < end; xx += ColumnsPerChunk)
+         mChunks.emplace_back(xx, std::min(end, xx + ColumnsPerChunk));
+   }
+
+   if (mSettings.algorithm != SpectrogramSettings::algPitchEAC)
+      ComputeSpectrogramGainFactors(FFTLength(), rate,
+         mSettings.frequencyGain, mGainFactors);
+}
+
+bool SpectrogramColumns::ComputeColumn(int xx, int begin, int end,
+   bool mayLoad, float *buffer, float *scratch)
+{
+   if (mpTiles && FillFromTiles(*mpTiles, mColumns.where[xx],
+         mSettings.NBins(), mGainFactors,
+         &mColumns.freq[mSettings.NBins() * xx]))
+      return true;
+   bool complete = true;
+   // Positions are of the sequence, so the offset is zero
+   mColumns.CalculateOneSpectrum(mSettings,
+      [&](sampleCount start, size_t len){
+         if (!mSnapshot.Read(buffer, start, len, mayLoad))
+            complete = false;
+         return buffer; },
+      xx, mNumSamples, 0, mRate, mPixelsPerSecond,
+      begin, end, mGainFactors, scratch, mColumns.freq.data());
+   return complete;
+}
+
+void SpectrogramColumns::Compute(size_t iTask)
+{
+   const auto [begin, end] = mChunks[iTask];
+   std::vector<int> deferred;
+   try {
+      std::vector<float> buffer(mSettings.WindowSize());
+      std::vector<float> scratch(FFTLength());
+      for (auto xx = begin; xx < end && !IsCancelled(); ++xx)
+         if (!ComputeColumn(xx, begin, end, false,
+               buffer.data(), scratch.data()))
+            deferred.push_back(xx);
+   }
+   catch ( ... ) {
+      // Don't throw in this drawing operation; leave the columns at the floor
+      const auto nBins = mSettings.NBins();
+      std::fill(&mColumns.freq[nBins * begin], &mColumns.freq[nBins * end],
+         -160.0f);
+   }
+
+   std::lock_guard<std::mutex> guard(mMutex);
+   mReady.push_back(iTask);
+   mDeferred.insert(mDeferred.end(), deferred.begin(), deferred.end());
+}
+
+void SpectrogramColumns::OnReady(size_t iTask)
+{
+   if (mOnProgress)
+      mOnProgress(mChunks[iTask].first, mChunks[iTask].second);
+}
+
+bool SpectrogramColumns::Harvest(SpecCache &cache)
+{
+   std::vector<size_t> ready;
+   std::vector<int> deferred;
+   {
+      std::lock_guard<std::mutex> guard(mMutex);
+      ready.swap(mReady);
+      deferred.swap(mDeferred);
+   }
+
+   // Blocks may be loaded here, in the main thread
+   if (!deferred.empty()) {
+      std::vector<float> buffer(mSettings.WindowSize());
+      std::vector<float> scratch(FFTLength());
+      for (auto xx : deferred)
+         GuardedCall( [&]{ ComputeColumn(xx, xx, xx + 1, true,
+            buffer.data(), scratch.data()); } );
+   }
+
+   const auto nBins = mSettings.NBins();
+   for (auto iTask : ready) {
+      const auto [begin, end] = mChunks[iTask];
+      std::copy(&mColumns.freq[nBins * begin], &mColumns.freq[nBins * end],
+         &cache.freq[nBins * begin]);
+   }
+   mnHarvested += ready.size();
+   if (mpTiles)
+      mpTiles->Flush();
+   return !ready.empty();
+}
+
 bool WaveClipSpectrumCache::GetSpectrogram(const WaveClip &clip,
    SampleTrackCache &waveTrackCache,
    const float *& spectrogram,
    const sampleCount *& where,
    size_t numPixels,
-   double t0, double pixelsPerSecond)
+   double t0, double pixelsPerSecond,
+   const ProgressCallback &onProgress)
 {
    t0 += clip.GetTrimLeft();
 
@@ -490,9 +794,28 @@ bool WaveClipSpectrumCache::GetSpectrogram(const WaveClip &clip,
       mSpecCache->Matches
       (mDirty, pixelsPerSecond, settings, rate);
 
-   if (match &&
-       mSpecCache->start == t0 &&
-       mSpecCache->len >= numPixels) {
+   const bool hit = match &&
+      mSpecCache->start == t0 &&
+      mSpecCache->len >= numPixels;
+
+   if (mpColumns) {
+      if (hit && !mpColumns->IsCancelled()) {
+         // Take whatever more the background computation has finished
+         const bool updated = mpColumns->Harvest(*mSpecCache);
+         if (mpColumns->Finished())
+            mpColumns.reset();
+         spectrogram = &mSpecCache->freq[0];
+         where = &mSpecCache->where[0];
+
+         return updated;
+      }
+
+      // The view scrolled or zoomed since the computation began.  Stop it,
+      // and copy nothing from the incomplete cache.
+      CancelColumns();
+      match = false;
+   }
+   else if (hit) {
       spectrogram = &mSpecCache->freq[0];
       where = &mSpecCache->where[0];
 
@@ -576,10 +899,39 @@ bool WaveClipSpectrumCache::GetSpectrogram(const WaveClip &clip,
    fillWhere(mSpecCache->where, numPixels, 0.5, correction,
       t0, rate, samplesPerPixel);
 
-   mSpecCache->Populate
-      (settings, waveTrackCache, copyBegin, copyEnd, numPixels,
-       clip.GetSequenceSamplesCount(),
-       clip.GetSequenceStartTime(), rate, pixelsPerSecond);
+   const auto pTiles =
+      SpectrogramTiles::Create(*track, clip, settings, samplesPerPixel);
+
+   // Reassignment accumulates across columns, so it is not divided among
+   // background tasks
+   if (onProgress &&
+       settings.algorithm != SpectrogramSettings::algReassignment &&
+       ThreadPool::Get().GetNumThreads() > 0) {
+      const std::vector<std::pair<int, int>> ranges{
+         { 0, copyBegin }, { copyEnd, (int)numPixels } };
+      for (auto [begin, end] : ranges)
+         if (begin < end)
+            // Show the floor until the columns are ready
+            std::fill(&mSpecCache->freq[nBins * begin],
+               &mSpecCache->freq[nBins * end], -160.0f);
+
+      auto pColumns = std::make_shared<SpectrogramColumns>(settings,
+         *clip.GetSequence(), pTiles, *mSpecCache, ranges,
+         clip.GetSequenceSamplesCount(), rate, pixelsPerSecond, onProgress);
+      if (pColumns->NumChunks() > 0) {
+         mpColumns = pColumns;
+         SpectrogramScheduler::Get().Schedule(pColumns, pColumns->NumChunks(),
+            track->GetSampleBlockFactory().get());
+      }
+   }
+   else {
+      mSpecCache->Populate
+         (settings, waveTrackCache, copyBegin, copyEnd, numPixels,
+          clip.GetSequenceSamplesCount(),
+          clip.GetSequenceStartTime(), rate, pixelsPerSecond, pTiles.get());
+      if (pTiles)
+         pTiles->Flush();
+   }
 
    mSpecCache->dirty = mDirty;
    spectrogram = &mSpecCache->freq[0];
@@ -596,6 +948,7 @@ WaveClipSpectrumCache::WaveClipSpectrumCache()
 
 WaveClipSpectrumCache::~WaveClipSpectrumCache()
 {
+   CancelColumns();
 }
 
 static WaveClip::Caches::RegisteredFactory sKeyS{ []( WaveClip& ){
@@ -611,10 +964,20 @@ WaveClipSpectrumCache &WaveClipSpectrumCache::Get( const WaveClip &clip )
 void WaveClipSpectrumCache::MarkChanged()
 {
    ++mDirty;
+   CancelColumns();
 }
 
 void WaveClipSpectrumCache::Invalidate()
 {
    // Invalidate the spectrum display cache
+   CancelColumns();
    mSpecCache = std::make_unique<SpecCache>();
 }
+
+void WaveClipSpectrumCache::CancelColumns()
+{
+   if (mpColumns) {
+      mpColumns->Cancel();
+      mpColumns.reset();
+   }
+}
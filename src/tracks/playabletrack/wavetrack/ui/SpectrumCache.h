@@ -14,13 +14,28 @@
 class sampleCount;
 class SpectrogramSettings;
 class SampleTrackCache;
+class SpectrogramColumns;
+class SpectrogramTiles;
 
+#include <functional>
 #include <vector>
 #include "MemoryX.h"
 #include "WaveClip.h" // to inherit WaveClipListener
 
 using Floats = ArrayOf<float>;
 
+//! Compute one column of a spectrogram in dB, before any frequency gain
+/*!
+ @param buffer holds the window of samples, preceded by the zero padding, if
+ any; its length is the window size times the zero padding factor.  It may
+ be modified.
+ @param out receives settings.NBins() values
+ @pre settings.CacheWindows() was called, and the algorithm is not
+ reassignment
+ */
+TENACITY_DLL_API void ComputeSpectrogramColumn(
+   const SpectrogramSettings &settings, float *buffer, double rate, float *out);
+
 class TENACITY_DLL_API SpecCache {
 public:
 
@@ -42,6 +57,11 @@ public:
    bool Matches(int dirty_, double pixelsPerSecond,
       const SpectrogramSettings &settings, double rate) const;
 
+   //! Gives len samples of the track from start, as SampleTrackCache does
+   /*! The result may be null, and is used only until the next call */
+   using SampleSource =
+      std::function<const float *(sampleCount start, size_t len)>;
+
    // Calculate one column of the spectrum
    bool CalculateOneSpectrum
       (const SpectrogramSettings &settings,
@@ -53,16 +73,28 @@ public:
        float* __restrict scratch,
        float* __restrict out) const;
 
+   bool CalculateOneSpectrum
+      (const SpectrogramSettings &settings,
+       const SampleSource &source,
+       const int xx, sampleCount numSamples,
+       double offset, double rate, double pixelsPerSecond,
+       int lowerBoundX, int upperBoundX,
+       const std::vector<float> &gainFactors,
+       float* __restrict scratch,
+       float* __restrict out) const;
+
    // Grow the cache while preserving the (possibly now invalid!) contents
    void Grow(size_t len_, const SpectrogramSettings& settings,
                double pixelsPerSecond, double start_);
 
-   // Calculate the dirty columns at the begin and end of the cache
+   // Calculate the dirty columns at the begin and end of the cache,
+   // taking what columns there are from pTiles if not null
    void Populate
       (const SpectrogramSettings &settings, SampleTrackCache &waveTrackCache,
        int copyBegin, int copyEnd, size_t numPixels,
        sampleCount numSamples,
-       double offset, double rate, double pixelsPerSecond);
+       double offset, double rate, double pixelsPerSecond,
+       SpectrogramTiles *pTiles = nullptr);
 
    size_t       len { 0 }; // counts pixels, not samples
    int          algorithm;
@@ -112,6 +144,11 @@ struct WaveClipSpectrumCache final : WaveClipListener
    std::unique_ptr<SpecPxCache> mSpecPxCache;
    std::unique_ptr<SpecCache> mSpecCache;
    int mDirty { 0 };
+   //! Columns of mSpecCache still being computed in the background
+   std::shared_ptr<SpectrogramColumns> mpColumns;
+
+   //! Called in the main thread when columns [begin, end) are ready
+   using ProgressCallback = std::function<void(size_t begin, size_t end)>;
 
    static WaveClipSpectrumCache &Get( const WaveClip &clip );
 
@@ -119,11 +156,22 @@ struct WaveClipSpectrumCache final : WaveClipListener
    void Invalidate() override; // NOFAIL-GUARANTEE
 
    /** Getting high-level data for screen display */
+   /*!
+    If onProgress is given, columns not in the cache are computed in the
+    background, and the spectrogram may be returned with some columns still
+    at the floor of -160 dB.  Call again after onProgress, with the same
+    arguments, to get more of them.
+    @return whether any columns changed since the last call
+    */
    bool GetSpectrogram(const WaveClip &clip, SampleTrackCache &cache,
                        const float *& spectrogram,
                        const sampleCount *& where,
                        size_t numPixels,
-                       double t0, double pixelsPerSecond);
+                       double t0, double pixelsPerSecond,
+                       const ProgressCallback &onProgress = {});
+
+   //! Stop computing columns in the background; they will be recomputed
+   void CancelColumns();
 };
 
 #endif
@@ -29,6 +29,7 @@ Paul Licameli split from WaveTrackView.cpp
 #include "../../../../AColor.h"
 #include "../../../../TrackArt.h"
 #include "../../../../TrackArtist.h"
+#include "../../../../TrackPanel.h"
 #include "../../../../TrackPanelDrawingContext.h"
 #include "../../../../WaveClip.h"
 #include "../../../../WaveTrack.h"
@@ -36,6 +37,7 @@ Paul Licameli split from WaveTrackView.cpp
 
 #include <wx/dcmemory.h>
 #include <wx/graphics.h>
+#include <wx/weakref.h>
 
 static WaveTrackSubView::Type sType{
    WaveTrackViewConstants::Spectrum,
@@ -276,11 +278,21 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
    const sampleCount *where = 0;
    bool updated;
    {
+      // Repaint columns as the background computation finishes them
+      WaveClipSpectrumCache::ProgressCallback onProgress;
+      if (artist->progressive && artist->parent)
+         onProgress = [pPanel = wxWeakRef<TrackPanel>{ artist->parent }, mid]
+         (size_t begin, size_t end){
+            if (pPanel)
+               pPanel->RefreshArea({ mid.x + (int)begin, mid.y,
+                  (int)(end - begin), mid.height });
+         };
+
       const double pps = averagePixelsPerSample * rate;
       updated = WaveClipSpectrumCache::Get( *clip ).GetSpectrogram( *clip,
          waveTrackCache, freq, where,
          (size_t)mid.width,
-         t0, pps);
+         t0, pps, onProgress);
    }
    auto nBins = settings.NBins();
 
@@ -15,6 +15,9 @@
 #include "GetWaveDisplay.h"
 #include "WaveClipUtilities.h"
 
+// Tenacity libraries
+#include <lib-math/SampleSummary.h>
+
 class WaveCache {
 public:
    WaveCache()
@@ -215,22 +218,10 @@ bool WaveClipWaveformCache::GetWaveDisplay(
                      seqFormat, b.get(), len);
                }
 
-               float theMax, theMin, sumsq;
-               {
-                  const float val = pb[0];
-                  theMax = theMin = val;
-                  sumsq = val * val;
-               }
-               for(decltype(len) j = 1; j < len; j++) {
-                  const float val = pb[j];
-                  theMax = std::max(theMax, val);
-                  theMin = std::min(theMin, val);
-                  sumsq += val * val;
-               }
-
-               min[i] = theMin;
-               max[i] = theMax;
-               rms[i] = (float)sqrt(sumsq / len);
+               const auto summary = SummarizeSamples(pb, len);
+               min[i] = summary.min;
+               max[i] = summary.max;
+               rms[i] = (float)sqrt(summary.sumsq / len);
 
                didUpdate=true;
             }
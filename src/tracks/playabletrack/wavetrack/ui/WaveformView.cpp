@@ -42,6 +42,15 @@ Paul Licameli split from WaveTrackView.cpp
 
 #include <wx/graphics.h>
 #include <wx/dc.h>
+#include <wx/image.h>
+
+// Tenacity libraries
+#include <lib-preferences/Prefs.h>
+
+//! Whether waveforms are drawn into an image, then copied to the screen at
+//! once, instead of drawn one line at a time
+static BoolSetting WaveformRasterEnabled{
+   L"/Performance/WaveformRaster", false };
 
 static WaveTrackSubView::Type sType{
    WaveTrackViewConstants::Waveform,
@@ -330,6 +339,27 @@ void FindWavePortions
    }
 }
 
+//! Color a column of pixels of an image, from y1 to y2 inclusive, as
+//! AColor::Line would draw it
+static void FillColumn(
+   wxImage &image, int x, int y1, int y2, const wxColour &colour)
+{
+   if (y1 > y2)
+      std::swap(y1, y2);
+   y1 = std::max(y1, 0);
+   y2 = std::min(y2, image.GetHeight() - 1);
+   const auto width = image.GetWidth();
+   const auto data = image.GetData();
+   const auto alpha = image.GetAlpha();
+   for (int y = y1; y <= y2; ++y) {
+      const auto offset = y * width + x;
+      data[3 * offset] = colour.Red();
+      data[3 * offset + 1] = colour.Green();
+      data[3 * offset + 2] = colour.Blue();
+      alpha[offset] = colour.Alpha();
+   }
+}
+
 void DrawMinMaxRMS(
    TrackPanelDrawingContext &context, const wxRect & rect, const double env[],
    float zoomMin, float zoomMax,
@@ -345,6 +375,8 @@ void DrawMinMaxRMS(
    int lasth2 = std::numeric_limits<int>::min();
    int h1;
    int h2;
+   ArrayOf<int> h1s{ size_t(rect.width) };
+   ArrayOf<int> h2s{ size_t(rect.width) };
    ArrayOf<int> r1{ size_t(rect.width) };
    ArrayOf<int> r2{ size_t(rect.width) };
    ArrayOf<int> clipped;
@@ -356,16 +388,6 @@ void DrawMinMaxRMS(
       clipped.reinit( size_t(rect.width) );
    }
 
-   long pixAnimOffset = (long)fabs((double)(wxDateTime::Now().GetTicks() * -10)) +
-      wxDateTime::Now().GetMillisecond() / 100; //10 pixels a second
-
-   bool drawStripes = true;
-   bool drawWaveform = true;
-
-   const auto &muteSamplePen = artist->muteSamplePen;
-   const auto &samplePen = artist->samplePen;
-
-   dc.SetPen(muted ? muteSamplePen : samplePen);
    for (int x0 = 0; x0 < rect.width; ++x0) {
       int xx = rect.x + x0;
       double v;
@@ -401,6 +423,8 @@ void DrawMinMaxRMS(
       }
       lasth1 = h1;
       lasth2 = h2;
+      h1s[x0] = h1;
+      h2s[x0] = h2;
 
       r1[x0] = GetWaveYPos(-rms[x0] * env[x0], zoomMin, zoomMax,
                           rect.height, dB, true, dBRange, true);
@@ -416,15 +440,46 @@ void DrawMinMaxRMS(
       if (r2[x0] > r1[x0]) {
          r2[x0] = r1[x0];
       }
+   }
 
-      AColor::Line(dc, xx, rect.y + h2, xx, rect.y + h1);
+   const auto &samplePen = muted ? artist->muteSamplePen : artist->samplePen;
+   const auto &rmsPen = muted ? artist->muteRmsPen : artist->rmsPen;
+   const auto &clippedPen =
+      muted ? artist->muteClippedPen : artist->clippedPen;
+
+   if (WaveformRasterEnabled.Read()) {
+      if (rect.width <= 0 || rect.height <= 0)
+         return;
+
+      // Draw into a transparent image, the same pixels as the lines below
+      wxImage image{ rect.width, rect.height };
+      image.InitAlpha();
+      std::fill(image.GetAlpha(),
+         image.GetAlpha() + rect.width * rect.height, 0);
+
+      const auto sampleColour = samplePen.GetColour();
+      const auto rmsColour = rmsPen.GetColour();
+      for (int x0 = 0; x0 < rect.width; ++x0) {
+         FillColumn(image, x0, h2s[x0], h1s[x0], sampleColour);
+         FillColumn(image, x0, r2[x0], r1[x0], rmsColour);
+      }
+      const auto clippedColour = clippedPen.GetColour();
+      while (--clipcnt >= 0)
+         FillColumn(image, clipped[clipcnt] - rect.x,
+            0, rect.height, clippedColour);
+
+      dc.DrawBitmap(wxBitmap{ image }, rect.x, rect.y, true);
+      return;
    }
 
-   // Stroke rms over the min-max
-   const auto &muteRmsPen = artist->muteRmsPen;
-   const auto &rmsPen = artist->rmsPen;
+   dc.SetPen(samplePen);
+   for (int x0 = 0; x0 < rect.width; ++x0) {
+      int xx = rect.x + x0;
+      AColor::Line(dc, xx, rect.y + h2s[x0], xx, rect.y + h1s[x0]);
+   }
 
-   dc.SetPen(muted ? muteRmsPen : rmsPen);
+   // Stroke rms over the min-max
+   dc.SetPen(rmsPen);
    for (int x0 = 0; x0 < rect.width; ++x0) {
       int xx = rect.x + x0;
       AColor::Line(dc, xx, rect.y + r2[x0], xx, rect.y + r1[x0]);
@@ -432,10 +487,7 @@ void DrawMinMaxRMS(
 
    // Draw the clipping lines
    if (clipcnt) {
-      const auto &muteClippedPen = artist->muteClippedPen;
-      const auto &clippedPen = artist->clippedPen;
-
-      dc.SetPen(muted ? muteClippedPen : clippedPen);
+      dc.SetPen(clippedPen);
       while (--clipcnt >= 0) {
          int xx = clipped[clipcnt];
          AColor::Line(dc, xx, rect.y, xx, rect.y + rect.height);
@@ -67,6 +67,7 @@
 #include "../ProjectWindows.h"
 
 // Tenacity libraires
+#include <lib-math/SampleSummary.h>
 #include <lib-preferences/Prefs.h>
 #include <lib-project/Project.h>
 #include <lib-project/ProjectStatus.h>
@@ -188,14 +189,13 @@ wxString MeterUpdateMsg::toStringIfClipped()
 //
 // The MeterPanel passes itself messages via this queue so that it can
 // communicate between the audio thread and the GUI thread.
-// This class is as simple as possible in order to be thread-safe
-// without needing mutexes.
+// There is one producer and one consumer, so that atomic indices with
+// acquire and release ordering suffice, without mutexes.
 //
 
 MeterUpdateQueue::MeterUpdateQueue(size_t maxLen):
    mBufferSize(maxLen)
 {
-   Clear();
 }
 
 // destructor
@@ -205,27 +205,26 @@ MeterUpdateQueue::~MeterUpdateQueue()
 
 void MeterUpdateQueue::Clear()
 {
-   mStart = 0;
-   mEnd = 0;
+   mStart.store(mEnd.load(std::memory_order_acquire),
+      std::memory_order_release);
 }
 
 // Add a message to the end of the queue.  Return false if the
 // queue was full.
-bool MeterUpdateQueue::Put(MeterUpdateMsg &msg)
+bool MeterUpdateQueue::Put(const MeterUpdateMsg &msg)
 {
-   // mStart can be greater than mEnd because it is all mod mBufferSize
-   wxASSERT( (mEnd + mBufferSize - mStart) >= 0 );
-   int len = (mEnd + mBufferSize - mStart) % mBufferSize;
+   const auto end = mEnd.load(std::memory_order_relaxed);
+   const auto next = (end + 1) % mBufferSize;
 
    // Never completely fill the queue, because then the
    // state is ambiguous (mStart==mEnd)
-   if (len + 1 >= (int)(mBufferSize))
+   if (next == mStart.load(std::memory_order_acquire))
       return false;
 
    //wxLogDebug(wxT("Put: %s"), msg.toString());
 
-   mBuffer[mEnd] = msg;
-   mEnd = (mEnd+1)%mBufferSize;
+   mBuffer[end] = msg;
+   mEnd.store(next, std::memory_order_release);
 
    return true;
 }
@@ -234,13 +233,12 @@ bool MeterUpdateQueue::Put(MeterUpdateMsg &msg)
 // Return false if the queue was empty.
 bool MeterUpdateQueue::Get(MeterUpdateMsg &msg)
 {
-   int len = (mEnd + mBufferSize - mStart) % mBufferSize;
-
-   if (len == 0)
+   const auto start = mStart.load(std::memory_order_relaxed);
+   if (start == mEnd.load(std::memory_order_acquire))
       return false;
 
-   msg = mBuffer[mStart];
-   mStart = (mStart+1)%mBufferSize;
+   msg = mBuffer[start];
+   mStart.store((start + 1) % mBufferSize, std::memory_order_release);
 
    return true;
 }
@@ -938,6 +936,7 @@ void MeterPanel::Reset(double sampleRate, bool resetClipping)
 
    // While it's stopped, empty the queue
    mQueue.Clear();
+   mDiscardPending.store(true, std::memory_order_release);
 
    mLayoutValid = false;
 
@@ -983,26 +982,60 @@ static float ToDB(float v, float range)
    return ClipZeroToOne((db + range) / range);
 }
 
+//! Append the measurements of msg to those of sum
+/*! The rms fields of both hold sums of squares */
+static void CombineMessages(
+   MeterUpdateMsg &sum, const MeterUpdateMsg &msg, int numPeakSamplesToClip)
+{
+   for(int j=0; j<kMaxMeterBars; j++) {
+      sum.peak[j] = floatMax(sum.peak[j], msg.peak[j]);
+      sum.rms[j] += msg.rms[j];
+      // A run of peaked samples may cross the boundary
+      if (msg.clipping[j] ||
+          sum.tailPeakCount[j] + msg.headPeakCount[j] >=
+          numPeakSamplesToClip)
+         sum.clipping[j] = true;
+      if (sum.headPeakCount[j] == sum.numFrames)
+         sum.headPeakCount[j] += msg.headPeakCount[j];
+      if (msg.tailPeakCount[j] == msg.numFrames)
+         sum.tailPeakCount[j] += msg.numFrames;
+      else
+         sum.tailPeakCount[j] = msg.tailPeakCount[j];
+   }
+   sum.numFrames += msg.numFrames;
+}
+
 void MeterPanel::UpdateDisplay(
    unsigned numChannels, int numFrames, const float *sampleData)
 {
-   auto sptr = sampleData;
+   if (numFrames <= 0)
+      return;
    auto num = std::min(numChannels, mNumBars);
    MeterUpdateMsg msg;
 
    memset(&msg, 0, sizeof(msg));
    msg.numFrames = numFrames;
 
-   for(int i=0; i<numFrames; i++) {
-      for(unsigned int j=0; j<num; j++) {
-         msg.peak[j] = floatMax(msg.peak[j], fabs(sptr[j]));
-         msg.rms[j] += sptr[j]*sptr[j];
-
+   // One pass over all the channels, in vector lanes
+   MinMaxSumsq summaries[kMaxMeterBars];
+   SummarizeInterleaved(sampleData, numChannels, numFrames, summaries, num);
+
+   for(unsigned int j=0; j<num; j++) {
+      msg.peak[j] = floatMax(fabs(summaries[j].min), fabs(summaries[j].max));
+      // Sum of squares, until the message is sent
+      msg.rms[j] = summaries[j].sumsq;
+
+      // Only a channel that reached full scale needs a search for runs
+      // of peaked samples
+      if (msg.peak[j] < MAX_AUDIO)
+         continue;
+      auto sptr = sampleData + j;
+      for(int i=0; i<numFrames; i++, sptr += numChannels) {
          // In addition to looking for mNumPeakSamplesToClip peaked
          // samples in a row, also send the number of peaked samples
          // at the head and tail, in case there's a run of peaked samples
          // that crosses block boundaries
-         if (fabs(sptr[j])>=MAX_AUDIO) {
+         if (fabs(*sptr)>=MAX_AUDIO) {
             if (msg.headPeakCount[j]==i)
                msg.headPeakCount[j]++;
             msg.tailPeakCount[j]++;
@@ -1012,12 +1045,21 @@ void MeterPanel::UpdateDisplay(
          else
             msg.tailPeakCount[j] = 0;
       }
-      sptr += numChannels;
    }
-   for(unsigned int j=0; j<mNumBars; j++)
-      msg.rms[j] = sqrt(msg.rms[j]/numFrames);
 
-   mQueue.Put(msg);
+   // Send about two messages per refresh of the display, not one for
+   // each callback
+   if (mDiscardPending.exchange(false, std::memory_order_acquire))
+      memset(&mPending, 0, sizeof(mPending));
+   CombineMessages(mPending, msg, mNumPeakSamplesToClip);
+   if (mPending.numFrames <
+       mRate / (2 * std::max<long>(1, mMeterRefreshRate)))
+      return;
+
+   for(unsigned int j=0; j<mNumBars; j++)
+      mPending.rms[j] = sqrt(mPending.rms[j]/mPending.numFrames);
+   mQueue.Put(mPending);
+   memset(&mPending, 0, sizeof(mPending));
 }
 
 // Vaughan, 2010-11-29: This not currently used. See comments in MixerTrackCluster::UpdateMeter().
@@ -16,6 +16,7 @@
 #ifndef __AUDACITY_METER_PANEL__
 #define __AUDACITY_METER_PANEL__
 
+#include <atomic>
 #include <wx/setup.h> // for wxUSE_* macros
 #include <wx/brush.h> // member variable
 #include <wx/defs.h>
@@ -71,21 +72,24 @@ class MeterUpdateMsg
    wxString toStringIfClipped();
 };
 
-// Thread-safe queue of update messages
+//! Lock-free queue of update messages, from one producer to one consumer
 class MeterUpdateQueue
 {
  public:
    explicit MeterUpdateQueue(size_t maxLen);
    ~MeterUpdateQueue();
 
-   bool Put(MeterUpdateMsg &msg);
+   //! Called only by the producer, which is the audio thread
+   bool Put(const MeterUpdateMsg &msg);
+   //! Called only by the consumer, which is the main thread
    bool Get(MeterUpdateMsg &msg);
 
+   //! Called only by the consumer; discards what was put so far
    void Clear();
 
  private:
-   int              mStart;
-   int              mEnd;
+   std::atomic<size_t> mStart{ 0 };
+   std::atomic<size_t> mEnd{ 0 };
    size_t           mBufferSize;
    ArrayOf<MeterUpdateMsg> mBuffer{mBufferSize};
 };
@@ -234,6 +238,13 @@ class TENACITY_DLL_API MeterPanel final
    MeterUpdateQueue mQueue;
    wxTimer          mTimer;
 
+   //! Sums the measurements of callbacks until there are enough frames to
+   //! send one message; used only by the audio thread.  Its rms fields hold
+   //! sums of squares.
+   MeterUpdateMsg    mPending;
+   //! Set by Reset() so that the audio thread starts mPending over
+   std::atomic<bool> mDiscardPending{ true };
+
    int       mWidth;
    int       mHeight;
 
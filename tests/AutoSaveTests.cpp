@@ -0,0 +1,150 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  AutoSaveTests.cpp
+
+*******************************************************************//**
+
+\file AutoSaveTests.cpp
+\brief Recovery from autosaves written as a checkpoint and deltas
+
+  Each test autosaves a project, copies its file as it would be left by a
+  crash, and loads the copy in another project.
+
+*//*******************************************************************/
+
+#include "UnitTests.h"
+
+#include <vector>
+
+#include <sqlite3.h>
+#include <wx/filename.h>
+
+// Tenacity libraries
+#include <lib-files/TempDirectory.h>
+#include <lib-project/Project.h>
+#include <lib-track/Track.h>
+#include <lib-utility/MemoryX.h>
+
+#include "DBConnection.h"
+#include "HeadlessProject.h"
+#include "ProjectFileIO.h"
+#include "WaveTrack.h"
+
+namespace {
+
+sqlite3 *DB(TenacityProject &project)
+{
+   return ConnectionPtr::Get(project).mpConnection->DB();
+}
+
+void Exec(TenacityProject &project, const char *sql)
+{
+   UNIT_TEST_CHECK(
+      sqlite3_exec(DB(project), sql, nullptr, nullptr, nullptr) == SQLITE_OK);
+}
+
+int64_t GetValue(TenacityProject &project, const char *sql)
+{
+   sqlite3_stmt *stmt = nullptr;
+   auto cleanup = finally([&]{ sqlite3_finalize(stmt); });
+   UNIT_TEST_CHECK(
+      sqlite3_prepare_v2(DB(project), sql, -1, &stmt, nullptr) == SQLITE_OK);
+   UNIT_TEST_CHECK(sqlite3_step(stmt) == SQLITE_ROW);
+   return sqlite3_column_int64(stmt, 0);
+}
+
+//! Copy the file of the project into the temporary directory, where the
+//! project that loads it will delete it
+wxString CopyProjectFile(TenacityProject &project, const wxString &name)
+{
+   const auto path =
+      wxFileName{ TempDirectory::TempDir(), name }.GetFullPath();
+   sqlite3 *dest = nullptr;
+   auto cleanup = finally([&]{ sqlite3_close(dest); });
+   UNIT_TEST_CHECK(sqlite3_open(path.ToUTF8(), &dest) == SQLITE_OK);
+   const auto backup = sqlite3_backup_init(dest, "main", DB(project), "main");
+   UNIT_TEST_CHECK(backup != nullptr);
+   sqlite3_backup_step(backup, -1);
+   UNIT_TEST_CHECK(sqlite3_backup_finish(backup) == SQLITE_OK);
+   return path;
+}
+
+WaveTrack &AddTrack(TenacityProject &project, const wxString &name)
+{
+   const auto track =
+      WaveTrackFactory::Get(project).NewWaveTrack(floatSample, 44100);
+   std::vector<float> samples(44100, 0.5f);
+   track->Append(
+      (constSamplePtr)samples.data(), floatSample, samples.size());
+   track->Flush();
+   track->SetName(name);
+   return *TrackList::Get(project).Add(track);
+}
+
+std::vector<wxString> TrackNames(TenacityProject &project)
+{
+   std::vector<wxString> names;
+   for (auto pTrack : TrackList::Get(project).Any<const WaveTrack>())
+      names.push_back(pTrack->GetName());
+   return names;
+}
+
+void Deltas()
+{
+   HeadlessProject project;
+   auto &projectFileIO = ProjectFileIO::Get(project.Project());
+   auto &changed = AddTrack(project.Project(), wxT("AA"));
+   AddTrack(project.Project(), wxT("XX"));
+   UNIT_TEST_CHECK(projectFileIO.AutoSave());
+
+   changed.SetName(wxT("BB"));
+   UNIT_TEST_CHECK(projectFileIO.AutoSave());
+   // Only the changed track is written again
+   UNIT_TEST_CHECK(GetValue(project.Project(),
+      "SELECT COUNT(*) FROM autosavedelta WHERE id > 0;") == 1);
+
+   HeadlessProject recovered{
+      CopyProjectFile(project.Project(), wxT("deltas.aup3")) };
+   const std::vector<wxString> expected{ wxT("BB"), wxT("XX") };
+   UNIT_TEST_CHECK(TrackNames(recovered.Project()) == expected);
+}
+
+// As if a version of the program that knows nothing of deltas replaced the
+// checkpoint with a document of the same size, leaving the deltas
+void StaleDeltas()
+{
+   HeadlessProject project;
+   auto &projectFileIO = ProjectFileIO::Get(project.Project());
+   auto &track = AddTrack(project.Project(), wxT("AA"));
+   UNIT_TEST_CHECK(projectFileIO.AutoSave());
+   const auto checkpointSize = GetValue(project.Project(),
+      "SELECT length(doc) FROM autosave WHERE id = 1;");
+
+   track.SetName(wxT("BB"));
+   UNIT_TEST_CHECK(projectFileIO.AutoSave());
+   Exec(project.Project(),
+      "CREATE TABLE main.kept AS SELECT * FROM main.autosavedelta;");
+
+   track.SetName(wxT("CC"));
+   UNIT_TEST_CHECK(projectFileIO.AutoSaveDelete());
+   UNIT_TEST_CHECK(projectFileIO.AutoSave());
+   // Otherwise the size alone would tell
+   UNIT_TEST_CHECK(checkpointSize == GetValue(project.Project(),
+      "SELECT length(doc) FROM autosave WHERE id = 1;"));
+   Exec(project.Project(),
+      "DELETE FROM main.autosavedelta;"
+      "INSERT INTO main.autosavedelta SELECT * FROM main.kept;"
+      "DROP TABLE main.kept;");
+
+   HeadlessProject recovered{
+      CopyProjectFile(project.Project(), wxT("stale.aup3")) };
+   const std::vector<wxString> expected{ wxT("CC") };
+   UNIT_TEST_CHECK(TrackNames(recovered.Project()) == expected);
+}
+
+UnitTests::Registration deltas{ "autosave.deltas", Deltas };
+UnitTests::Registration staleDeltas{ "autosave.stale", StaleDeltas };
+
+}
@@ -0,0 +1,69 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BenchmarkMain.cpp
+
+*******************************************************************//**
+
+\file BenchmarkMain.cpp
+\brief The tenacity-benchmark program
+
+  Usage:  tenacity-benchmark [--quick] [--filter PREFIX] [FILE]
+
+  Runs the benchmarks in a temporary project, and writes the results as
+  JSON to FILE, by default benchmark.json.  --quick uses little data, to
+  check that the benchmarks still work rather than to time them.  The
+  exit status is nonzero if a benchmark failed.
+
+*//*******************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#include "BenchmarkSuite.h"
+#include "HeadlessProject.h"
+
+int main(int argc, char *argv[])
+{
+   Benchmark::Options options;
+   wxString path{ wxT("benchmark.json") };
+   for (int ii = 1; ii < argc; ++ii) {
+      if (strcmp(argv[ii], "--quick") == 0) {
+         options.blockSizesKB = { 64 };
+         options.numEdits = 10;
+         options.dataSizeMB = 2;
+      }
+      else if (strcmp(argv[ii], "--filter") == 0 && ii + 1 < argc)
+         options.filter = argv[++ii];
+      else if (argv[ii][0] == '-') {
+         fprintf(stderr,
+            "Usage: %s [--quick] [--filter PREFIX] [FILE]\n", argv[0]);
+         return 2;
+      }
+      else
+         path = wxString::FromUTF8(argv[ii]);
+   }
+
+   HeadlessEnvironment environment{ wxT("tenacity-benchmark") };
+   if (!environment.IsOk()) {
+      fprintf(stderr, "Could not prepare %s\n",
+         environment.GetDirectory().utf8_str().data());
+      return 1;
+   }
+
+   try {
+      HeadlessProject project;
+      if (!Benchmark::RunToFile(project.Project(), options, path)) {
+         fprintf(stderr, "Benchmark failed; see %s\n",
+            path.utf8_str().data());
+         return 1;
+      }
+   }
+   catch (const std::exception &e) {
+      fprintf(stderr, "%s\n", e.what());
+      return 1;
+   }
+   return 0;
+}
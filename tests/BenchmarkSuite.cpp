@@ -0,0 +1,627 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BenchmarkSuite.cpp
+
+*******************************************************************//**
+
+\namespace Benchmark
+\brief Measures performance and accuracy of sample block storage, and the
+speed of mixing, resampling, FFT, spectrogram computation and effects.
+
+  The Sequence editing test repeats that of the Benchmark dialog, with
+  several block sizes.  The others time one subsystem each.  All of them
+  run without any user interface and report machine-readable results.
+
+*//*******************************************************************/
+
+
+#include "BenchmarkSuite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <locale>
+#include <random>
+#include <sstream>
+
+#include <wx/ffile.h>
+
+// Tenacity libraries
+#include <lib-exceptions/TenacityException.h>
+#include <lib-math/Dither.h>
+#include <lib-math/RealFFTf.h>
+#include <lib-math/Resample.h>
+#include <lib-preferences/Prefs.h>
+#include <lib-sample-track/Mix.h>
+#include <lib-sample-track/SampleTrackCache.h>
+
+#include "DBConnection.h"
+#include "SampleBlock.h"
+#include "SampleBlockCache.h"
+#include "Sequence.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+#include "effects/Amplify.h"
+#include "effects/BassTreble.h"
+#include "effects/Distortion.h"
+#include "effects/Phaser.h"
+#include "tracks/playabletrack/wavetrack/ui/SpectrumCache.h"
+
+namespace Benchmark {
+
+namespace {
+
+using Registry = std::vector<std::pair<std::string, Function>>;
+Registry &GetRegistry()
+{
+   static Registry registry;
+   return registry;
+}
+
+class Stopwatch
+{
+public:
+   double Seconds() const
+   {
+      return std::chrono::duration<double>(Clock::now() - mStart).count();
+   }
+private:
+   using Clock = std::chrono::steady_clock;
+   Clock::time_point mStart{ Clock::now() };
+};
+
+Floats MakeNoise(size_t len, unsigned seed)
+{
+   std::mt19937 engine{ seed };
+   std::uniform_real_distribution<float> distribution{ -0.5f, 0.5f };
+   Floats result{ len };
+   std::generate(result.get(), result.get() + len,
+      [&]{ return distribution(engine); });
+   return result;
+}
+
+std::shared_ptr<WaveTrack> MakeNoiseTrack(
+   TenacityProject &project, double rate, size_t len, unsigned seed)
+{
+   auto track =
+      WaveTrackFactory::Get(project).NewWaveTrack(floatSample, rate);
+   const auto noise = MakeNoise(len, seed);
+   track->Append((constSamplePtr)noise.get(), floatSample, len);
+   track->Flush();
+   return track;
+}
+
+std::string Name(const char *prefix, size_t n, const char *suffix)
+{
+   return prefix + std::to_string(n) + suffix;
+}
+
+// The former Benchmark dialog:  random cuts and pastes, then a check that
+// the data were permuted correctly
+void SequenceEdits(
+   TenacityProject &project, const Options &options, Results &results)
+{
+   using SampleType = short;
+   const auto format = int16Sample;
+
+   bool editClipCanMove = true;
+   gPrefs->Read(wxT("/GUI/EditClipCanMove"), &editClipCanMove);
+   gPrefs->Write(wxT("/GUI/EditClipCanMove"), false);
+
+   // Remember the old blocksize, so that we can restore it later.
+   const auto oldBlockSize = Sequence::GetMaxDiskBlockSize();
+
+   const auto cleanup = finally( [&] {
+      Sequence::SetMaxDiskBlockSize(oldBlockSize);
+      gPrefs->Write(wxT("/GUI/EditClipCanMove"), editClipCanMove);
+   } );
+
+   for (auto blockSizeKB : options.blockSizesKB) {
+      Sequence::SetMaxDiskBlockSize(blockSizeKB * 1024);
+      std::mt19937 engine{ options.randSeed };
+      const auto random = [&](uint64_t n){ return engine() % n; };
+
+      const auto t = WaveTrackFactory::Get(project).NewWaveTrack(format, 1);
+
+      uint64_t nChunks, chunkSize;
+      chunkSize = 200ull + random(100ull);
+      nChunks = (options.dataSizeMB * 1048576ull) /
+         (chunkSize * sizeof(SampleType));
+      while (nChunks < 20 || chunkSize > (blockSizeKB * 1024) / 4)
+      {
+         chunkSize = std::max( uint64_t(1), (chunkSize / 2) + random(100) );
+         nChunks = (options.dataSizeMB * 1048576ull) /
+            (chunkSize * sizeof(SampleType));
+      }
+
+      // The chunks are the pieces we move around in the test.
+      // They are (and are supposed to be) a different size to
+      // the blocks that make the sample blocks.  That way we get to
+      // do some testing of when edit chunks cross sample block boundaries.
+      using Samples = ArrayOf<SampleType>;
+      Samples small1{ nChunks };
+      Samples block{ chunkSize };
+
+      for (uint64_t i = 0; i < nChunks; i++) {
+         const SampleType v = engine();
+         small1[i] = v;
+         std::fill(block.get(), block.get() + chunkSize, v);
+         t->Append((samplePtr)block.get(), format, chunkSize);
+      }
+      t->Flush();
+
+      const auto total = nChunks * chunkSize;
+      const auto checkLength = [&]{
+         const auto len = t->GetClipByIndex(0)->GetPlaySamplesCount();
+         if (len == total)
+            return std::string{};
+         return "Expected len " + std::to_string(total) +
+            ", track len " + std::to_string(len.as_long_long());
+      };
+
+      Result edits{ Name("sequence.edit.", blockSizeKB, "k"),
+         double(options.numEdits), "edits" };
+      edits.message = checkLength();
+      edits.passed = edits.message.empty();
+
+      Stopwatch timer;
+      for (size_t z = 0; edits.passed && z < options.numEdits; z++) {
+         // First chunk to cut
+         // 0 <= x0 < nChunks
+         const uint64_t x0 = random(nChunks);
+
+         // Number of chunks to cut
+         // 1 <= xlen <= nChunks - x0
+         const uint64_t xlen = 1 + random(nChunks - x0);
+
+         // Position to paste
+         // 0 <= y0 <= nChunks - xlen
+         const uint64_t y0 = random(nChunks - xlen + 1);
+
+         try {
+            auto tmp = t->Cut(double (x0 * chunkSize),
+               double ((x0 + xlen) * chunkSize));
+            t->Paste((double)(y0 * chunkSize), tmp.get());
+         }
+         catch (const TenacityException&) {
+            edits.passed = false;
+            edits.message = "Cut or paste failed in trial " +
+               std::to_string(z);
+            break;
+         }
+
+         edits.message = checkLength();
+         edits.passed = edits.message.empty();
+
+         // Permute small1 correspondingly to the cut and paste
+         auto first = &small1[0];
+         if (x0 + xlen < nChunks)
+            std::rotate( first + x0, first + x0 + xlen, first + nChunks );
+         std::rotate( first + y0, first + nChunks - xlen, first + nChunks );
+      }
+      edits.seconds = timer.Seconds();
+      const bool edited = edits.passed;
+      results.push_back(std::move(edits));
+      if (!edited)
+         continue;
+
+      // Correctness check, timing the reads
+      Result reads{ Name("sequence.read.", blockSizeKB, "k"),
+         double(total), "samples" };
+      uint64_t bad = 0;
+      Stopwatch readTimer;
+      for (uint64_t i = 0; i < nChunks; i++) {
+         const auto v = small1[i];
+         t->Get((samplePtr)block.get(), format, i * chunkSize, chunkSize);
+         if (std::any_of(block.get(), block.get() + chunkSize,
+            [v](SampleType s){ return s != v; }))
+            bad++;
+      }
+      reads.seconds = readTimer.Seconds();
+      if (bad > 0) {
+         reads.passed = false;
+         reads.message = "Errors in " + std::to_string(bad) + "/" +
+            std::to_string(nChunks) + " chunks";
+      }
+      results.push_back(std::move(reads));
+   }
+}
+
+// Writing and reading blocks through the project's SampleBlockFactory
+void SampleBlocks(
+   TenacityProject &project, const Options &options, Results &results)
+{
+   const auto pFactory = SampleBlockFactory::New(project);
+   const size_t blockLen = 256 * 1024 / sizeof(float);
+   const size_t nBlocks =
+      std::max<size_t>(1, options.dataSizeMB * 1048576 / (blockLen * 4));
+   const auto noise = MakeNoise(blockLen, options.randSeed);
+   const double total = double(nBlocks) * blockLen;
+
+   std::vector<SampleBlockPtr> blocks;
+   {
+      Result write{ "sampleblock.write", total, "samples" };
+      Stopwatch timer;
+      for (size_t ii = 0; ii < nBlocks; ++ii)
+         blocks.push_back(pFactory->Create(
+            (constSamplePtr)noise.get(), blockLen, floatSample));
+      write.seconds = timer.Seconds();
+      results.push_back(std::move(write));
+   }
+
+   Floats buffer{ blockLen * nBlocks };
+   const auto check = [&](Result &result){
+      for (size_t ii = 0; ii < nBlocks; ++ii)
+         if (!std::equal(noise.get(), noise.get() + blockLen,
+            buffer.get() + ii * blockLen)) {
+            result.passed = false;
+            result.message = "Wrong samples in block " + std::to_string(ii);
+            return;
+         }
+   };
+
+   auto &cache = SampleBlockCache::Get();
+   const auto readEach = [&](const char *name, bool cold){
+      if (cold)
+         cache.Clear();
+      Result read{ name, total, "samples" };
+      Stopwatch timer;
+      for (size_t ii = 0; ii < nBlocks; ++ii)
+         blocks[ii]->GetSamples((samplePtr)(buffer.get() + ii * blockLen),
+            floatSample, 0, blockLen);
+      read.seconds = timer.Seconds();
+      check(read);
+      results.push_back(std::move(read));
+   };
+   readEach("sampleblock.read.cold", true);
+   readEach("sampleblock.read.warm", false);
+
+   {
+      cache.Clear();
+      Result read{ "sampleblock.read.batched", total, "samples" };
+      SampleBlockReads reads;
+      for (size_t ii = 0; ii < nBlocks; ++ii)
+         reads.push_back({ blocks[ii].get(), 0, blockLen,
+            (samplePtr)(buffer.get() + ii * blockLen) });
+      Stopwatch timer;
+      pFactory->GetSamples(reads, floatSample);
+      read.seconds = timer.Seconds();
+      check(read);
+      results.push_back(std::move(read));
+   }
+}
+
+// Reading a long track from the project file as playback and export do, in
+// each mode of the connection.  The file is likely in the cache of the
+// operating system either way, so this measures the cost in SQLite.
+void ProjectReads(
+   TenacityProject &project, const Options &options, Results &results)
+{
+   auto &pConnection = ConnectionPtr::Get(project).mpConnection;
+   if (!pConnection)
+      return;
+
+   const double rate = 44100;
+   const size_t len = options.dataSizeMB * 1048576 / sizeof(float);
+   const double megabytes = double(len) * sizeof(float) / 1048576;
+   const auto track = MakeNoiseTrack(project, rate, len, options.randSeed);
+
+   const auto wasHighThroughput = ProjectHighThroughput.Read();
+   const auto cleanup = finally([&]{
+      pConnection->ThroughputMode(wasHighThroughput); });
+
+   const size_t chunk = 16384;
+   Floats buffer{ chunk };
+   auto &cache = SampleBlockCache::Get();
+   for (bool highThroughput : { false, true }) {
+      const std::string mode = highThroughput ? "mmap" : "default";
+      if (pConnection->ThroughputMode(highThroughput) != 0) {
+         Result result{ "project.read." + mode, 0, "MB" };
+         result.passed = false;
+         result.message = "Could not set the connection mode";
+         results.push_back(std::move(result));
+         continue;
+      }
+
+      {
+         // Consecutive short reads, like the playback thread's
+         cache.Clear();
+         Result result{ "project.read.playback." + mode, megabytes, "MB" };
+         Stopwatch timer;
+         for (size_t pos = 0; pos < len; pos += chunk)
+            track->GetFloats(buffer.get(), pos, std::min(chunk, len - pos));
+         result.seconds = timer.Seconds();
+         results.push_back(std::move(result));
+      }
+
+      {
+         // Mixing down, like export
+         cache.Clear();
+         Result result{ "project.read.export." + mode, megabytes, "MB" };
+         Mixer mixer{ SampleTrackConstArray{ track }, true,
+            Mixer::WarpOptions{ nullptr },
+            0, track->GetEndTime(), 2, chunk, true, rate, floatSample };
+         Stopwatch timer;
+         while (mixer.Process(chunk))
+            ;
+         result.seconds = timer.Seconds();
+         results.push_back(std::move(result));
+      }
+   }
+}
+
+// Mixing many tracks at two sample rates, serially and in parallel
+void Mixing(TenacityProject &project, const Options &options, Results &results)
+{
+   const size_t nTracks = 16;
+   const double seconds = 10;
+   const double outRate = 44100;
+
+   SampleTrackConstArray tracks;
+   for (size_t ii = 0; ii < nTracks; ++ii) {
+      const double rate = (ii % 2) ? 48000 : 44100;
+      tracks.push_back(MakeNoiseTrack(project, rate, seconds * rate,
+         options.randSeed + ii));
+   }
+
+   const auto wasParallel = ParallelMixing.Read();
+   const auto cleanup = finally([&]{ ParallelMixing.Write(wasParallel); });
+
+   for (bool parallel : { false, true }) {
+      ParallelMixing.Write(parallel);
+      Result result{ parallel ? "mixer.process.parallel" : "mixer.process.serial",
+         0, "frames" };
+      Mixer mixer{ tracks, true, Mixer::WarpOptions{ nullptr },
+         0, seconds, 2, 4096, true, outRate, floatSample };
+      Stopwatch timer;
+      while (auto count = mixer.Process(4096))
+         result.count += count;
+      result.seconds = timer.Seconds();
+      results.push_back(std::move(result));
+   }
+}
+
+void Resampling(TenacityProject &, const Options &options, Results &results)
+{
+   const double inRate = 44100, outRate = 48000;
+   const double factor = outRate / inRate;
+   const size_t len = 60 * inRate;
+   const size_t chunk = 65536;
+   const auto noise = MakeNoise(len, options.randSeed);
+   Floats out{ size_t(chunk * factor) + 16 };
+
+   for (bool best : { false, true }) {
+      Result result{ best ? "resample.process.best" : "resample.process.fast",
+         double(len), "samples" };
+      Resample resample{ best, factor, factor };
+      Stopwatch timer;
+      for (size_t pos = 0; pos < len;) {
+         const auto n = std::min(chunk, len - pos);
+         const bool last = (pos + n == len);
+         const auto used = resample.Process(factor, &noise[pos], n, last,
+            out.get(), chunk * factor).first;
+         pos += last ? n : used;
+      }
+      result.seconds = timer.Seconds();
+      results.push_back(std::move(result));
+   }
+}
+
+void FFT(TenacityProject &, const Options &options, Results &results)
+{
+   const size_t total = 1 << 24;
+   for (size_t size : { 1024, 4096 }) {
+      auto hFFT = GetFFT(size);
+      const auto noise = MakeNoise(size, options.randSeed);
+      Floats buffer{ size };
+      Result result{ Name("fft.real.", size, ""), double(total), "samples" };
+      Stopwatch timer;
+      for (size_t done = 0; done < total; done += size) {
+         std::copy(noise.get(), noise.get() + size, buffer.get());
+         RealFFTf(buffer.get(), hFFT.get());
+      }
+      result.seconds = timer.Seconds();
+      results.push_back(std::move(result));
+
+      // The same transforms, a batch at a time on the thread pool
+      const size_t batch = 64;
+      Floats buffers{ batch * size };
+      Result batchResult{
+         Name("fft.real.batch.", size, ""), double(total), "samples" };
+      Stopwatch batchTimer;
+      for (size_t done = 0; done < total; done += batch * size) {
+         for (size_t ii = 0; ii < batch; ++ii)
+            std::copy(noise.get(), noise.get() + size, &buffers[ii * size]);
+         RealFFTfBatch(buffers.get(), batch, hFFT.get());
+      }
+      batchResult.seconds = batchTimer.Seconds();
+      results.push_back(std::move(batchResult));
+   }
+}
+
+// Complete recomputation of the spectrogram of a clip, as when zooming
+void Spectrogram(
+   TenacityProject &project, const Options &options, Results &results)
+{
+   const double rate = 44100, seconds = 30;
+   const size_t numPixels = 2000;
+   const int repeats = 5;
+   const auto track =
+      MakeNoiseTrack(project, rate, seconds * rate, options.randSeed);
+   const auto &clip = *track->GetClipByIndex(0);
+   SampleTrackCache cache{ track };
+   auto &spectrumCache = WaveClipSpectrumCache::Get(clip);
+
+   Result result{ "spectrogram.populate", double(numPixels * repeats),
+      "columns" };
+   Stopwatch timer;
+   for (int ii = 0; ii < repeats; ++ii) {
+      spectrumCache.Invalidate();
+      const float *spectrogram{};
+      const sampleCount *where{};
+      spectrumCache.GetSpectrogram(clip, cache, spectrogram, where,
+         numPixels, 0, numPixels / seconds);
+   }
+   result.seconds = timer.Seconds();
+   results.push_back(std::move(result));
+}
+
+void EffectBlocks(TenacityProject &, const Options &options, Results &results)
+{
+   const double rate = 44100;
+   const size_t len = 60 * rate;
+   const size_t blockLen = 4096;
+   const auto noise = MakeNoise(len, options.randSeed);
+   Floats out{ blockLen };
+
+   std::pair<const char *, std::unique_ptr<Effect>> effects[] {
+      { "effect.amplify", std::make_unique<EffectAmplify>() },
+      { "effect.basstreble", std::make_unique<EffectBassTreble>() },
+      { "effect.distortion", std::make_unique<EffectDistortion>() },
+      { "effect.phaser", std::make_unique<EffectPhaser>() },
+   };
+   for (auto &[name, pEffect] : effects) {
+      Result result{ name, double(len), "samples" };
+      pEffect->SetSampleRate(rate);
+      Stopwatch timer;
+      pEffect->ProcessInitialize(len);
+      for (size_t pos = 0; pos < len; pos += blockLen) {
+         float *in[]{ &noise[pos] };
+         float *outs[]{ out.get() };
+         pEffect->ProcessBlock(in, outs, std::min(blockLen, len - pos));
+      }
+      pEffect->ProcessFinalize();
+      result.seconds = timer.Seconds();
+      results.push_back(std::move(result));
+   }
+}
+
+void Conversion(TenacityProject &, const Options &options, Results &results)
+{
+   const size_t len = 1 << 22;
+   const auto noise = MakeNoise(len, options.randSeed);
+   SampleBuffer shorts{ len, int16Sample };
+   Floats floats{ len };
+
+   const std::pair<const char *, DitherType> dithers[] {
+      { "convert.float-int16.none", DitherType::none },
+      { "convert.float-int16.triangle", DitherType::triangle },
+      { "convert.float-int16.shaped", DitherType::shaped },
+   };
+   for (auto [name, dither] : dithers) {
+      Result result{ name, double(len), "samples" };
+      Stopwatch timer;
+      CopySamples((constSamplePtr)noise.get(), floatSample,
+         shorts.ptr(), int16Sample, len, dither);
+      result.seconds = timer.Seconds();
+      results.push_back(std::move(result));
+   }
+
+   Result result{ "convert.int16-float", double(len), "samples" };
+   Stopwatch timer;
+   SamplesToFloats(shorts.ptr(), int16Sample, floats.get(), len);
+   result.seconds = timer.Seconds();
+   results.push_back(std::move(result));
+}
+
+Registration sequence{ "sequence", SequenceEdits };
+Registration sampleBlocks{ "sampleblock", SampleBlocks };
+Registration projectReads{ "project", ProjectReads };
+Registration mixer{ "mixer", Mixing };
+Registration resample{ "resample", Resampling };
+Registration fft{ "fft", FFT };
+Registration spectrogram{ "spectrogram", Spectrogram };
+Registration effect{ "effect", EffectBlocks };
+Registration convert{ "convert", Conversion };
+
+void WriteString(std::ostream &out, const std::string &str)
+{
+   out << '"';
+   for (unsigned char c : str) {
+      if (c == '"' || c == '\\')
+         out << '\\' << c;
+      else if (c < 0x20) {
+         static const char hex[] = "0123456789abcdef";
+         out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+      }
+      else
+         out << c;
+   }
+   out << '"';
+}
+
+}
+
+Registration::Registration(const std::string &name, const Function &function)
+{
+   GetRegistry().emplace_back(name, function);
+}
+
+Results Run(TenacityProject &project, const Options &options,
+   const std::function<void(const Results &)> &progress)
+{
+   Results results;
+   for (auto &[name, function] : GetRegistry()) {
+      if (name.compare(0, options.filter.size(), options.filter) != 0)
+         continue;
+      try {
+         function(project, options, results);
+      }
+      catch (const std::exception &e) {
+         results.push_back({ name, 0, {}, 0, false, e.what() });
+      }
+      catch (...) {
+         results.push_back({ name, 0, {}, 0, false, "Exception" });
+      }
+      if (progress)
+         progress(results);
+   }
+   return results;
+}
+
+std::string ToJSON(const Results &results)
+{
+   std::ostringstream out;
+   out.imbue(std::locale::classic());
+   out << "{\n  \"version\": ";
+   WriteString(out, wxString{ TENACITY_VERSION_STRING }.ToStdString());
+   out << ",\n  \"results\": [";
+   const char *separator = "\n";
+   for (auto &result : results) {
+      out << separator << "    { \"name\": ";
+      WriteString(out, result.name);
+      out << ", \"count\": " << result.count
+          << ", \"unit\": ";
+      WriteString(out, result.unit);
+      out << ", \"seconds\": " << result.seconds
+          << ", \"rate\": "
+          << (result.seconds > 0 ? result.count / result.seconds : 0)
+          << ", \"passed\": " << (result.passed ? "true" : "false");
+      if (!result.message.empty()) {
+         out << ", \"message\": ";
+         WriteString(out, result.message);
+      }
+      out << " }";
+      separator = ",\n";
+   }
+   out << "\n  ]\n}\n";
+   return out.str();
+}
+
+bool RunToFile(TenacityProject &project,
+   const Options &options, const wxString &path)
+{
+   const auto results = Run(project, options);
+   const auto json = ToJSON(results);
+
+   wxFFile file{ path, wxT("wb") };
+   if (!file.IsOpened() || !file.Write(json.data(), json.size()) ||
+       !file.Close())
+      return false;
+
+   return std::all_of(results.begin(), results.end(),
+      [](const Result &result){ return result.passed; });
+}
+
+}
@@ -0,0 +1,81 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BenchmarkSuite.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_BENCHMARK_SUITE__
+#define __AUDACITY_BENCHMARK_SUITE__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class wxString;
+class TenacityProject;
+
+//! Timing of storage, mixing, and signal processing, without any user interface
+/*!
+ Each benchmark is a function that measures one subsystem and reports one
+ or more Results.  Results are written as JSON, so that runs of different
+ builds can be compared mechanically.  They run in the tenacity-benchmark
+ program, in a temporary project.
+ */
+namespace Benchmark {
+
+struct Options {
+   //! Disk block sizes in KB at which to time Sequence edits and reads
+   std::vector<size_t> blockSizesKB{ 64, 256, 1024 };
+   size_t numEdits{ 100 };
+   //! Size in MB of the data for Sequence edits
+   size_t dataSizeMB{ 32 };
+   unsigned randSeed{ 234657 };
+   //! If not empty, run only the benchmarks whose names begin with this
+   std::string filter;
+};
+
+struct Result {
+   //! Dot separated, the first component being the name of the benchmark
+   std::string name;
+   //! Number of units of work done in the measured time
+   double count{ 0 };
+   //! What the work items are, such as "samples" or "edits"
+   std::string unit;
+   double seconds{ 0 };
+   //! False if the benchmark also checked its results and they were wrong
+   bool passed{ true };
+   std::string message;
+};
+using Results = std::vector<Result>;
+
+using Function = std::function<
+   void(TenacityProject &project, const Options &options, Results &results)
+>;
+
+//! Statically constructed instances add benchmarks to the suite
+struct Registration {
+   Registration(const std::string &name, const Function &function);
+};
+
+//! Run the benchmarks in the order of registration
+/*!
+ An exception escaping a benchmark is reported as a failed result, and the
+ others still run.
+ @param progress if not null, called after each benchmark
+ */
+Results Run(TenacityProject &project,
+   const Options &options,
+   const std::function<void(const Results &)> &progress = {});
+
+std::string ToJSON(const Results &results);
+
+//! Run all benchmarks and write the JSON to a file
+/*! @return whether the file was written and all results passed */
+bool RunToFile(TenacityProject &project,
+   const Options &options, const wxString &path);
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  EffectTests.cpp
+
+*******************************************************************//**
+
+\file EffectTests.cpp
+\brief Effects that process tracks in parallel, which must give what
+  processing them one by one gives
+
+*//*******************************************************************/
+
+#include "UnitTests.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Tenacity libraries
+#include <lib-project/Project.h>
+#include <lib-screen-geometry/ViewInfo.h>
+#include <lib-track/Track.h>
+
+#include "HeadlessProject.h"
+#include "WaveTrack.h"
+#include "effects/Amplify.h"
+
+namespace {
+
+constexpr double rate = 44100;
+constexpr size_t len = 44100;
+
+//! Tracks of the same samples, whose peak is no round number
+void AddTracks(TenacityProject &project, size_t nTracks)
+{
+   std::vector<float> samples(len);
+   for (size_t ii = 0; ii < len; ++ii)
+      samples[ii] = 0.7f * std::sin(ii * 0.01);
+   while (nTracks--) {
+      const auto track =
+         WaveTrackFactory::Get(project).NewWaveTrack(floatSample, rate);
+      track->Append((constSamplePtr)samples.data(), floatSample, len);
+      track->Flush();
+      track->SetSelected(true);
+      TrackList::Get(project).Add(track);
+   }
+}
+
+std::vector<std::vector<float>> GetSamples(TenacityProject &project)
+{
+   std::vector<std::vector<float>> result;
+   for (auto pTrack : TrackList::Get(project).Any<const WaveTrack>()) {
+      result.emplace_back(len);
+      pTrack->GetFloats(result.back().data(), 0, len);
+   }
+   return result;
+}
+
+//! Amplify to the peak, as the dialog proposes
+void AmplifyToPeak(TenacityProject &project)
+{
+   EffectAmplify effect;
+   UNIT_TEST_CHECK(effect.Startup(nullptr));
+   NotifyingSelectedRegion region;
+   region.setTimes(0.0, len / rate);
+   const auto apply = [&]{
+      UNIT_TEST_CHECK(effect.DoEffect(rate, &TrackList::Get(project),
+         &WaveTrackFactory::Get(project), region, 0, nullptr, {}));
+   };
+
+   // Applying once gives the effect the tracks, whose peak the defaults
+   // then find, making a ratio that is no float
+   apply();
+   UNIT_TEST_CHECK(effect.LoadFactoryDefaults());
+   apply();
+}
+
+void ParallelAmplify()
+{
+   // One track is processed by the effect itself; more, by processors
+   // that MakeProcessor() gives to the thread pool, if it has threads
+   HeadlessProject serial;
+   AddTracks(serial.Project(), 1);
+   AmplifyToPeak(serial.Project());
+   const auto expected = GetSamples(serial.Project());
+   UNIT_TEST_CHECK(expected.size() == 1);
+
+   HeadlessProject parallel;
+   AddTracks(parallel.Project(), 4);
+   AmplifyToPeak(parallel.Project());
+   const auto results = GetSamples(parallel.Project());
+   UNIT_TEST_CHECK(results.size() == 4);
+   for (const auto &samples : results)
+      UNIT_TEST_CHECK(std::memcmp(samples.data(), expected[0].data(),
+         len * sizeof(float)) == 0);
+}
+
+UnitTests::Registration parallelAmplify{
+   "effect.parallel", ParallelAmplify };
+
+}
@@ -0,0 +1,134 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ExportMultipleTests.cpp
+
+*******************************************************************//**
+
+\file ExportMultipleTests.cpp
+\brief Names and outcomes of files exported at once, as by labels or
+  tracks
+
+*//*******************************************************************/
+
+#include "UnitTests.h"
+
+#include <cstdio>
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+// Tenacity libraries
+#include <lib-files/TempDirectory.h>
+
+#include "export/ExportMultiple.h"
+
+namespace {
+
+//! Names for a batch of files all wanting the same name
+std::vector<wxFileName> ChooseBatch(
+   const wxFileName &name, size_t count, bool overwrite)
+{
+   std::vector<wxFileName> reserved;
+   for (size_t ii = 0; ii < count; ++ii)
+      reserved.push_back(
+         ExportMultipleDialog::ChooseDestination(name, overwrite, reserved));
+   return reserved;
+}
+
+wxFileName Named(const wxFileName &name, const wxString &newName)
+{
+   auto result = name;
+   result.SetName(newName);
+   return result;
+}
+
+void DuplicateNames()
+{
+   const wxFileName dir{ TempDirectory::TempDir(), wxEmptyString };
+   UNIT_TEST_CHECK(dir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL));
+   const wxFileName name{ dir.GetPath(), wxT("label.wav") };
+
+   for (bool overwrite : { false, true }) {
+      const std::vector<wxFileName> expected{
+         name, Named(name, wxT("label-2")), Named(name, wxT("label-3")) };
+      UNIT_TEST_CHECK(ChooseBatch(name, 3, overwrite) == expected);
+   }
+
+   // A file from an earlier export
+   UNIT_TEST_CHECK(wxFFile{ name.GetFullPath(), wxT("w") }.IsOpened());
+   {
+      const std::vector<wxFileName> expected{
+         Named(name, wxT("label-2")), Named(name, wxT("label-3")) };
+      UNIT_TEST_CHECK(ChooseBatch(name, 2, false) == expected);
+   }
+   {
+      // Only the first of the batch replaces it
+      const std::vector<wxFileName> expected{
+         name, Named(name, wxT("label-2")) };
+      UNIT_TEST_CHECK(ChooseBatch(name, 2, true) == expected);
+   }
+   wxRemoveFile(name.GetFullPath());
+}
+
+//! Writes a few bytes, failing as the plug-ins do when it cannot
+class TestExportPlugin final : public ExportPlugin
+{
+public:
+   void OptionsCreate(ShuttleGui &, int) override {}
+
+   ProgressResult Export(TenacityProject *,
+      std::unique_ptr<ProgressDialog> &, unsigned, const wxFileNameWrapper &fName,
+      bool, double, double, MixerSpec *, const Tags *, int) override
+   {
+      const auto file = std::fopen(fName.GetFullPath().ToUTF8(), "wb");
+      if (!file) {
+         ReportError([]{});
+         return ProgressResult::Cancelled;
+      }
+      std::fputs("data", file);
+      std::fclose(file);
+      return ProgressResult::Success;
+   }
+};
+
+void UnwritableTarget()
+{
+   const wxFileName dir{ TempDirectory::TempDir(), wxEmptyString };
+   UNIT_TEST_CHECK(dir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL));
+   wxFileName missingDir{ dir };
+   missingDir.AppendDir(wxT("missing"));
+
+   std::vector<ExportMultipleDialog::ConcurrentFile> files;
+   for (const auto &target : {
+      wxFileName{ dir.GetPath(), wxT("first.wav") },
+      wxFileName{ missingDir.GetPath(), wxT("second.wav") },
+      wxFileName{ dir.GetPath(), wxT("third.wav") } }) {
+      files.push_back({ 1, target, 0.0, 1.0, {}, {}, target, {} });
+   }
+
+   TestExportPlugin plugin;
+   FilePaths exported, failed;
+   const auto result = ExportMultipleDialog::ExportConcurrently(
+      plugin, nullptr, 0, files, 2,
+      [](double, const wxString &){ return GenericUI::ProgressResult::Success; },
+      exported, failed);
+
+   UNIT_TEST_CHECK(result == GenericUI::ProgressResult::Failed);
+   const FilePaths expectedExported{
+      files[0].target.GetFullPath(), files[2].target.GetFullPath() };
+   UNIT_TEST_CHECK(exported == expectedExported);
+   const FilePaths expectedFailed{ files[1].target.GetFullPath() };
+   UNIT_TEST_CHECK(failed == expectedFailed);
+
+   for (const auto &path : exported)
+      wxRemoveFile(path);
+}
+
+UnitTests::Registration duplicateNames{ "export.names", DuplicateNames };
+UnitTests::Registration unwritableTarget{
+   "export.failures", UnwritableTarget };
+
+}
@@ -0,0 +1,112 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  HeadlessProject.cpp
+
+*******************************************************************//**
+
+\class HeadlessProject
+\brief A project with no window, in a temporary .aup3 file
+
+  Unlike InvisibleTemporaryProject, this needs no wxApp:  the headless
+  programs never initialize the windowing toolkit, and dispatch delayed
+  actions with GenericUI::Yield().
+
+*//*******************************************************************/
+
+#include "HeadlessProject.h"
+
+#include <stdexcept>
+
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+// Tenacity libraries
+#include <lib-basic-ui/BasicUI.h>
+#include <lib-files/FileNames.h>
+#include <lib-files/TempDirectory.h>
+#include <lib-preferences/FileConfig.h>
+#include <lib-preferences/Prefs.h>
+#include <lib-project/Project.h>
+#include <lib-track/Track.h>
+
+#include "ProjectFileIO.h"
+#include "UndoManager.h"
+
+namespace {
+
+class HeadlessConfig final : public FileConfig
+{
+public:
+   explicit HeadlessConfig(const wxString &path)
+   : FileConfig{ {}, {}, path, {}, wxCONFIG_USE_LOCAL_FILE }
+   {}
+
+protected:
+   // No one to ask; failures to write show up in the results instead
+   void Warn() override {}
+};
+
+}
+
+HeadlessEnvironment::HeadlessEnvironment(const wxString &name)
+{
+   wxFileName dir{ wxFileName::GetTempDir(), wxEmptyString };
+   dir.AppendDir(wxString::Format(wxT("%s-%lu"), name, wxGetProcessId()));
+   mDirectory = dir.GetPath();
+   if (!dir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+      return;
+
+   auto pConfig = std::make_unique<HeadlessConfig>(
+      wxFileName{ mDirectory, wxT("tenacity.cfg") }.GetFullPath());
+   pConfig->Init();
+   InitPreferences(std::move(pConfig));
+
+   const auto tempDir = wxFileName{ mDirectory, wxT("SessionData") };
+   gPrefs->Write(PreferenceKey(FileNames::Operation::Temp,
+      FileNames::PathType::_None), tempDir.GetFullPath());
+   TempDirectory::ResetTempDir();
+
+   mOk = ProjectFileIO::InitializeSQL();
+}
+
+HeadlessEnvironment::~HeadlessEnvironment()
+{
+   GenericUI::Yield();
+   FinishPreferences();
+   if (!mDirectory.empty())
+      wxFileName::Rmdir(mDirectory, wxPATH_RMDIR_RECURSIVE);
+}
+
+HeadlessProject::HeadlessProject()
+   : mpProject{ std::make_shared<TenacityProject>() }
+{
+   auto &projectFileIO = ProjectFileIO::Get(*mpProject);
+   if (!projectFileIO.OpenProject())
+      throw std::runtime_error{
+         projectFileIO.GetLastError().Translation().ToStdString() };
+}
+
+HeadlessProject::HeadlessProject(const wxString &fileName)
+   : mpProject{ std::make_shared<TenacityProject>() }
+{
+   auto &projectFileIO = ProjectFileIO::Get(*mpProject);
+   if (!projectFileIO.LoadProject(fileName, false))
+      throw std::runtime_error{
+         projectFileIO.GetLastError().Translation().ToStdString() };
+}
+
+HeadlessProject::~HeadlessProject()
+{
+   auto &projectFileIO = ProjectFileIO::Get(*mpProject);
+   projectFileIO.SetBypass();
+   UndoManager::Get(*mpProject).ClearStates();
+   TrackList::Get(*mpProject).Clear();
+   GenericUI::Yield();
+
+   // Removes the file, because it is temporary
+   projectFileIO.CloseProject();
+   mpProject.reset();
+   GenericUI::Yield();
+}
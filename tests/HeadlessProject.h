@@ -0,0 +1,65 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  HeadlessProject.h
+  @brief What the headless programs need of the application, short of its
+  windows
+
+**********************************************************************/
+
+#ifndef __AUDACITY_HEADLESS_PROJECT__
+#define __AUDACITY_HEADLESS_PROJECT__
+
+#include <memory>
+
+#include <wx/string.h>
+
+class TenacityProject;
+
+//! Preferences and temporary files in a new directory, and SQLite
+/*!
+ Nothing is read from or written to the preferences or the temporary
+ directory of the application.  The destructor removes the directory.
+ */
+class HeadlessEnvironment final
+{
+public:
+   //! @param name distinguishes the directory
+   explicit HeadlessEnvironment(const wxString &name);
+   ~HeadlessEnvironment();
+   HeadlessEnvironment(const HeadlessEnvironment &) = delete;
+   HeadlessEnvironment &operator=(const HeadlessEnvironment &) = delete;
+
+   bool IsOk() const { return mOk; }
+   const wxString &GetDirectory() const { return mDirectory; }
+
+private:
+   wxString mDirectory;
+   bool mOk{ false };
+};
+
+//! A project with no window, in a temporary .aup3 file
+/*!
+ The file is deleted with the project, as for an unsaved project of the
+ application.  Requires a HeadlessEnvironment.
+ */
+class HeadlessProject final
+{
+public:
+   //! @throws std::runtime_error if the file can't be made
+   HeadlessProject();
+   //! Load a file, as after a crash, recovering from any autosave in it
+   /*! @throws std::runtime_error if the file can't be loaded */
+   explicit HeadlessProject(const wxString &fileName);
+   ~HeadlessProject();
+   HeadlessProject(const HeadlessProject &) = delete;
+   HeadlessProject &operator=(const HeadlessProject &) = delete;
+
+   TenacityProject &Project() { return *mpProject; }
+
+private:
+   std::shared_ptr<TenacityProject> mpProject;
+};
+
+#endif
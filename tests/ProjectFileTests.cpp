@@ -0,0 +1,83 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ProjectFileTests.cpp
+
+*******************************************************************//**
+
+\file ProjectFileTests.cpp
+\brief What copies of project files keep, besides the samples and the
+  document
+
+*//*******************************************************************/
+
+#include "UnitTests.h"
+
+#include <string>
+#include <vector>
+
+#include <wx/filename.h>
+
+// Tenacity libraries
+#include <lib-files/TempDirectory.h>
+#include <lib-project/Project.h>
+#include <lib-track/Track.h>
+
+#include "HeadlessProject.h"
+#include "ProjectFileIO.h"
+#include "SampleBlock.h"
+#include "Sequence.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+
+namespace {
+
+const std::string key{ "test/derived" };
+
+const WaveTrack &GetTrack(TenacityProject &project)
+{
+   return **TrackList::Get(project).Any<const WaveTrack>().begin();
+}
+
+const SampleBlock &GetFirstBlock(const WaveTrack &track)
+{
+   return *track.GetClips()[0]->GetSequence()->GetBlockArray()[0].sb;
+}
+
+void DerivedData()
+{
+   HeadlessProject project;
+   const auto track =
+      WaveTrackFactory::Get(project.Project()).NewWaveTrack(floatSample, 44100);
+   std::vector<float> samples(44100, 0.5f);
+   track->Append(
+      (constSamplePtr)samples.data(), floatSample, samples.size());
+   track->Flush();
+   TrackList::Get(project.Project()).Add(track);
+
+   const std::vector<char> stored{ 'a', 'b', 'c' };
+   const auto &pFactory = track->GetSampleBlockFactory();
+   UNIT_TEST_CHECK(pFactory->EnableDerivedData());
+   UNIT_TEST_CHECK(pFactory->StoreDerivedData(
+      GetFirstBlock(*track), key, stored.data(), stored.size()));
+
+   // Copy as for Save As, into the directory from which the project that
+   // loads it will delete it
+   const auto path = wxFileName{
+      TempDirectory::TempDir(), wxT("derived.aup3") }.GetFullPath();
+   UNIT_TEST_CHECK(ProjectFileIO::Get(project.Project()).SaveCopy(path));
+
+   HeadlessProject copy{ path };
+   const auto &copied = GetTrack(copy.Project());
+   const auto &pCopyFactory = copied.GetSampleBlockFactory();
+   std::vector<char> loaded;
+   UNIT_TEST_CHECK(pCopyFactory->EnableDerivedData());
+   UNIT_TEST_CHECK(pCopyFactory->LoadDerivedData(
+      GetFirstBlock(copied), key, loaded));
+   UNIT_TEST_CHECK(loaded == stored);
+}
+
+UnitTests::Registration derivedData{ "project.derived", DerivedData };
+
+}
@@ -0,0 +1,93 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SequenceSummaryTests.cpp
+
+*******************************************************************//**
+
+\file SequenceSummaryTests.cpp
+\brief Summaries of runs of blocks, after edits that replace one block
+  in place
+
+*//*******************************************************************/
+
+#include "UnitTests.h"
+
+#include <cmath>
+#include <vector>
+
+// Tenacity libraries
+#include <lib-utility/MemoryX.h>
+
+#include "HeadlessProject.h"
+#include "SampleBlock.h"
+#include "Sequence.h"
+
+namespace {
+
+//! Compare the summaries the sequence keeps with ones made afresh
+void CheckSummaries(const Sequence &sequence)
+{
+   const auto &blocks = sequence.GetBlockArray();
+   const auto nBlocks = blocks.size();
+   for (auto [b0, b1] : { std::pair<size_t, size_t>{ 0, nBlocks },
+         { 1, nBlocks - 1 }, { 1, 2 } }) {
+      const auto kept = sequence.SummarizeBlocks(b0, b1);
+      SummaryPyramid fresh;
+      const auto expected = fresh.Summarize(blocks, b0, b1);
+      UNIT_TEST_CHECK(kept.min == expected.min);
+      UNIT_TEST_CHECK(kept.max == expected.max);
+      UNIT_TEST_CHECK(kept.sumsq == expected.sumsq);
+      UNIT_TEST_CHECK(kept.samples == expected.samples);
+   }
+
+   // And with the samples
+   const auto [min, max] =
+      sequence.GetMinMax(0, sequence.GetNumSamples(), true);
+   const auto kept = sequence.SummarizeBlocks(0, nBlocks);
+   UNIT_TEST_CHECK(kept.min == min);
+   UNIT_TEST_CHECK(kept.max == max);
+}
+
+void EditInPlace()
+{
+   HeadlessProject project;
+   const auto oldBlockSize = Sequence::GetMaxDiskBlockSize();
+   const auto cleanup = finally( [&] {
+      Sequence::SetMaxDiskBlockSize(oldBlockSize);
+   } );
+   Sequence::SetMaxDiskBlockSize(64 * 1024);
+
+   const auto pFactory = SampleBlockFactory::New(project.Project());
+   Sequence sequence{ pFactory, floatSample };
+   const auto blockSize = sequence.GetMaxBlockSize();
+   const size_t nBlocks = 8;
+   std::vector<float> samples(nBlocks * blockSize);
+   for (size_t ii = 0; ii < samples.size(); ++ii)
+      samples[ii] = 0.5f * sin(ii * 0.01);
+   samples[blockSize + 100] = 0.9f;
+   sequence.Append(
+      (constSamplePtr)samples.data(), floatSample, samples.size());
+   UNIT_TEST_CHECK(sequence.GetBlockArray().size() == nBlocks);
+   CheckSummaries(sequence);
+
+   // Remove the peak from the second block, which stays long enough to be
+   // replaced in place
+   sequence.Delete(blockSize + 50, blockSize / 4);
+   UNIT_TEST_CHECK(sequence.GetBlockArray().size() == nBlocks);
+   CheckSummaries(sequence);
+
+   // Add a trough to it, which now fits in it
+   Sequence trough{ pFactory, floatSample };
+   const std::vector<float> troughSamples(100, -0.95f);
+   trough.Append((constSamplePtr)troughSamples.data(), floatSample,
+      troughSamples.size());
+   sequence.Paste(blockSize + 10, &trough);
+   UNIT_TEST_CHECK(sequence.GetBlockArray().size() == nBlocks);
+   CheckSummaries(sequence);
+}
+
+UnitTests::Registration editInPlace{ "sequence.summaries", EditInPlace };
+
+}
@@ -0,0 +1,211 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  UndoSharingTests.cpp
+
+*******************************************************************//**
+
+\file UndoSharingTests.cpp
+\brief Clips shared between undo states, and with the project after undo
+  and redo, and the space usage of states that share them
+
+*//*******************************************************************/
+
+#include "UnitTests.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Tenacity libraries
+#include <lib-project/Project.h>
+#include <lib-strings/Internat.h>
+#include <lib-track/Track.h>
+
+#include "HeadlessProject.h"
+#include "ProjectHistory.h"
+#include "SampleBlock.h"
+#include "UndoManager.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+
+namespace {
+
+using Clips = std::vector<const WaveClip *>;
+
+Clips GetClips(const TrackList &tracks)
+{
+   Clips clips;
+   for (auto pTrack : tracks.Any<const WaveTrack>())
+      for (const auto &pClip : pTrack->GetClips())
+         clips.push_back(pClip.get());
+   return clips;
+}
+
+Clips GetStateClips(TenacityProject &project, size_t n)
+{
+   Clips clips;
+   UndoManager::Get(project).VisitStates([&](const UndoStackElem &elem){
+      clips = GetClips(*elem.state.tracks);
+   }, n, n + 1);
+   return clips;
+}
+
+bool SameContents(const Clips &clips, const Clips &otherClips)
+{
+   return std::equal(clips.begin(), clips.end(),
+      otherClips.begin(), otherClips.end(),
+      [](const WaveClip *a, const WaveClip *b){
+         return a->HasSameContents(*b); });
+}
+
+//! The project must own its clips alone, because it modifies them
+void CheckNotShared(TenacityProject &project)
+{
+   const auto nStates = UndoManager::Get(project).GetNumStates();
+   for (auto pClip : GetClips(TrackList::Get(project)))
+      for (size_t n = 0; n < nStates; ++n) {
+         const auto stateClips = GetStateClips(project, n);
+         UNIT_TEST_CHECK(std::find(stateClips.begin(), stateClips.end(),
+            pClip) == stateClips.end());
+      }
+}
+
+//! Add a track with clips at 0 and 2 seconds
+WaveTrack &AddTrack(TenacityProject &project)
+{
+   const auto track =
+      WaveTrackFactory::Get(project).NewWaveTrack(floatSample, 44100);
+   const std::vector<float> samples(44100, 0.5f);
+   for (auto pClip : { track->CreateClip(0.0), track->CreateClip(2.0) }) {
+      pClip->Append(
+         (constSamplePtr)samples.data(), floatSample, samples.size(), 1);
+      pClip->Flush();
+   }
+   return *TrackList::Get(project).Add(track);
+}
+
+void UndoRedo()
+{
+   HeadlessProject headless;
+   auto &project = headless.Project();
+   auto &history = ProjectHistory::Get(project);
+   auto &undoManager = UndoManager::Get(project);
+   const auto pop = [&](const UndoStackElem &elem){
+      history.PopState(elem.state);
+   };
+
+   auto track = &AddTrack(project);
+   history.InitialState();
+   const auto state0 = GetStateClips(project, 0);
+   UNIT_TEST_CHECK(state0.size() == 2);
+   CheckNotShared(project);
+
+   // Only the second clip changes
+   track->Silence(2.25, 2.5);
+   history.PushState(XO("Silence"), XO("Silence"));
+   const auto state1 = GetStateClips(project, 1);
+   UNIT_TEST_CHECK(state1.size() == 2);
+   UNIT_TEST_CHECK(state1[0] == state0[0]);
+   UNIT_TEST_CHECK(state1[1] != state0[1]);
+   UNIT_TEST_CHECK(!state1[1]->HasSameContents(*state0[1]));
+   CheckNotShared(project);
+
+   // Undo restores the second clip, and keeps the project's first clip
+   const auto edited = GetClips(TrackList::Get(project));
+   undoManager.Undo(pop);
+   auto restored = GetClips(TrackList::Get(project));
+   UNIT_TEST_CHECK(SameContents(restored, state0));
+   UNIT_TEST_CHECK(restored[0] == edited[0]);
+   UNIT_TEST_CHECK(restored[1] != edited[1]);
+   CheckNotShared(project);
+
+   undoManager.Redo(pop);
+   restored = GetClips(TrackList::Get(project));
+   UNIT_TEST_CHECK(SameContents(restored, state1));
+   UNIT_TEST_CHECK(restored[0] == edited[0]);
+   CheckNotShared(project);
+
+   // Nothing changed, so the replaced state gives up no clips
+   history.ModifyState(false);
+   UNIT_TEST_CHECK(GetStateClips(project, 1) == state1);
+   UNIT_TEST_CHECK(GetStateClips(project, 0) == state0);
+   CheckNotShared(project);
+}
+
+//! Compare the space usage that UndoManager keeps with a fresh count, in
+//! which each block counts in the last state containing it
+void CheckSpaceUsage(TenacityProject &project)
+{
+   auto &undoManager = UndoManager::Get(project);
+   std::unordered_map<SampleBlockID, std::pair<size_t, wxLongLong_t>> last;
+   size_t nStates = 0;
+   undoManager.VisitStates([&](const UndoStackElem &elem){
+      InspectBlocks(*elem.state.tracks, [&](const SampleBlock &block){
+         last[block.GetBlockID()] = { nStates, block.GetSpaceUsage() };
+      });
+      ++nStates;
+   }, false);
+   std::vector<wxLongLong_t> expected(nStates);
+   for (const auto &[id, usage] : last)
+      expected[usage.first] += usage.second;
+
+   wxLongLong_t total = 0;
+   for (size_t n = 0; n < nStates; ++n) {
+      TranslatableString desc, size;
+      UNIT_TEST_CHECK(
+         undoManager.GetLongDescription(n, &desc, &size) == expected[n]);
+      total += expected[n];
+   }
+   UNIT_TEST_CHECK(undoManager.GetTotalSpaceUsage() == total);
+}
+
+void SpaceUsage()
+{
+   HeadlessProject headless;
+   auto &project = headless.Project();
+   auto &history = ProjectHistory::Get(project);
+   auto &undoManager = UndoManager::Get(project);
+   const auto pop = [&](const UndoStackElem &elem){
+      history.PopState(elem.state);
+   };
+
+   auto track = &AddTrack(project);
+   history.InitialState();
+   CheckSpaceUsage(project);
+
+   track->Silence(2.25, 2.5);
+   history.PushState(XO("Silence"), XO("Silence"));
+   CheckSpaceUsage(project);
+
+   // Now both clips contain some of the same blocks
+   const auto copy = track->Copy(0.0, 0.5);
+   track->Paste(2.5, copy.get());
+   history.PushState(XO("Paste"), XO("Paste"));
+   CheckSpaceUsage(project);
+
+   // Modify a state with another above it
+   undoManager.Undo(pop);
+   track = *TrackList::Get(project).Any<WaveTrack>().begin();
+   track->Silence(0.25, 0.5);
+   history.ModifyState(false);
+   CheckSpaceUsage(project);
+
+   // Abandon the state above it
+   track->Silence(2.75, 3.0);
+   history.PushState(XO("Silence"), XO("Silence"));
+   CheckSpaceUsage(project);
+
+   // Modify the first state, whose clips the next one shares
+   undoManager.Undo(pop);
+   undoManager.Undo(pop);
+   history.ModifyState(false);
+   CheckSpaceUsage(project);
+}
+
+UnitTests::Registration undoRedo{ "undo.sharing", UndoRedo };
+UnitTests::Registration spaceUsage{ "undo.space", SpaceUsage };
+
+}
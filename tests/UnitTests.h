@@ -0,0 +1,49 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  UnitTests.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_UNIT_TESTS__
+#define __AUDACITY_UNIT_TESTS__
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+//! Checks of behavior that needs projects, but no user interface
+/*!
+ Each test is a function that makes what projects it needs, as
+ HeadlessProject, and fails by throwing.  They run in the tenacity-tests
+ program, after a HeadlessEnvironment is prepared.
+ */
+namespace UnitTests {
+
+using Function = std::function<void()>;
+
+//! Statically constructed instances add tests to the program
+struct Registration {
+   Registration(const std::string &name, const Function &function);
+};
+
+//! Thrown by Check()
+struct Failure : std::runtime_error {
+   using std::runtime_error::runtime_error;
+};
+
+//! @throws Failure naming the expression and where it is, if it is false
+void Check(bool condition, const char *expression, const char *file, int line);
+
+//! Run the tests whose names begin with the filter, in the order of
+//! registration, reporting each on standard output
+/*! @return whether all passed; false too if none matched */
+bool Run(const std::string &filter);
+
+}
+
+#define UNIT_TEST_CHECK(expression) \
+   UnitTests::Check(bool(expression), #expression, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,99 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  UnitTestsMain.cpp
+
+*******************************************************************//**
+
+\file UnitTestsMain.cpp
+\brief The tenacity-tests program
+
+  Usage:  tenacity-tests [--filter PREFIX]
+
+  Runs the tests whose names begin with PREFIX, or all of them.  The exit
+  status is nonzero if a test failed.
+
+*//*******************************************************************/
+
+#include "UnitTests.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "HeadlessProject.h"
+
+namespace UnitTests {
+
+namespace {
+std::vector<std::pair<std::string, Function>> &Registry()
+{
+   static std::vector<std::pair<std::string, Function>> registry;
+   return registry;
+}
+}
+
+Registration::Registration(const std::string &name, const Function &function)
+{
+   Registry().emplace_back(name, function);
+}
+
+void Check(bool condition, const char *expression, const char *file, int line)
+{
+   if (!condition)
+      throw Failure{ std::string{ file } + ":" + std::to_string(line) +
+         ": check failed: " + expression };
+}
+
+bool Run(const std::string &filter)
+{
+   bool passed = true;
+   size_t count = 0;
+   for (const auto &[name, function] : Registry()) {
+      if (name.compare(0, filter.size(), filter) != 0)
+         continue;
+      ++count;
+      try {
+         function();
+         printf("PASS %s\n", name.c_str());
+      }
+      catch (const std::exception &e) {
+         printf("FAIL %s: %s\n", name.c_str(), e.what());
+         passed = false;
+      }
+      catch ( ... ) {
+         printf("FAIL %s: unknown exception\n", name.c_str());
+         passed = false;
+      }
+   }
+   if (count == 0)
+      printf("No tests match \"%s\"\n", filter.c_str());
+   return passed && count > 0;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+   std::string filter;
+   for (int ii = 1; ii < argc; ++ii) {
+      if (strcmp(argv[ii], "--filter") == 0 && ii + 1 < argc)
+         filter = argv[++ii];
+      else {
+         fprintf(stderr, "Usage: %s [--filter PREFIX]\n", argv[0]);
+         return 2;
+      }
+   }
+
+   HeadlessEnvironment environment{ wxT("tenacity-tests") };
+   if (!environment.IsOk()) {
+      fprintf(stderr, "Could not prepare %s\n",
+         environment.GetDirectory().utf8_str().data());
+      return 1;
+   }
+
+   return UnitTests::Run(filter) ? 0 : 1;
+}